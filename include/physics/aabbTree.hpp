@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+// Axis-aligned bounding box in world coordinates.
+struct AABB
+{
+    float min_x = 0.0f;
+    float min_y = 0.0f;
+    float max_x = 0.0f;
+    float max_y = 0.0f;
+};
+
+inline bool aabb_overlap(const AABB &a, const AABB &b)
+{
+    return a.min_x <= b.max_x && b.min_x <= a.max_x && a.min_y <= b.max_y && b.min_y <= a.max_y;
+}
+
+inline bool aabb_contains(const AABB &outer, const AABB &inner)
+{
+    return outer.min_x <= inner.min_x && outer.min_y <= inner.min_y && inner.max_x <= outer.max_x && inner.max_y <= outer.max_y;
+}
+
+inline AABB aabb_union(const AABB &a, const AABB &b)
+{
+    AABB out;
+    out.min_x = std::min(a.min_x, b.min_x);
+    out.min_y = std::min(a.min_y, b.min_y);
+    out.max_x = std::max(a.max_x, b.max_x);
+    out.max_y = std::max(a.max_y, b.max_y);
+    return out;
+}
+
+// Perimeter is the 2D surface-area heuristic used to pick insertion siblings.
+inline float aabb_perimeter(const AABB &a)
+{
+    return 2.0f * ((a.max_x - a.min_x) + (a.max_y - a.min_y));
+}
+
+// ====================================================================
+// --- DYNAMIC AABB TREE (BVH) ---
+// Incrementally updated bounding volume hierarchy. Leaves store "fat"
+// AABBs (tight box + margin + predicted displacement) so small motions
+// do not touch the tree. Insertion picks siblings by perimeter cost and
+// AVL-style rotations keep the tree balanced.
+// Nodes live in one flat array with a free list (no per-node allocation).
+// ====================================================================
+
+class aabbTree
+{
+public:
+    static const int NULL_NODE = -1;
+
+    aabbTree();
+
+    // Inserts a leaf for `tight` fattened by `margin`; returns the proxy id.
+    int create_proxy(const AABB &tight, int user_data, float margin);
+    void destroy_proxy(int proxy);
+
+    // Refits the proxy after its body moved by (displacement_x, displacement_y).
+    // Returns true when the leaf had to be reinserted.
+    bool move_proxy(int proxy, const AABB &tight, float margin, float displacement_x, float displacement_y);
+
+    const AABB &get_fat_aabb(int proxy) const { return nodes[proxy].box; }
+    int get_user_data(int proxy) const { return nodes[proxy].user_data; }
+    int get_height() const { return (root == NULL_NODE) ? 0 : nodes[root].height; }
+    int get_proxy_count() const { return proxy_count; }
+
+    void clear();
+
+    // Calls callback(user_data) for every leaf whose fat AABB overlaps `box`.
+    template <typename Callback>
+    void query(const AABB &box, Callback &&callback) const
+    {
+        if (root == NULL_NODE)
+            return;
+        query_stack.clear();
+        query_stack.push_back(root);
+        while (!query_stack.empty())
+        {
+            int node_id = query_stack.back();
+            query_stack.pop_back();
+            const Node &node = nodes[node_id];
+            if (!aabb_overlap(node.box, box))
+                continue;
+            if (node.is_leaf())
+            {
+                callback(node.user_data);
+            }
+            else
+            {
+                query_stack.push_back(node.child1);
+                query_stack.push_back(node.child2);
+            }
+        }
+    }
+
+private:
+    struct Node
+    {
+        AABB box;
+        int parent = NULL_NODE; // next free node while on the free list
+        int child1 = NULL_NODE;
+        int child2 = NULL_NODE;
+        int height = 0; // leaf = 0, free node = -1
+        int user_data = -1;
+
+        bool is_leaf() const { return child1 == NULL_NODE; }
+    };
+
+    std::vector<Node> nodes;
+    int root = NULL_NODE;
+    int free_list = NULL_NODE;
+    int proxy_count = 0;
+
+    // Reused traversal stack so queries do not allocate every frame.
+    mutable std::vector<int> query_stack;
+
+    int allocate_node();
+    void free_node(int node_id);
+
+    void insert_leaf(int leaf);
+    void remove_leaf(int leaf);
+
+    // Rotates the subtree rooted at node_id if it is unbalanced; returns the new subtree root.
+    int balance(int node_id);
+};
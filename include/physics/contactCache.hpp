@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// ====================================================================
+// --- PERSISTENT CONTACT CACHE ---
+// Flat open-addressing table (linear probing) keyed by body pair that
+// survives between frames. Each entry keeps the accumulated normal
+// impulse of its contact so the solver can warm start from it.
+// Entries are stamped with the frame generation when touched; anything
+// not touched during the previous frame is stale and reads as empty.
+// Stale slots are only reclaimed by an occasional rehash, so eviction
+// costs nothing per frame.
+// ====================================================================
+
+class contactCache
+{
+public:
+    struct Contact
+    {
+        float normal_impulse = 0.0f;    // accumulated, always >= 0
+        float resting_impulse = 0.0f;   // part of it without restitution, used to warm start
+        float target_velocity = 0.0f;   // separation speed aimed for (restitution bounce, 0 when resting)
+        float normal_x = 0.0f;          // contact normal (A to B) the impulse was solved for
+        float normal_y = 0.0f;
+        bool solved = false;            // visited by the narrow phase this frame
+    };
+
+    contactCache();
+
+    // Starts a new frame; rehashes when live + stale slots fill the table.
+    void begin_frame();
+
+    // Contact stored for (idxA, idxB) during the current frame, nullptr when
+    // none. The pair is unordered.
+    const Contact *find(int idxA, int idxB) const;
+    // Same lookup for contacts stored during the previous frame.
+    const Contact *find_previous(int idxA, int idxB) const;
+
+    // Stores the contact for (idxA, idxB) and marks it live.
+    // Updating an existing entry never reallocates the table.
+    void store(int idxA, int idxB, const Contact &contact);
+
+    // Calls callback(idxA, idxB, contact) for every contact stored during the
+    // previous frame (idxA < idxB).
+    template <typename Callback>
+    void for_each_previous(Callback &&callback) const
+    {
+        for (const Slot &slot : slots)
+        {
+            if (slot.stamp != 0 && slot.stamp + 1 == generation)
+                callback((int)(slot.key & 0xffffffffULL), (int)(slot.key >> 32), slot.contact);
+        }
+    }
+
+    // Drops every entry (body indices changed meaning).
+    void clear();
+
+    // Entries touched during the current or previous frame.
+    size_t live_count() const;
+    size_t capacity() const { return slots.size(); }
+
+private:
+    struct Slot
+    {
+        uint64_t key = 0;
+        Contact contact;
+        unsigned int stamp = 0; // generation of the last touch, 0 = never used
+    };
+
+    std::vector<Slot> slots;
+    uint64_t slot_mask = 0;
+    size_t used_slots = 0; // live + stale
+    unsigned int generation = 1;
+
+    bool is_live(const Slot &slot) const { return slot.stamp != 0 && slot.stamp + 1 >= generation; }
+    void rehash(size_t new_capacity);
+    // Slot holding key, or the free slot ending its probe chain
+    uint64_t probe(uint64_t key) const;
+
+    static uint64_t pack_key(int idxA, int idxB);
+    static uint64_t hash_key(uint64_t key);
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+struct world;
+class contactCache;
+class threadPool;
+
+// ====================================================================
+// --- CONTACT BUFFER ---
+// Compact SoA list of the contacts found by the narrow phase in one
+// frame. Contact k joins body_a[k] and body_b[k]; the normal points
+// from A to B.
+// ====================================================================
+
+struct ContactBuffer
+{
+    std::vector<int> body_a;
+    std::vector<int> body_b;
+    std::vector<float> normal_x;
+    std::vector<float> normal_y;
+    std::vector<float> penetration;     // overlap when the contact was collected
+    std::vector<float> normal_mass;     // 1 / (inv_mass_a + inv_mass_b)
+    std::vector<float> restitution;     // average of both bodies
+    std::vector<float> target_velocity; // separation speed aimed for (restitution bounce)
+    std::vector<float> normal_impulse;  // accumulated over the iterations, always >= 0
+
+    size_t size() const { return body_a.size(); }
+    void clear();
+    void add(int idxA, int idxB, float nx, float ny, float depth, float mass_n, float bounce);
+    // Reorders every column so that new contact k is old contact order[k]
+    void permute(const std::vector<int> &order);
+};
+
+// How the velocity and position sweeps visit the buffer.
+enum class ContactIteration
+{
+    SEQUENTIAL, // Gauss-Seidel in buffer order, one thread
+    COLORED,    // Gauss-Seidel per color batch, each batch split across the pool
+    JACOBI,     // Every contact reads the same state; per-body deltas applied after each sweep
+    ISLANDS     // Gauss-Seidel inside each contact island, one island per pool task
+};
+
+// ====================================================================
+// --- ITERATIVE CONTACT SOLVER (Sequential Impulses) ---
+// Contacts are collected first and then solved together. The integrator
+// has already taken this step, so the solver works on the step velocity
+// (position - previous_position) / dt of every body in contact:
+//  1. step velocities and restitution targets
+//  2. warm start from the persistent contact cache (optional)
+//  3. world::solver_settings.velocity_iterations Gauss-Seidel sweeps over
+//     the buffer, clamping each accumulated impulse to >= 0
+//  4. positions re-integrated from previous_position with the solved velocity
+//  5. position_iterations sweeps of split position correction
+//  6. previous positions re-derived from the velocities (Verlet)
+//
+// With a thread pool the buffer is first partitioned by greedy graph
+// coloring: no two contacts of one color share a dynamic body, so each
+// color batch of steps 3 and 5 runs in parallel without atomics. Colors
+// are solved in order, which keeps the result independent of the
+// thread count. Contacts that do not fit in MAX_COLORS colors go to a
+// final overflow batch that is solved serially.
+//
+// JACOBI sweeps are split in two passes with no shared writes: every
+// contact computes its impulse (or position correction) from the state
+// left by the previous sweep into a per-contact delta, then every body
+// gathers the deltas of its contacts in buffer order and applies them.
+// A contact's delta is scaled by 1 / (contacts on its busier body), which
+// averages the corrections a body receives while keeping the impulse
+// equal and opposite on both bodies. The gather order is fixed, so the
+// result is bitwise identical for any thread count.
+//
+// ISLANDS: add_contact joins the two bodies of every contact in a
+// union-find over body indices (static bodies are never joined, so they
+// do not merge the piles resting on them). At solve time the buffer is
+// sorted by island and each island runs its whole pipeline (velocity
+// sweeps, re-integration, position sweeps) as one task. Islands share no
+// dynamic body, so the result does not depend on the thread count.
+// ====================================================================
+
+class contactSolver
+{
+public:
+    contactSolver();
+
+    void clear();
+
+    // Narrow phase: appends (idxA, idxB) when the two circles overlap, or are
+    // closer than margin (penetration is then negative). Returns true when a
+    // contact was added.
+    bool add_contact(const world &simulation_world, int idxA, int idxB, float margin = 0.0f);
+
+    // Solves the collected contacts in place. With a cache, persistent contacts
+    // start from last frame's impulse and the results are stored back.
+    // COLORED and JACOBI run their sweeps on the pool when one is given.
+    void solve(world &simulation_world, contactCache *cache, ContactIteration iteration, threadPool *pool = nullptr);
+
+    const ContactBuffer &contacts() const { return buffer; }
+
+    // Coloring of the last COLORED solve: color c holds contacts
+    // color_offsets[c] .. color_offsets[c + 1]; the last one is the overflow
+    // batch when has_overflow_color() is true. Empty for the other modes.
+    int color_count() const { return color_offsets.empty() ? 0 : (int)color_offsets.size() - 1; }
+    int color_batch_size(int color) const { return color_offsets[color + 1] - color_offsets[color]; }
+    const std::vector<int> &get_color_offsets() const { return color_offsets; }
+    bool has_overflow_color() const { return overflow_color; }
+
+    // Colors tracked per body (one bit each); further contacts overflow
+    static const int MAX_COLORS = 64;
+
+    // Islands of the last ISLANDS solve: island i holds contacts
+    // island_offsets[i] .. island_offsets[i + 1], island_body_counts[i]
+    // dynamic bodies, and took island_solve_ns[i] to solve.
+    int island_count() const { return island_offsets.empty() ? 0 : (int)island_offsets.size() - 1; }
+    const std::vector<int> &get_island_offsets() const { return island_offsets; }
+    const std::vector<int> &get_island_body_counts() const { return island_body_counts; }
+    const std::vector<long long> &get_island_solve_ns() const { return island_solve_ns; }
+    // Root of the island of a body touched this frame (union-find), or the body itself.
+    int find_island_root(int body);
+    // Joins two dynamic bodies into one island without buffering a contact
+    // (the single-pass path, which resolves pairs as it finds them).
+    void link_bodies(const world &simulation_world, int idxA, int idxB);
+
+private:
+    ContactBuffer buffer;
+
+    // --- GRAPH COLORING STATE ---
+    std::vector<int> color_offsets;
+    bool overflow_color = false;
+    std::vector<uint64_t> body_color_masks; // colors already used by each body
+    std::vector<int> contact_colors;
+    std::vector<int> color_order;
+
+    // --- JACOBI STATE ---
+    // CSR body -> contacts: contacts of body i are
+    // body_contact_list[body_contact_offsets[i] .. body_contact_offsets[i + 1]).
+    std::vector<int> body_contact_offsets;
+    std::vector<int> body_contact_list;
+    std::vector<int> touched_bodies; // dynamic bodies with at least one contact, ascending
+    std::vector<float> contact_scale; // 1 / contacts on the busier body
+    std::vector<float> contact_delta_x; // per-sweep delta along the normal (applied +B / -A)
+    std::vector<float> contact_delta_y;
+
+    // --- ISLAND STATE ---
+    std::vector<int> island_parent;  // union-find over body indices, -1 = own root
+    std::vector<int> island_members; // bodies whose parent entry was touched this frame
+    std::vector<int> island_offsets;
+    std::vector<int> island_body_counts;
+    std::vector<long long> island_solve_ns;
+    std::vector<int> island_order;
+
+    void unite_bodies(int idxA, int idxB);
+    void build_islands(const world &simulation_world);
+    void solve_islands(world &simulation_world, threadPool *pool);
+
+    void color_contacts(const world &simulation_world);
+    void build_body_contacts(const world &simulation_world);
+    void solve_velocities_jacobi(world &simulation_world, threadPool *pool);
+    void solve_positions_jacobi(world &simulation_world, threadPool *pool);
+    // Gathers contact_delta_x/y into the given per-body columns, scaled by inv_mass.
+    void apply_jacobi_deltas(world &simulation_world, std::vector<float> &column_x, std::vector<float> &column_y, threadPool *pool);
+    void solve_velocity_contact(world &simulation_world, size_t k);
+    void solve_position_contact(world &simulation_world, size_t k);
+    // Runs solve_contact over every contact, color by color on the pool when one is given.
+    template <typename ContactKernel>
+    void sweep_contacts(threadPool *pool, ContactKernel &&solve_contact);
+
+    void prepare(world &simulation_world);
+    void warm_start(world &simulation_world, contactCache &cache);
+    void solve_velocities(world &simulation_world, threadPool *pool);
+    void integrate_positions(world &simulation_world, size_t begin, size_t end);
+    void solve_positions(world &simulation_world, threadPool *pool);
+    void sync_verlet_state(world &simulation_world);
+    void store_impulses(contactCache &cache) const;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// ====================================================================
+// --- HASHED SPATIAL GRID ---
+// Unbounded uniform grid: integer cell coordinates are hashed into an
+// open-addressing table (linear probing) that only stores occupied
+// cells. Memory scales with the number of bodies, not with the world
+// area, and any position maps to a cell.
+// Bodies are counting-sorted by cell like the flat world grid, so each
+// occupied cell is a contiguous range of sorted_bodies().
+// ====================================================================
+
+class hashGrid
+{
+public:
+    struct Cell
+    {
+        int32_t cx;
+        int32_t cy;
+        int begin; // range in sorted_bodies()
+        int end;
+    };
+
+    hashGrid();
+
+    // Rebuilds the table from n positions with square cells of cell_size.
+    void build(const float *position_x, const float *position_y, size_t n, float cell_size);
+
+    // Cell coordinate of a position, clamped to +-MAX_CELL_COORD (NaN maps to
+    // the lower limit) so far-away bodies never overflow the int conversion and
+    // neighbour offsets of a few cells stay in range.
+    static const int32_t MAX_CELL_COORD = 1 << 30;
+    static int32_t cell_coord(float position, float inv_cell_size);
+
+    // Index in cells() of the occupied cell (cx, cy), or -1 when empty.
+    int find_cell(int32_t cx, int32_t cy) const;
+
+    // Occupied cells in first-touched order (deterministic for a given input).
+    const std::vector<Cell> &cells() const { return occupied_cells; }
+    const std::vector<int> &sorted_bodies() const { return sorted; }
+
+    // Table slots currently allocated (power of two, at least 2x the body count).
+    size_t capacity() const { return slot_keys.size(); }
+
+private:
+    std::vector<uint64_t> slot_keys;
+    std::vector<int> slot_cells; // occupied cell index per slot, -1 when the slot is free
+    uint64_t slot_mask = 0;
+
+    std::vector<Cell> occupied_cells;
+    std::vector<int> body_cells; // occupied cell index per body
+    std::vector<int> sorted;
+
+    static uint64_t pack_key(int32_t cx, int32_t cy);
+    static uint64_t hash_key(uint64_t key);
+};
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include "math/vec2.hpp"
 #include "physics/body.hpp"
@@ -10,14 +12,40 @@ struct GridInfo
     float min_y = -100.0f;
 
     const float cell_size = 5.0f;
+    // false: no floor, walls or ceiling; bodies may leave the box and every
+    // broad phase still pairs them (UNIFORM_GRID switches to the hashed grid)
+    bool bounded = true;
 
     int num_cells_x = 0;
     int num_cells_y = 0;
 };
+// Contact solver tuning, per world.
+struct SolverSettings
+{
+    int velocity_iterations = 8;              // impulse sweeps (ContactSolverType::SEQUENTIAL_IMPULSE)
+    int position_iterations = 3;              // position correction sweeps (SEQUENTIAL_IMPULSE)
+    float position_correction_percent = 0.2f; // share of the penetration removed per correction
+    float position_correction_slop = 0.001f;  // penetration left uncorrected (avoids jitter)
+    int xpbd_iterations = 4;                  // constraint sweeps (ContactSolverType::XPBD)
+    float contact_compliance = 0.0f;          // XPBD inverse contact stiffness (m/N), 0 = rigid
+    float xpbd_contact_margin = 0.1f;         // XPBD: pairs this close are constrained even if not touching yet
+    float bounce_threshold = 1.0f;            // warm-started contacts approaching faster than this (units/s) still bounce
+};
+// Body sleeping, per world. A body whose speed stays below linear_threshold
+// accumulates rest time; an island (bodies linked by contacts) falls asleep
+// once every member has rested time_to_sleep seconds.
+struct SleepSettings
+{
+    bool enabled = false;
+    float linear_threshold = 0.1f; // world units per second
+    float time_to_sleep = 0.5f;    // seconds
+};
 struct world
 {
 
     GridInfo grid_info;
+    SolverSettings solver_settings;
+    SleepSettings sleep_settings;
     std::vector<float> position_x;
     std::vector<float> position_y;
     std::vector<float> previous_position_x;
@@ -33,14 +61,54 @@ struct world
     unsigned long long broad_phase_us = 0;
     unsigned long long narrow_phase_us = 0;
     unsigned long long resolve_phase_us = 0;
+    // Verlet neighbour list rebuilds (per-frame counter, reset with the timers)
+    unsigned long long neighbour_list_rebuilds = 0;
+    // Graph-colored contact solver: contacts, colors and largest color batch of the frame
+    unsigned long long solver_contacts = 0;
+    unsigned long long contact_colors = 0;
+    unsigned long long largest_color_batch = 0;
+    // Island contact solver: islands of the frame, summed and slowest per-island
+    // solve time (microseconds), and island sizes by dynamic body count:
+    // island_size_histogram[b] counts islands of 2^b .. 2^(b+1) - 1 bodies
+    unsigned long long island_count = 0;
+    unsigned long long island_solve_us = 0;
+    unsigned long long largest_island_us = 0;
+    std::vector<unsigned long long> island_size_histogram;
+    // Substeps run by systemManager (per-frame counter)
+    unsigned long long substeps = 0;
+    // Continuous collision: bodies swept, bodies pulled back to an impact and
+    // time spent in the swept pass (microseconds), per-frame counters
+    unsigned long long ccd_bodies = 0;
+    unsigned long long ccd_impacts = 0;
+    unsigned long long ccd_us = 0;
+    // Bodies asleep after the last collision step (a snapshot, not accumulated)
+    unsigned long long sleeping_bodies = 0;
+
+    // Bumped whenever body indices change meaning (add, remove, permute).
+    // Systems that cache per-body data compare it and rebuild when it changes.
+    unsigned int body_layout_version = 0;
+
+    // Bodies [0, dynamic_count) are dynamic (inv_mass > 0), the static ones
+    // follow. add_body, remove_body, permute_bodies and set_mass keep the
+    // partition, so loops that only move bodies run over [0, dynamic_count)
+    // without testing inv_mass. Code that writes inv_mass directly calls
+    // partition_bodies() afterwards.
+    size_t dynamic_count = 0;
+    // Bumped whenever a static body is added, removed, moved or changes index.
+    // Caches of the static geometry (the static grid) rebuild when it changes.
+    unsigned int static_layout_version = 0;
 
     // The world is SoA-first and exposes SoA accessors for direct usage.
 
+    // Flat uniform grid of the dynamic bodies (counting sort, rebuilt every frame by
+    // collisionSystem, which keeps the static bodies in a cached grid of its own):
+    //  - particle_cell_id[i]: cell of dynamic body i, or -1 when it lies outside the grid bounds
+    //  - particle_start_indices[c] .. particle_start_indices[c + 1]: range of cell c in sorted_indices
+    //    (num_cells + 1 entries, the last one holds the number of binned bodies)
+    //  - sorted_indices: body indices grouped by cell, ascending inside each cell
     std::vector<int> particle_cell_id;
     std::vector<int> particle_start_indices;
     std::vector<int> sorted_indices;
-    // Grid: each cell holds a list of particle indices
-    std::vector<std::vector<int>> grid;
     std::vector<float> vel_x;
     std::vector<float> vel_y;
     std::vector<float> acc_x;
@@ -51,13 +119,39 @@ struct world
     std::vector<float> damping;
     std::vector<float> friction;
     std::vector<float> restitution;
+    // Sleeping bodies are skipped by integration, boundaries and pair tests
+    // until a contact or the API wakes them (SleepSettings)
+    std::vector<uint8_t> sleeping;
+    std::vector<float> sleep_timer; // seconds spent below the sleep threshold
+    std::vector<int> sleep_island;  // label shared by the bodies that fell asleep together
 
     // Helpers
     size_t size() const { return position_x.size(); }
-    void add_body(const body &b);
+    size_t static_count() const { return size() - dynamic_count; }
+    bool is_static(size_t idx) const { return idx >= dynamic_count; }
+    // Returns the index the body was stored at: a dynamic body goes at the end
+    // of the dynamic range and the first static body moves to the end.
+    size_t add_body(const body &b);
     void remove_body(size_t idx);
+    void clear_bodies();
+    // Reorders every per-body column so that new index k holds old body new_order[k].
+    // Dynamic bodies stay first: the order is applied to each range separately
+    // (stable), so new index k holds new_order[k] only when new_order already
+    // lists the dynamic bodies first.
+    // Returns the inverse mapping (old index -> new index) to remap external indices.
+    std::vector<int> permute_bodies(const std::vector<int> &new_order);
+    // Sets mass and inv_mass (0 for mass <= 0: static) and moves the body to the
+    // other range when it changes kind. Returns its new index.
+    size_t set_mass(size_t idx, float new_mass);
+    // Restores the partition after inv_mass was written directly (stable).
+    // Returns the inverse mapping (old index -> new index).
+    std::vector<int> partition_bodies();
     vec2 get_position(size_t idx) const;
+    // Also wakes the body
     void set_position(size_t idx, const vec2 &p);
+    bool is_sleeping(size_t idx) const { return idx < sleeping.size() && sleeping[idx]; }
+    // Wakes the body and the island it fell asleep with
+    void wake_body(size_t idx);
     // Legacy conversion helpers removed: world is pure SoA now.
     // Provide SoA accessors for efficient upload to GPU or direct processing.
     const float *positions_x() const { return position_x.data(); }
@@ -99,4 +193,11 @@ struct world
         std::vector<float> &&radius_in);
 
     int get_grid_index(const vec2 &position) const;
+    int num_grid_cells() const { return grid_info.num_cells_x * grid_info.num_cells_y; }
+    // Recompute num_cells_x/num_cells_y from the grid bounds and size the cell range table.
+    // Call it again after changing grid_info bounds.
+    void update_grid_dimensions();
+    // Changes delta_time and rescales previous positions so the implicit
+    // Verlet velocity (position - previous_position) / delta_time is unchanged.
+    void set_time_step(float new_delta_time);
 };
\ No newline at end of file
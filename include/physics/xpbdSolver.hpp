@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+struct world;
+struct ContactBuffer;
+
+// ====================================================================
+// --- XPBD SOLVER (Extended Position-Based Dynamics) ---
+// The Verlet integrator already produced the predicted positions and
+// kept the start-of-step positions in previous_position_x/y. The solver:
+//  1. records the predicted velocity (position - previous_position) / dt
+//  2. xpbd_iterations Gauss-Seidel sweeps over the contact constraints
+//     C = |xb - xa| - (ra + rb) >= 0 with compliance
+//     world::solver_settings.contact_compliance, each sweep followed by a
+//     projection onto the floor (y = 0), the side walls and the ceiling
+//  3. derives velocities from the corrected positions
+//  4. applies restitution along the normal of every contact and wall
+//     that was active, then re-derives previous positions
+// Nothing is injected as velocity while solving, so stiff piles do not
+// gain energy however large the step is.
+// ====================================================================
+
+class xpbdSolver
+{
+public:
+    xpbdSolver();
+
+    // Solves the contacts collected by the narrow phase and, when `bounded`,
+    // the world boundaries. Contacts are only read: multipliers are kept here.
+    void solve(world &simulation_world, const ContactBuffer &contacts, bool bounded = true);
+
+private:
+    std::vector<float> lambda;                  // accumulated multiplier per contact (>= 0)
+    std::vector<float> contact_normal_velocity; // approach speed before solving, per contact
+    std::vector<float> predicted_vel_x;         // per body, before solving
+    std::vector<float> predicted_vel_y;
+    std::vector<uint8_t> boundary_hits; // per body, WALL_* bits of the walls that pushed it
+
+    void record_predicted_velocities(world &simulation_world, const ContactBuffer &contacts);
+    void solve_contact_constraints(world &simulation_world, const ContactBuffer &contacts);
+    void project_boundaries(world &simulation_world);
+    void derive_velocities(world &simulation_world, const ContactBuffer &contacts);
+};
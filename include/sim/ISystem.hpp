@@ -1,9 +1,49 @@
 class world;
+class threadPool;
 #pragma once
 
+#include <cstdint>
+
+// When systemManager runs a system inside a substepped frame.
+enum class SystemSchedule
+{
+    EVERY_SUBSTEP, // Runs on every substep with world::delta_time = frame dt / K
+    ONCE_PER_FRAME // Runs once, during the last substep (analytics, reordering, ...)
+};
+
+// Groups of world columns a system reads or writes, as bits of a ColumnSet.
+// systemManager runs two systems concurrently only when neither writes a
+// group the other one reads or writes.
+using ColumnSet = uint32_t;
+const ColumnSet COLUMN_POSITION = 1u << 0;          // position_x / position_y
+const ColumnSet COLUMN_PREVIOUS_POSITION = 1u << 1; // previous_position_x / previous_position_y
+const ColumnSet COLUMN_VELOCITY = 1u << 2;          // vel_x / vel_y
+const ColumnSet COLUMN_ACCELERATION = 1u << 3;      // acc_x / acc_y
+const ColumnSet COLUMN_MASS = 1u << 4;              // mass, inv_mass
+const ColumnSet COLUMN_RADIUS = 1u << 5;            // radius
+const ColumnSet COLUMN_MATERIAL = 1u << 6;          // damping, friction, restitution
+const ColumnSet COLUMN_SLEEP = 1u << 7;             // sleeping, sleep_timer, sleep_island
+const ColumnSet COLUMN_GRID = 1u << 8;              // particle_cell_id, particle_start_indices, sorted_indices
+const ColumnSet COLUMN_STATS = 1u << 9;             // per-frame counters and timers
+// Body count and order (add, remove, permute): every per-body column moves,
+// so writing it conflicts with every other system
+const ColumnSet COLUMN_LAYOUT = 1u << 10;
+// World settings: gravity, delta_time, damping, grid bounds, solver and sleep settings
+const ColumnSet COLUMN_SETTINGS = 1u << 11;
+const ColumnSet COLUMNS_NONE = 0u;
+const ColumnSet COLUMNS_ALL = ~0u;
+
 class ISystem
 {
 public:
     virtual void update(world &, float dt) = 0;
+    virtual SystemSchedule schedule() const { return SystemSchedule::EVERY_SUBSTEP; }
+    // Columns update() reads and writes. The defaults claim the whole world,
+    // so a system that does not declare its sets never runs alongside another.
+    virtual ColumnSet reads() const { return COLUMNS_ALL; }
+    virtual ColumnSet writes() const { return COLUMNS_ALL; }
+    // Worker pool shared by the systems of a systemManager (nullptr: run on
+    // the calling thread). Systems that do not parallelise ignore it.
+    virtual void set_thread_pool(threadPool *) {}
     virtual ~ISystem() = default;
-};
\ No newline at end of file
+};
@@ -2,43 +2,258 @@
 
 #include <vector>
 #include <utility>
+#include <cstdint>
+#include <memory>
 #include "sim/ISystem.hpp"
 #include "math/vec2.hpp"
+#include "physics/aabbTree.hpp"
+#include "physics/hashGrid.hpp"
+#include "physics/contactCache.hpp"
+#include "physics/contactSolver.hpp"
+#include "physics/xpbdSolver.hpp"
 
 class body;
 class world;
+class threadPool;
 
-// ====================================================================
-// --- COLLISION DATA STRUCTURES ---
-// The ContactManifold structure stores all key collision information
-// so that resolve_collision can be cleaner.
-// ====================================================================
+// How candidate pairs travel from the broad phase to the narrow phase.
+enum class PairGenerationMode
+{
+    MATERIALIZED, // Two-pass: broad phase fills a pair vector, narrow phase iterates it
+    STREAMING     // Fused: pairs are tested and resolved in small batches while walking the grid
+};
+
+// Which spatial structure produces candidate pairs.
+enum class BroadPhaseType
+{
+    UNIFORM_GRID,   // Flat counting-sort grid defined by world::grid_info
+    SWEEP_AND_PRUNE, // Bodies kept sorted along the axis of greatest variance
+    AABB_TREE,        // Dynamic BVH with fat AABBs; handles any mix of radii
+    HIERARCHICAL_GRID, // Power-of-two grid levels keyed by body radius
+    HASHED_GRID        // Unbounded grid in an open-addressing hash table
+};
 
-struct ContactManifold
+// How overlapping pairs are resolved.
+enum class ContactSolverType
 {
-    body *body_A;                // Pointer to the first body involved
-    body *body_B;                // Pointer to the second body involved
-    vec2 normal_direction;       // Unit vector of the collision (direction from A to B)
-    float penetration_depth;     // Magnitude of the overlap between bodies
-    float effective_restitution; // Average coefficient of restitution
-    float inverse_mass_sum;      // Sum of inverse masses (1/mA + 1/mB)
+    SINGLE_PASS,       // Each pair resolved once, as soon as the narrow phase finds it
+    SEQUENTIAL_IMPULSE, // Contacts collected into a buffer, then iterated (world::solver_settings)
+    GRAPH_COLORED,      // Sequential impulses on color batches that share no body, solved in parallel
+    JACOBI,             // Every contact reads the previous sweep; per-body deltas gathered in parallel
+    ISLANDS,            // Contacts split into islands (union-find); each island solved as one pool task
+    XPBD                // Position constraints with compliance (contacts and boundaries), velocities derived
 };
 
 class collisionSystem : public ISystem
 {
 private:
+    // Candidates buffered per flush in STREAMING mode (stack-allocated)
+    static const int PAIR_BATCH_SIZE = 256;
+
+    PairGenerationMode pair_mode = PairGenerationMode::MATERIALIZED;
+    BroadPhaseType broad_phase = BroadPhaseType::UNIFORM_GRID;
+    ContactSolverType contact_solver_type = ContactSolverType::SINGLE_PASS;
+    contactSolver contact_solver;
+    xpbdSolver xpbd_solver;
+    int solver_threads = 0;              // 0 = the systemManager's pool (or serial)
+    threadPool *shared_pool = nullptr;   // pool of the systemManager running this system
+    std::unique_ptr<threadPool> solver_pool; // own pool, only after set_solver_threads(> 0)
+    // Pool used by the parallel phases (grid build, boundaries, parallel solvers);
+    // nullptr runs them on the calling thread
+    threadPool *worker_pool();
+
+    // --- SWEEP AND PRUNE STATE (persists between frames) ---
+    // One interval per body on the sweep axis plus its extent on the other axis.
+    struct SapEntry
+    {
+        float min;
+        float max;
+        float other_min;
+        float other_max;
+        int body;
+    };
+    std::vector<SapEntry> sap_entries; // sorted by min on sap_axis
+    int sap_axis = 0;                  // 0 = x, 1 = y
+
+    // --- AABB TREE STATE (persists between frames) ---
+    aabbTree tree;
+    std::vector<int> tree_proxies; // proxy id per body
+
+    // --- HIERARCHICAL GRID STATE (rebuilt every frame) ---
+    // Level L has cells of hgrid_base_cell_size * 2^L; a body lives on the finest
+    // level whose cells are at least as wide as its diameter.
+    static const int HGRID_MAX_LEVELS = 16;
+    struct HGridEntry
+    {
+        uint64_t key; // level | cell y | cell x
+        int body;
+    };
+    struct HGridCell
+    {
+        uint64_t key;
+        int begin; // range in hgrid_entries
+        int end;
+    };
+    std::vector<HGridEntry> hgrid_entries; // sorted by (key, body)
+    std::vector<HGridCell> hgrid_cells;    // one per occupied cell, sorted by key
+    float hgrid_base_cell_size = 1.0f;
+    uint32_t hgrid_occupied_levels = 0; // bit L set when level L has bodies
+
+    // --- HASHED GRID STATE (rebuilt every frame) ---
+    hashGrid hash_grid;
+
+    // Per-body inflation applied by the broad phases while building neighbour lists
+    float broad_phase_margin = 0.0f;
+    // Drop candidates whose bodies are both static or asleep. Off while the
+    // neighbour list is built: its pairs must survive a body waking up.
+    bool skip_resting_pairs = false;
+
+    // --- CONTINUOUS COLLISION (swept circles) ---
+    // Bodies whose last step moved them more than ccd_motion_fraction of their
+    // radius are swept from previous_position to position against the other
+    // bodies (at their end-of-step positions) and the walls, and pulled back to
+    // the first time of impact. The discrete phases then resolve the contact.
+    bool continuous_collision_enabled = false;
+    float ccd_motion_fraction = 0.5f;
+    std::vector<int> ccd_fast_bodies;
+    std::vector<int> ccd_hash_cells; // occupied hash cells near the current sweep (unbounded worlds)
+
+    void solve_continuous_collisions(world &simulation_world);
+
+    // Per-block counts of the parallel grid build: entry b * num_cells + c
+    // belongs to block b and cell c (counts, then each block's write offset)
+    std::vector<int> grid_block_counts;
+    std::vector<int> grid_block_awake;
+
+    // --- SLEEP STATE ---
+    std::vector<int> grid_cell_awake;       // awake dynamic bodies per uniform grid cell
+    unsigned int grid_layout_version = 0;   // world::body_layout_version of particle_cell_id
+    std::vector<float> island_rest_time;    // per island root: shortest sleep timer of its members
+    std::vector<float> sleep_reference_x;   // positions at the end of the last step
+    std::vector<float> sleep_reference_y;
+    unsigned int sleep_layout_version = 0;
+    std::vector<int> woken_islands; // sleep_island labels touched this step, woken by update_sleep
+
+    // Wakes whichever body of a touching pair is asleep; the rest of its
+    // island wakes at the end of the step.
+    void wake_touching_pair(int idxA, int idxB, world &simulation_world);
+    // Advances the sleep timers and puts islands that have rested long enough to sleep.
+    void update_sleep(world &simulation_world);
+
+    // --- VERLET NEIGHBOUR LIST STATE ---
+    // CSR list: neighbours of body i (all with a higher index) are
+    // neighbour_indices[neighbour_offsets[i] .. neighbour_offsets[i + 1]).
+    bool neighbour_list_enabled = false;
+    float neighbour_skin = 0.5f;
+    std::vector<int> neighbour_offsets;
+    std::vector<int> neighbour_indices;
+    std::vector<float> neighbour_reference_x; // positions at the last build
+    std::vector<float> neighbour_reference_y;
+    unsigned int neighbour_layout_version = 0;
+
+    bool neighbour_list_is_stale(const world &simulation_world) const;
+    void rebuild_neighbour_list(world &simulation_world);
+    void refresh_neighbour_list(world &simulation_world); // rebuilds only when stale
+    void neighbour_list_check_and_resolve(world &simulation_world);
+
+    // --- PERSISTENT CONTACTS ---
+    bool warm_starting = false; // opt-in: a cached contact keeps a target of 0 (no bounce)
+    contactCache contact_cache;
+    unsigned int contact_cache_layout_version = 0;
+    struct WarmContact
+    {
+        int idxA;
+        int idxB;
+        float impulse_x; // cached impulse along the current normal (applied +B / -A)
+        float impulse_y;
+    };
+    std::vector<WarmContact> warm_contacts;
+
+    void warm_start_contacts(world &simulation_world);
+    void settle_warm_started_contacts(world &simulation_world);
+
+    // world::body_layout_version seen by the persistent caches above
+    unsigned int cached_layout_version = 0;
+
+    // Runs the per-frame preparation of the selected broad phase (timed as broad phase).
+    void prepare_broad_phase(world &simulation_world);
+    void reset_broad_phase_caches();
+
     // --- SPATIAL GRID PHASES (Spatial Hashing) ---
-    void clear_spatial_grid(world &simulation_world);
+    // Counting sort of the dynamic bodies into world::particle_cell_id /
+    // particle_start_indices / sorted_indices, every frame.
     void populate_spatial_grid(world &simulation_world);
 
+    // Static bodies never move: they are binned once into a grid of their own,
+    // rebuilt only when world::static_layout_version or the grid bounds change.
+    // Same layout as the world grid: cell c spans
+    // static_sorted_indices[static_cell_start[c] .. static_cell_start[c + 1]).
+    std::vector<int> static_cell_start;
+    std::vector<int> static_sorted_indices;
+    // What the static grid was built from
+    unsigned int static_grid_version = 0; // world::static_layout_version
+    size_t static_grid_bodies = 0;
+    float static_grid_min_x = 0.0f;
+    float static_grid_min_y = 0.0f;
+    int static_grid_cells_x = 0;
+    int static_grid_cells_y = 0;
+    unsigned long long static_grid_builds = 0;
+
+    void refresh_static_grid(world &simulation_world);
+
     // --- COLLISION DETECTION PHASES ---
-    // Broad Phase: Generates a list of pairs of nearby bodies (candidates).
+    // Broad Phase: Generates a list of pairs of nearby bodies (candidates)
+    // from the selected broad phase.
     // Returns pairs of particle indices (SoA-friendly)
     std::vector<std::pair<int, int>> broad_phase_generate_pairs(world &simulation_world);
 
+    // Sweep and prune: refresh intervals, pick the sweep axis and re-sort.
+    // Insertion sort exploits frame-to-frame coherence; a full sort only runs
+    // when the body count or the sweep axis changes.
+    void update_sweep_and_prune(world &simulation_world);
+
+    // AABB tree: refit every body's leaf; only leaves whose tight box left the
+    // fat box are reinserted. Rebuilt from scratch when the body count changes.
+    void update_aabb_tree(world &simulation_world);
+
+    // Hierarchical grid: bin bodies by radius class, sort by cell key and
+    // compact the sorted run into a table of occupied cells.
+    void update_hierarchical_grid(world &simulation_world);
+    int find_hgrid_cell(uint64_t key) const; // index in hgrid_cells or -1
+
+    // Candidate walkers shared by both pair modes; call visit(idxA, idxB) per candidate.
+    template <typename PairVisitor>
+    void for_each_candidate_pair(world &simulation_world, PairVisitor &&visit);
+    template <typename PairVisitor>
+    void for_each_broad_phase_pair(world &simulation_world, PairVisitor &&visit);
+    template <typename PairVisitor>
+    void for_each_grid_pair(world &simulation_world, PairVisitor &&visit);
+    template <typename PairVisitor>
+    void for_each_sap_pair(PairVisitor &&visit);
+    template <typename PairVisitor>
+    void for_each_tree_pair(world &simulation_world, PairVisitor &&visit);
+    template <typename PairVisitor>
+    void for_each_hgrid_pair(PairVisitor &&visit);
+    template <typename PairVisitor>
+    void for_each_hash_grid_pair(PairVisitor &&visit);
+
     // Narrow Phase: Iterates over candidate pairs to check and resolve exact collisions.
     void narrow_phase_check_and_resolve(world &simulation_world);
 
+    // Fused broad + narrow phase used by PairGenerationMode::STREAMING.
+    void streaming_check_and_resolve(world &simulation_world);
+
+    // Broad phase (or neighbour list) + narrow phase into contact_solver's buffer.
+    // Pairs closer than contact_margin are collected too (speculative contacts).
+    void collect_contacts(world &simulation_world, float contact_margin = 0.0f);
+    // Buffered solvers: collect every contact, then solve them together.
+    void iterative_check_and_resolve(world &simulation_world);
+    // ContactSolverType::XPBD: collect, then solve contacts and boundaries on positions.
+    void xpbd_check_and_resolve(world &simulation_world);
+
+    // Static-pair skip, overlap test and resolution of one candidate.
+    void process_candidate_pair(int idxA, int idxB, world &simulation_world);
+
     // Circle-Circle Check: Uses squared distances for efficiency.
     // Index-based variant for SoA arrays
     bool check_for_overlap(int idxA, int idxB, world &simulation_world);
@@ -49,10 +264,54 @@ private:
 
     // World Boundary Collisions (floor, walls).
     void solve_boundary_contacts(world &simulation_world);
+    // GridInfo::bounded: floor, walls, ceiling and the clamps into grid_info
+    static bool has_world_bounds(const world &simulation_world);
+    // Broad phase that actually runs: the flat grid cannot see bodies outside
+    // GridInfo, so an unbounded world uses the hashed grid instead
+    BroadPhaseType active_broad_phase(const world &simulation_world) const;
+
+    // One collision step; update() wraps it so phase timers add up over substeps.
+    void step(world &simulation_world);
 
 public:
     // Main update loop of the collision simulation.
     void update(world &simulation_world, float delta_time) override;
+    void set_thread_pool(threadPool *pool) override { shared_pool = pool; }
+    // Reads every column; moves, sleeps and bins bodies and fills the frame counters
+    ColumnSet reads() const override { return COLUMNS_ALL; }
+    ColumnSet writes() const override
+    {
+        return COLUMN_POSITION | COLUMN_PREVIOUS_POSITION | COLUMN_VELOCITY | COLUMN_SLEEP | COLUMN_GRID | COLUMN_STATS;
+    }
+
+    void set_pair_generation_mode(PairGenerationMode mode);
+    PairGenerationMode get_pair_generation_mode() const;
+    void set_broad_phase(BroadPhaseType type);
+    BroadPhaseType get_broad_phase() const;
+    // Verlet neighbour lists: candidates within radius + skin are cached and the
+    // broad phase only reruns once some body moved more than half the skin.
+    // skin <= 0 keeps the default skin.
+    void set_neighbour_list(bool enabled, float skin = 0.0f);
+    bool get_neighbour_list_enabled() const;
+    // Continuous collision for bodies moving more than motion_fraction of their
+    // radius per step; motion_fraction <= 0 keeps the default (0.5).
+    void set_continuous_collision(bool enabled, float motion_fraction = 0.0f);
+    bool get_continuous_collision_enabled() const;
+    // Warm starting: each contact starts from the impulse it accumulated last
+    // frame. Off by default.
+    void set_warm_starting(bool enabled);
+    bool get_warm_starting() const;
+    void set_contact_solver(ContactSolverType type);
+    ContactSolverType get_contact_solver() const;
+    // Threads used by the parallel phases (uniform grid build, boundaries and the
+    // GRAPH_COLORED, JACOBI and ISLANDS solvers). <= 0 uses the systemManager's
+    // pool, or the calling thread alone when the system runs on its own.
+    void set_solver_threads(int threads);
+    int get_solver_threads() const;
+    // Times the cached grid of static bodies was built (UNIFORM_GRID and continuous collision)
+    unsigned long long get_static_grid_builds() const { return static_grid_builds; }
+    // Contacts (and their coloring) of the last buffered solve
+    const contactSolver &get_contact_solver_state() const { return contact_solver; }
 
     collisionSystem();
     ~collisionSystem();
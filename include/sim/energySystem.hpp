@@ -0,0 +1,35 @@
+#pragma once
+
+#include "sim/ISystem.hpp"
+
+class world;
+
+// ====================================================================
+// --- ENERGY ANALYTICS ---
+// Once per frame, sums the kinetic energy, the potential energy in the
+// world gravity (relative to y = 0 for gravity along -y) and the linear
+// momentum of the dynamic bodies. Read-only on the world, so
+// systemManager can run it alongside other systems that only read the
+// bodies.
+// ====================================================================
+
+class energySystem : public ISystem
+{
+private:
+    double kinetic_energy = 0.0;
+    double potential_energy = 0.0;
+    double momentum_x = 0.0;
+    double momentum_y = 0.0;
+
+public:
+    void update(world &simulation_world, float dt) override;
+    SystemSchedule schedule() const override { return SystemSchedule::ONCE_PER_FRAME; }
+    ColumnSet reads() const override { return COLUMN_POSITION | COLUMN_VELOCITY | COLUMN_MASS | COLUMN_SETTINGS; }
+    ColumnSet writes() const override { return COLUMNS_NONE; }
+
+    double get_kinetic_energy() const { return kinetic_energy; }
+    double get_potential_energy() const { return potential_energy; }
+    double get_total_energy() const { return kinetic_energy + potential_energy; }
+    double get_momentum_x() const { return momentum_x; }
+    double get_momentum_y() const { return momentum_y; }
+};
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// ====================================================================
+// --- INTEGRATOR POLICIES ---
+// Every integrator leaves the state the collision phases expect: vel
+// holds the velocity the body ends the step with and previous_position
+// is position - vel * dt, so the solvers can read the velocity back as
+// (position - previous_position) / dt and write it the same way. Position
+// Verlet keeps the convention it always had: previous_position is the
+// start of the step and vel the centred difference. The policies only
+// differ in how they advance x and v under
+//   a = g - v * (damping + friction)
+// followed by the exponential decay exp(-(global_damping + damping) dt).
+// See docs/integradores.md for when to use each one.
+// ====================================================================
+
+enum class IntegratorType
+{
+    EULER_EXPLICIT,      // x' = x + v dt, then v' = v + a dt
+    EULER_SEMI_IMPLICIT, // v' = v + a dt, then x' = x + v' dt
+    VERLET_POSITION,     // x' = 2x - x_prev + a dt^2 (the default)
+    VELOCITY_VERLET      // half kick, drift, half kick with the drag at the half step
+};
+
+// "euler", "semi-implicit", "verlet" or "velocity-verlet"
+const char *integrator_name(IntegratorType type);
+
+struct IntegratorColumns
+{
+    float *position_x;
+    float *position_y;
+    float *previous_position_x;
+    float *previous_position_y;
+    float *vel_x;
+    float *vel_y;
+    const float *inv_mass;
+    const float *damping;    // nullptr: no per-body damping (integrate_bodies only)
+    const float *friction;   // nullptr: no friction (integrate_bodies only)
+    const uint8_t *sleeping; // nullptr: nobody sleeps (integrate_bodies only)
+};
+
+struct IntegratorStepParams
+{
+    float gravity_x;
+    float gravity_y;
+    float delta_time;
+    float global_damping;
+};
+
+// Integrates bodies [begin, end)
+using IntegratorKernel = void (*)(const IntegratorColumns &columns, const IntegratorStepParams &params, size_t begin, size_t end);
+
+// exp(x) as in Cephes expf: x = n ln2 + r with |r| <= ln2 / 2, a degree 6
+// polynomial for exp(r) and 2^n built in the exponent bits. The SIMD
+// Verlet kernels evaluate the same constants in the same order.
+const float EXP_HI = 88.3762626647949f;
+const float EXP_LO = -87.3365447504019f;
+const float EXP_LOG2E = 1.44269504088896341f;
+const float EXP_LN2_HI = 0.693359375f;
+const float EXP_LN2_LO = -2.12194440e-4f;
+const float EXP_P0 = 1.9875691500e-4f;
+const float EXP_P1 = 1.3981999507e-3f;
+const float EXP_P2 = 8.3334519073e-3f;
+const float EXP_P3 = 4.1665795894e-2f;
+const float EXP_P4 = 1.6666665459e-1f;
+const float EXP_P5 = 5.0000001201e-1f;
+
+// condition ? a : b through bit masks. Written with ?: on floats, the
+// compiler turns the selects of integrate_range back into branches and
+// conditional stores, and the loop no longer vectorizes.
+inline float select_float(bool condition, float a, float b)
+{
+    uint32_t mask = 0u - (uint32_t)condition;
+    uint32_t bits_a, bits_b;
+    std::memcpy(&bits_a, &a, sizeof(bits_a));
+    std::memcpy(&bits_b, &b, sizeof(bits_b));
+    uint32_t bits = (bits_a & mask) | (bits_b & ~mask);
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+inline float exp_approx(float x)
+{
+    x = select_float(x < EXP_LO, EXP_LO, x);
+    x = select_float(x > EXP_HI, EXP_HI, x);
+    // floor as truncate-and-correct, which vectorizes without SSE4.1
+    float fx = x * EXP_LOG2E + 0.5f;
+    float truncated = (float)(int32_t)fx;
+    float n = select_float(truncated > fx, truncated - 1.0f, truncated);
+    float r = x - n * EXP_LN2_HI;
+    r = r - n * EXP_LN2_LO;
+    float y = EXP_P0;
+    y = y * r + EXP_P1;
+    y = y * r + EXP_P2;
+    y = y * r + EXP_P3;
+    y = y * r + EXP_P4;
+    y = y * r + EXP_P5;
+    y = y * (r * r) + r;
+    y = y + 1.0f;
+    int32_t bits = ((int32_t)n + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return y * scale;
+}
+
+// One axis of one body after Policy::step, before the damping decay.
+// `drag` is damping + friction (0 when the world has neither).
+struct AxisStep
+{
+    float x;
+    float prev;
+    float v;
+};
+
+struct EulerExplicitPolicy
+{
+    static AxisStep step(float x, float /*prev*/, float v, float g, float drag, float dt, float /*dt2*/)
+    {
+        float a = g - v * drag;
+        float next = x + v * dt;
+        float next_v = v + a * dt;
+        return {next, next - next_v * dt, next_v};
+    }
+};
+
+struct EulerSemiImplicitPolicy
+{
+    static AxisStep step(float x, float /*prev*/, float v, float g, float drag, float dt, float /*dt2*/)
+    {
+        float a = g - v * drag;
+        float next_v = v + a * dt;
+        return {x + next_v * dt, x, next_v};
+    }
+};
+
+// Velocity is the centred difference (next - prev) / 2dt
+struct VerletPositionPolicy
+{
+    static AxisStep step(float x, float prev, float v, float g, float drag, float dt, float dt2)
+    {
+        float a = g - v * drag;
+        float next = (x * 2.0f - prev) + a * dt2;
+        return {next, x, (next - prev) * (0.5f / dt)};
+    }
+};
+
+struct VelocityVerletPolicy
+{
+    static AxisStep step(float x, float /*prev*/, float v, float g, float drag, float dt, float /*dt2*/)
+    {
+        float half_dt = 0.5f * dt;
+        float half_v = v + (g - v * drag) * half_dt;
+        float next = x + half_v * dt;
+        float next_v = half_v + (g - half_v * drag) * half_dt;
+        return {next, next - next_v * dt, next_v};
+    }
+};
+
+// Loop behind integrate_bodies. CHECKED tolerates missing optional
+// columns (worlds from the legacy constructors) at the price of the
+// per-body tests that keep the loop from vectorizing. The columns never
+// overlap; without restrict parameters the compiler needs more run-time
+// alias checks than it is willing to emit and stays scalar.
+template <typename Policy, bool DAMPING, bool FRICTION, bool CHECKED>
+void integrate_range(float *__restrict position_x, float *__restrict position_y,
+                     float *__restrict previous_position_x, float *__restrict previous_position_y,
+                     float *__restrict vel_x, float *__restrict vel_y, const float *__restrict inv_mass,
+                     const float *__restrict damping, const float *__restrict friction,
+                     const uint8_t *__restrict sleeping, const IntegratorStepParams &p, size_t begin, size_t end)
+{
+    const float gravity_x = p.gravity_x;
+    const float gravity_y = p.gravity_y;
+    const float global_damping = p.global_damping;
+    const float dt = p.delta_time;
+    const float dt2 = dt * dt;
+    for (size_t i = begin; i < end; ++i)
+    {
+        bool asleep = (!CHECKED || sleeping) ? sleeping[i] != 0 : false;
+        bool active = (inv_mass[i] > 0.0f) & !asleep;
+
+        float d = (DAMPING && (!CHECKED || damping)) ? damping[i] : 0.0f;
+        float f = (FRICTION && (!CHECKED || friction)) ? friction[i] : 0.0f;
+        float drag = d + f;
+
+        float x = position_x[i];
+        float y = position_y[i];
+        float prev_x = previous_position_x[i];
+        float prev_y = previous_position_y[i];
+        float vx = vel_x[i];
+        float vy = vel_y[i];
+        AxisStep sx = Policy::step(x, prev_x, vx, gravity_x, drag, dt, dt2);
+        AxisStep sy = Policy::step(y, prev_y, vy, gravity_y, drag, dt, dt2);
+
+        if (DAMPING)
+        {
+            float combined_damping = global_damping + d;
+            bool damped = combined_damping > 0.0f;
+            float factor = select_float(damped, exp_approx(-combined_damping * dt), 1.0f);
+            sx.v *= factor;
+            sy.v *= factor;
+            // Previous position consistent with the damped velocity
+            sx.prev = select_float(damped, sx.x - sx.v * dt, sx.prev);
+            sy.prev = select_float(damped, sy.x - sy.v * dt, sy.prev);
+        }
+
+        position_x[i] = select_float(active, sx.x, x);
+        position_y[i] = select_float(active, sy.x, y);
+        previous_position_x[i] = select_float(active, sx.prev, prev_x);
+        previous_position_y[i] = select_float(active, sy.prev, prev_y);
+        vel_x[i] = select_float(active, sx.v, vx);
+        vel_y[i] = select_float(active, sy.v, vy);
+    }
+}
+
+// Integrates bodies [begin, end) with `Policy`. DAMPING and FRICTION are
+// fixed per instantiation, so a world without friction never reads the
+// friction column, and one without any damping skips the exp. The loop
+// body has no branches (static and sleeping bodies compute the step and
+// keep their old values through selects), so the compiler vectorizes it.
+template <typename Policy, bool DAMPING, bool FRICTION>
+void integrate_bodies(const IntegratorColumns &c, const IntegratorStepParams &p, size_t begin, size_t end)
+{
+    bool complete = c.sleeping && (!DAMPING || c.damping) && (!FRICTION || c.friction);
+    auto range = complete ? integrate_range<Policy, DAMPING, FRICTION, false> : integrate_range<Policy, DAMPING, FRICTION, true>;
+    range(c.position_x, c.position_y, c.previous_position_x, c.previous_position_y, c.vel_x, c.vel_y, c.inv_mass,
+          c.damping, c.friction, c.sleeping, p, begin, end);
+}
+
+// Instantiation for an integrator and feature mix, picked at runtime
+IntegratorKernel select_integrator_kernel(IntegratorType type, bool damping, bool friction);
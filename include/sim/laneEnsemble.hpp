@@ -0,0 +1,94 @@
+#pragma once
+
+#include "utils/cpuFeatures.hpp"
+#include <cstddef>
+#include <vector>
+
+class world;
+
+// Worlds advanced together by one laneEnsemble (one per AVX2 register lane)
+const int WORLD_LANES = 8;
+
+// Per-lane settings, lane k at index k
+struct LaneSettings
+{
+    alignas(32) float gravity_x[WORLD_LANES] = {};
+    alignas(32) float gravity_y[WORLD_LANES] = {};
+    alignas(32) float global_damping[WORLD_LANES] = {};
+    alignas(32) float min_x[WORLD_LANES] = {};
+    alignas(32) float max_x[WORLD_LANES] = {};
+    alignas(32) float min_y[WORLD_LANES] = {};
+    alignas(32) float max_y[WORLD_LANES] = {};
+};
+
+// ====================================================================
+// --- LANE ENSEMBLE ---
+// Up to WORLD_LANES tiny worlds (a few dozen bodies, too few for the
+// per-body loops to vectorize) stepped in lockstep, one world per SIMD
+// lane: body b of lane k lives at [b * WORLD_LANES + k] in every column,
+// so one register holds body b of every world and each instruction
+// advances all of them. A step is position Verlet (the default
+// movementSystem kernel), an all-pairs contact pass with the
+// single-pass impulse formulas of collisionSystem (in index order, no
+// warm starting) and its boundary contacts. Sleeping, CCD, substeps and
+// the other solvers are not modelled.
+// Lanes with fewer bodies, and unused lanes, are padded with static
+// bodies of radius 0 parked far outside every world, which never touch
+// anything. Lanes share delta_time and SolverSettings (taken from the
+// first world); gravity, global damping and the bounds are per lane.
+// ====================================================================
+
+class laneEnsemble
+{
+public:
+    // Kernel variant: AVX2 and AVX-512 run 8 lanes per instruction, the
+    // other levels a loop over the lanes
+    explicit laneEnsemble(SimdLevel level = detect_simd_level());
+
+    // Copies the bodies and settings of `source` into the next free lane and
+    // returns it; -1 when every lane is taken, the world is unbounded
+    // (GridInfo::bounded), or the time step differs from the first world's
+    // (or is not positive)
+    int add_world(const world &source);
+    int lane_count() const { return lanes; }
+    // Rows of the columns: the largest body count of any lane
+    size_t body_rows() const { return rows; }
+    size_t lane_body_count(int lane) const { return lane_bodies[lane]; }
+    SimdLevel get_simd_level() const { return simd_level; }
+
+    void step(int frames = 1);
+
+    // Writes positions, previous positions and velocities of `lane` back to
+    // the world it was copied from (same body order)
+    void store_world(int lane, world &target) const;
+    // Energy of the dynamic bodies of `lane`, as energySystem computes it
+    double kinetic_energy(int lane) const;
+    double total_energy(int lane) const;
+
+    // Lane-batched columns
+    std::vector<float> position_x;
+    std::vector<float> position_y;
+    std::vector<float> previous_position_x;
+    std::vector<float> previous_position_y;
+    std::vector<float> vel_x;
+    std::vector<float> vel_y;
+    std::vector<float> mass;
+    std::vector<float> inv_mass;
+    std::vector<float> radius;
+    std::vector<float> damping;
+    std::vector<float> friction;
+    std::vector<float> restitution;
+
+    LaneSettings settings;
+    float delta_time = 0.0f;
+    float position_correction_percent = 0.0f;
+    float position_correction_slop = 0.0f;
+
+private:
+    SimdLevel simd_level;
+    int lanes = 0;
+    size_t rows = 0;
+    size_t lane_bodies[WORLD_LANES] = {};
+
+    void add_rows(size_t count);
+};
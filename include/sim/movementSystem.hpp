@@ -1,14 +1,39 @@
+#pragma once
+
 #include "sim/ISystem.hpp"
+#include "sim/integratorPolicies.hpp"
+#include "utils/cpuFeatures.hpp"
 
 class world;
 class movementSystem : public ISystem
 {
 private:
     /* data */
-    void verlet_integration(world &world);
+    void integrate(world &world);
+
+    IntegratorType integrator;
+    // Kernel variant for position Verlet, picked from the CPU at construction
+    SimdLevel simd_level;
+    IntegratorKernel verlet_simd_kernel;
+    // Shared worker pool of the systemManager; nullptr integrates on the calling thread
+    threadPool *thread_pool = nullptr;
 
 public:
     void update(world &, float dt) override;
-    movementSystem(/* args */);
+    void set_thread_pool(threadPool *pool) override { thread_pool = pool; }
+    ColumnSet reads() const override
+    {
+        return COLUMN_POSITION | COLUMN_PREVIOUS_POSITION | COLUMN_VELOCITY | COLUMN_MASS | COLUMN_MATERIAL | COLUMN_SLEEP | COLUMN_SETTINGS;
+    }
+    ColumnSet writes() const override { return COLUMN_POSITION | COLUMN_PREVIOUS_POSITION | COLUMN_VELOCITY; }
+    explicit movementSystem(IntegratorType integrator = IntegratorType::VERLET_POSITION);
     ~movementSystem();
+
+    void set_integrator(IntegratorType type);
+    IntegratorType get_integrator() const;
+    // Forces a kernel variant (benchmarks, tests); levels above what the
+    // CPU supports are clamped to detect_simd_level(). Only position Verlet
+    // has SIMD variants; the other integrators run integrate_bodies.
+    void set_simd_level(SimdLevel level);
+    SimdLevel get_simd_level() const;
 };
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "sim/ISystem.hpp"
+#include <vector>
+#include <cstdint>
+
+class world;
+
+// ====================================================================
+// --- SPATIAL REORDERING (Morton / Z-order) ---
+// Periodically sorts every world column by the Morton code of the body's
+// grid cell so bodies that are close in space are close in memory.
+// Runs every `interval_frames` frames, or earlier when the fraction of
+// consecutive bodies whose codes are out of order exceeds
+// `disorder_threshold`. After a reorder, last_remap() maps old body
+// indices to new ones so external indices can follow their bodies.
+// ====================================================================
+
+class reorderSystem : public ISystem
+{
+private:
+    int interval_frames;
+    float disorder_threshold;
+    int frames_since_reorder = 0;
+
+    bool reordered = false;
+    float disorder = 0.0f;
+    std::vector<int> remap;
+
+    // Scratch buffers reused between frames
+    std::vector<uint32_t> codes;
+    std::vector<int> order;
+
+    void compute_codes(const world &simulation_world);
+
+public:
+    // interval_frames <= 0 disables the periodic trigger (metric only);
+    // disorder_threshold >= 1 disables the metric trigger (periodic only).
+    reorderSystem(int interval_frames = 120, float disorder_threshold = 0.25f);
+    ~reorderSystem() = default;
+
+    void update(world &simulation_world, float dt) override;
+    // Permuting bodies between substeps gains nothing
+    SystemSchedule schedule() const override { return SystemSchedule::ONCE_PER_FRAME; }
+    ColumnSet reads() const override { return COLUMN_POSITION | COLUMN_SETTINGS; }
+    ColumnSet writes() const override { return COLUMN_LAYOUT; }
+
+    // True when the last update permuted the bodies.
+    bool reordered_last_update() const { return reordered; }
+    // Old index -> new index of the last reorder (empty before the first one).
+    const std::vector<int> &last_remap() const { return remap; }
+    // Fraction of out-of-order neighbours measured by the last update (0 = sorted).
+    float last_disorder() const { return disorder; }
+
+    // Morton code of a cell: interleaves the low 16 bits of cx and cy.
+    static uint32_t morton_code(uint32_t cx, uint32_t cy);
+};
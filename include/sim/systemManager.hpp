@@ -7,17 +7,70 @@
 #include <memory>
 
 class world;
+class threadPool;
+
+// Adaptive substepping: a frame of length dt is split into K substeps so
+// that no body travels more than max_travel_fraction of the smallest
+// radius per substep, with min_substeps <= K <= max_substeps. When a time
+// budget is set, K is also capped by budget / measured cost of a substep.
+struct SubstepSettings
+{
+    bool enabled = false;
+    int min_substeps = 1;
+    int max_substeps = 8;
+    float max_travel_fraction = 0.5f;
+    float frame_budget_us = 0.0f; // 0 = no budget
+};
 
 class systemManager
 {
 private:
+    // Declared before the systems, which keep a pointer to it, so it outlives them
+    std::unique_ptr<threadPool> thread_pool;
     std::vector<std::unique_ptr<ISystem>> systems;
 
+    SubstepSettings substep_settings;
+    int last_substeps = 1;
+    float substep_cost_us = 0.0f; // moving average of one substep's wall time
+
+    // Dependency graph of the systems run by one run_systems call. A system
+    // depends on every earlier system it conflicts with (one of them writes a
+    // group of columns the other reads or writes); it lands one level after
+    // the deepest of them. Systems of a level run concurrently on the pool,
+    // levels run in order, so conflicting systems keep their insertion order.
+    struct ScheduledSystem
+    {
+        ISystem *system;
+        float dt;
+        int level;
+    };
+    std::vector<ScheduledSystem> schedule;
+    std::vector<ScheduledSystem> level_systems; // scratch: systems of the level being run
+    int schedule_levels = 0;
+
+    int choose_substeps(const world &world, float dt) const;
+    void build_schedule(float substep_dt, float frame_dt, bool last_substep);
+    void run_systems(world &world, float substep_dt, float frame_dt, bool last_substep);
+
 public:
     void addSystem(std::unique_ptr<ISystem> sys);
 
     void update(world &world, float dt);
 
-    systemManager();
-    ~systemManager() = default;
-};
\ No newline at end of file
+    void set_substepping(const SubstepSettings &settings);
+    const SubstepSettings &get_substepping() const { return substep_settings; }
+    // Substeps used by the last update (1 without substepping)
+    int get_last_substeps() const { return last_substeps; }
+
+    // Threads of the pool shared by every system (caller included);
+    // <= 0 uses every hardware thread, 1 runs everything on the caller
+    void set_worker_threads(int threads);
+    int get_worker_threads() const;
+    // Levels of the last schedule: 1 when every system ran concurrently, the
+    // number of systems when each one depended on the previous one
+    int get_last_schedule_levels() const { return schedule_levels; }
+
+    // worker_threads: threads of the shared pool, as in set_worker_threads
+    explicit systemManager(int worker_threads = 0);
+    ~systemManager();
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "sim/integratorPolicies.hpp"
+#include "utils/cpuFeatures.hpp"
+
+// ====================================================================
+// --- VERLET KERNELS ---
+// Position Verlet (VerletPositionPolicy with damping and friction) written
+// with intrinsics, one variant per SimdLevel. All variants compute, per
+// dynamic awake body:
+//   a     = g - v * (damping + friction)
+//   x'    = 2x - x_prev + a * dt^2
+//   v'    = (x' - x_prev) / (2 dt) * exp(-(global_damping + damping) * dt)
+//   x_prev' = x' - v' * dt   (x when the combined damping is 0)
+// Static bodies (inv_mass <= 0) and sleeping bodies are masked, not
+// branched on. They use the same polynomial exp as integrate_bodies and
+// finish the last bodies with it, so they agree with it to rounding.
+// ====================================================================
+
+// Variant for `level` (SCALAR: integrate_bodies). Every column of
+// IntegratorColumns must be set. The caller checks the CPU supports `level`.
+IntegratorKernel select_verlet_kernel(SimdLevel level);
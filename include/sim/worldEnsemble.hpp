@@ -0,0 +1,77 @@
+#pragma once
+
+#include "physics/world.hpp"
+#include "sim/systemManager.hpp"
+#include "utils/threadPool.hpp"
+#include <functional>
+#include <memory>
+#include <vector>
+
+class energySystem;
+
+// What one member did during the frames stepped since the last reset_metrics()
+struct EnsembleMetrics
+{
+    int frames = 0;
+    double step_us = 0.0;                   // wall time of the member's frames
+    double max_frame_us = 0.0;              // slowest frame
+    unsigned long long contacts = 0;        // world::solver_contacts summed over the frames
+    unsigned long long substeps = 0;        // world::substeps summed over the frames
+    unsigned long long sleeping_bodies = 0; // after the last frame
+    double kinetic_energy = 0.0;            // after the last frame
+    double total_energy = 0.0;              // kinetic + potential, after the last frame
+};
+
+// ====================================================================
+// --- WORLD ENSEMBLE ---
+// Many small, independent worlds (a parameter sweep) stepped together
+// in one process. Each member owns its world and a systemManager of its
+// own; step() hands one member per task to a work-stealing pool, so a
+// member that runs long does not leave the other threads idle. Members
+// step on a single thread each (their managers have no workers): with
+// hundreds of small worlds the parallelism is across members, not
+// inside them. A member's result does not depend on the thread count.
+// ====================================================================
+
+class worldEnsemble
+{
+public:
+    // Adds the systems of one member; called once per add_world, so no
+    // system instance is shared between members
+    using SystemSetup = std::function<void(systemManager &)>;
+
+    // thread_count <= 0 uses every hardware thread
+    explicit worldEnsemble(int thread_count = 0);
+    ~worldEnsemble();
+
+    // Returns the member index. An energySystem is appended after the
+    // setup's systems for the energy metrics.
+    size_t add_world(world member_world, const SystemSetup &setup);
+    size_t size() const { return members.size(); }
+    int thread_count() const { return pool.thread_count(); }
+
+    // Steps every member `frames` frames of its own delta_time
+    void step(int frames);
+    void reset_metrics();
+
+    world &get_world(size_t member) { return members[member]->sim_world; }
+    const world &get_world(size_t member) const { return members[member]->sim_world; }
+    systemManager &get_manager(size_t member) { return members[member]->manager; }
+    const EnsembleMetrics &get_metrics(size_t member) const { return members[member]->metrics; }
+
+private:
+    struct Member
+    {
+        world sim_world;
+        systemManager manager{1};
+        energySystem *energy = nullptr; // owned by manager
+        EnsembleMetrics metrics;
+
+        explicit Member(world member_world) : sim_world(std::move(member_world)) {}
+    };
+
+    threadPool pool;
+    std::vector<std::unique_ptr<Member>> members;
+
+    static void step_member(Member &member, int frames);
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+// ====================================================================
+// --- CPU FEATURES ---
+// SIMD level of the running CPU, read once with CPUID (and XGETBV to
+// check the OS saves the wide registers). Kernels compiled for several
+// instruction sets pick their variant from this at startup.
+// ====================================================================
+
+enum class SimdLevel
+{
+    SCALAR, // Plain C++ (non-x86 builds)
+    SSE2,   // 4 floats per register; baseline on x86-64
+    AVX2,   // 8 floats per register
+    AVX512  // 16 floats per register plus mask registers (AVX-512F)
+};
+
+// Best level supported by this CPU and OS (cached after the first call)
+SimdLevel detect_simd_level();
+
+// "scalar", "sse2", "avx2" or "avx512"
+const char *simd_level_name(SimdLevel level);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// ====================================================================
+// --- SPSC QUEUE ---
+// Bounded lock-free FIFO between exactly one producer thread and one
+// consumer thread (a ring buffer with atomic head and tail). push()
+// fails instead of blocking when the ring is full.
+// ====================================================================
+
+template <typename T>
+class spscQueue
+{
+public:
+    // Holds up to `capacity` items (rounded up to a power of two)
+    explicit spscQueue(size_t capacity = 256)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        items.resize(size);
+        mask = size - 1;
+    }
+
+    spscQueue(const spscQueue &) = delete;
+    spscQueue &operator=(const spscQueue &) = delete;
+
+    size_t capacity() const { return items.size(); }
+
+    // Producer side
+    bool push(const T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == items.size())
+            return false;
+        items[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T &item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        item = items[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> items;
+    size_t mask = 0;
+    // On separate cache lines so the two threads do not share one
+    alignas(64) std::atomic<size_t> head{0}; // next item to pop (consumer)
+    alignas(64) std::atomic<size_t> tail{0}; // next slot to push (producer)
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ====================================================================
+// --- THREAD POOL ---
+// Persistent work-stealing workers for data-parallel loops. Every
+// thread has its own deque of pending ranges: parallel_for splits a
+// range in halves down to the grain size, keeps working on the left
+// half and pushes the right half to the back of its deque. The owner
+// pops from the back (the small, cache-warm pieces); idle threads steal
+// from the front of the others (the large pieces), so an uneven loop
+// (islands of very different sizes) still keeps every thread busy.
+// Threads outside the pool (the main loop) share deque 0 and work on
+// their own loops until they finish, so parallel_for may be called from
+// inside a task.
+// ====================================================================
+
+class threadPool
+{
+public:
+    // thread_count <= 0 uses std::thread::hardware_concurrency()
+    explicit threadPool(int thread_count = 0);
+    ~threadPool();
+
+    threadPool(const threadPool &) = delete;
+    threadPool &operator=(const threadPool &) = delete;
+
+    // Threads taking part in parallel_for, caller included
+    int thread_count() const { return (int)workers.size() + 1; }
+
+    // Calls task(begin, end) on disjoint ranges covering [0, count) and
+    // returns once every range is done. Ranges hold at most `grain` items
+    // (at least half of it unless count is smaller); with a single thread
+    // or count <= grain the whole loop runs inline. The split depends on
+    // which thread steals what, so tasks must not depend on it.
+    void parallel_for(int count, const std::function<void(int, int)> &task, int grain = 64);
+
+private:
+    struct Job
+    {
+        const std::function<void(int, int)> *task;
+        int grain;
+        std::atomic<int> remaining; // items not run yet
+    };
+    struct Range
+    {
+        Job *job;
+        int begin;
+        int end;
+    };
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues; // [0]: threads outside the pool, [w]: worker w
+
+    // Idle threads sleep on `wake` until a range is queued or a job they wait on ends
+    std::atomic<int> queued_ranges{0};
+    std::atomic<int> sleepers{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+
+    int current_queue() const;
+    void push(int queue, const Range &range);
+    bool take(int queue, Range &range); // own back first, then the front of the others
+    void run(int queue, Range range);
+    template <typename Predicate>
+    void sleep_until(Predicate &&ready);
+    void notify(bool everyone);
+    void worker_loop(int queue);
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+
+// ====================================================================
+// --- TRIPLE BUFFER ---
+// Hands complete values from one writer thread to one reader thread
+// without locks and without either side waiting for the other. The
+// writer fills its back buffer and publishes it; the reader picks up
+// the latest published buffer whenever it wants one. Buffers are never
+// shared: publish() and acquire() swap indices through one atomic, so
+// the writer can overwrite its back buffer while the reader still holds
+// the previous frame. Unread frames are dropped (the reader only ever
+// sees the newest one). The buffers are reused, so values that keep
+// their capacity (vectors) stop allocating after the first frames.
+// ====================================================================
+
+template <typename T>
+class tripleBuffer
+{
+public:
+    // Writer side: the buffer to fill before the next publish()
+    T &write_buffer() { return buffers[back]; }
+    // Writer side: makes the back buffer the latest frame
+    void publish()
+    {
+        back = latest.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader side: switches to the latest frame when a new one was
+    // published since the last call. Returns whether it did.
+    bool acquire()
+    {
+        if (!(latest.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        front = latest.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    // Reader side: the frame picked up by the last acquire()
+    const T &read_buffer() const { return buffers[front]; }
+
+private:
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int FRESH = 4; // set while `latest` has not been acquired
+
+    T buffers[3];
+    int front = 0;               // reader only
+    int back = 1;                // writer only
+    std::atomic<int> latest{2};
+};
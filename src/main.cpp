@@ -5,9 +5,16 @@
 #include "sim/systemManager.hpp"
 #include "sim/movementSystem.hpp"
 #include "sim/collisionSystem.hpp"
+#include "sim/reorderSystem.hpp"
+#include "utils/spscQueue.hpp"
+#include "utils/tripleBuffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <memory>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
 // ====================================================================
 // --- VISUALIZATION CONFIGURATION ---
@@ -55,6 +62,443 @@ body create_body(float pos_x, float pos_y, float vel_x, float vel_y, float mass
     return body(vec2(pos_x, pos_y), vec2(vel_x, vel_y), vec2(0, 0), mass, inv_mass, radius, restitution, damping, friction);
 }
 
+
+/**
+ * @brief Converts Screen coordinates (Y+ down) back to World coordinates (Y+ up).
+ */
+vec2 ScreenToWorld(int screen_x, int screen_y)
+{
+    return vec2((screen_x - center_x) / world_scale, (center_y - screen_y) / world_scale);
+}
+
+// ====================================================================
+// --- SIMULATION THREAD ---
+// Physics steps on its own thread at the fixed rate while the raylib
+// loop draws at the display rate. The simulation publishes what the
+// renderer draws through a triple buffer and the UI sends its edits
+// through a lock-free queue, so neither thread ever waits for the other:
+// a slow physics frame leaves the last complete frame on screen and a
+// slow draw does not hold the simulation back.
+// ====================================================================
+
+// Immutable copy of the state one render frame draws
+struct RenderSnapshot
+{
+    unsigned long long step = 0; // physics steps taken so far
+    std::vector<float> position_x;
+    std::vector<float> position_y;
+    std::vector<float> radius;
+    std::vector<float> mass;
+    std::vector<float> inv_mass;
+    // Selected body: index into the columns above (-1 when none) and the
+    // properties the panel shows besides the columns
+    int selected = -1;
+    float selected_restitution = 0.0f;
+    float selected_damping = 0.0f;
+    float selected_friction = 0.0f;
+    // Runtime tuning, for the HUD
+    float gravity_y = 0.0f; // gravity scale applied
+    float global_damping = 0.0f;
+    bool paused = false;
+};
+
+// Property of the selected body a key nudges
+enum class BodyProperty
+{
+    MASS,
+    RESTITUTION,
+    RADIUS,
+    DAMPING,
+    FRICTION
+};
+
+enum class CommandType
+{
+    TOGGLE_PAUSE,
+    STEP,           // single step while paused
+    SAVE_SNAPSHOT,  // copy every body
+    LOAD_SNAPSHOT,  // restore the saved bodies
+    SPAWN,          // add `spawn`
+    GRAB,           // select the body at `point` and start dragging it (a miss clears the selection)
+    DRAG_TO,        // move the dragged body towards `point`
+    RELEASE,        // let go of the dragged body with velocity `point`
+    EDIT_SELECTED,  // add `amount` to `property` of the selected body
+    REMOVE_SELECTED,
+    NUDGE_GLOBAL_DAMPING, // add `amount` to world::global_damping
+    NUDGE_GRAVITY_SCALE   // add `amount` to the gravity scale
+};
+
+// UI edit on its way to the simulation thread. Bodies are picked by world
+// position on the simulation side: indices the renderer saw may already be
+// stale (reorder, set_mass) by the time the command arrives.
+struct UiCommand
+{
+    CommandType type = CommandType::STEP;
+    vec2 point = vec2(0, 0);
+    body spawn;
+    BodyProperty property = BodyProperty::MASS;
+    float amount = 0.0f;
+};
+
+class simulationThread
+{
+public:
+    // Steps no more than this many frames to catch up after a stall
+    static constexpr int MAX_CATCH_UP_STEPS = 5;
+
+    simulationThread(world initial_world, vec2 gravity_in, float fixed_dt_in)
+        : sim_world(std::move(initial_world)), gravity(gravity_in), fixed_dt(fixed_dt_in), commands(1024)
+    {
+        // Keep a handle on the reorder pass to remap UI indices after bodies move in memory
+        auto reorder = std::make_unique<reorderSystem>();
+        reorder_system = reorder.get();
+        manager.addSystem(std::move(reorder));
+        manager.addSystem(std::make_unique<movementSystem>());
+        auto collision = std::make_unique<collisionSystem>();
+        collision->set_warm_starting(true);
+        manager.addSystem(std::move(collision));
+        publish();
+    }
+
+    ~simulationThread() { stop(); }
+
+    void start()
+    {
+        running = true;
+        thread = std::thread(&simulationThread::run, this);
+    }
+
+    void stop()
+    {
+        running = false;
+        if (thread.joinable())
+            thread.join();
+    }
+
+    // UI thread: queues an edit. Returns false (the edit is dropped) when the
+    // simulation has fallen more than a queue's worth of commands behind.
+    bool send(const UiCommand &command) { return commands.push(command); }
+
+    // UI thread: switches to the newest complete frame, if there is one
+    bool acquire_frame() { return frames.acquire(); }
+    const RenderSnapshot &frame() const { return frames.read_buffer(); }
+
+private:
+    world sim_world;
+    systemManager manager;
+    reorderSystem *reorder_system = nullptr;
+    const vec2 gravity;
+    const float fixed_dt;
+
+    tripleBuffer<RenderSnapshot> frames;
+    spscQueue<UiCommand> commands;
+    std::atomic<bool> running{false};
+    std::thread thread;
+
+    // Simulation-side UI state
+    unsigned long long steps = 0;
+    int selected_body_index = -1;
+    int dragging_idx = -1;
+    vec2 drag_target = vec2(0, 0);
+    bool paused = false;
+    bool step_next = false;
+    float gravity_scale = 1.0f;
+    std::vector<body> saved_bodies;
+
+    void run()
+    {
+        using clock = std::chrono::steady_clock;
+        clock::time_point previous = clock::now();
+        float accumulator = 0.0f;
+        while (running.load())
+        {
+            bool changed = false;
+            UiCommand command;
+            while (commands.pop(command))
+            {
+                apply(command);
+                changed = true;
+            }
+
+            // --- Time Stepping (Stable physics with fixed step) ---
+            clock::time_point now = clock::now();
+            accumulator += std::chrono::duration<float>(now - previous).count();
+            previous = now;
+            accumulator = std::min(accumulator, MAX_CATCH_UP_STEPS * fixed_dt);
+            while (accumulator >= fixed_dt)
+            {
+                follow_drag();
+                // Run physics only when not paused, or single-step requested
+                if (!paused || step_next)
+                {
+                    step();
+                    step_next = false;
+                }
+                accumulator -= fixed_dt;
+                changed = true;
+            }
+
+            if (changed)
+                publish();
+            std::this_thread::sleep_for(std::chrono::duration<float>(fixed_dt - accumulator));
+        }
+    }
+
+    void step()
+    {
+        // Apply runtime gravity scaling before the physics step
+        sim_world.gravity_x = gravity.x * gravity_scale;
+        sim_world.gravity_y = gravity.y * gravity_scale;
+        manager.update(sim_world, fixed_dt); // Update physics
+        ++steps;
+        if (reorder_system->reordered_last_update())
+        {
+            const std::vector<int> &remap = reorder_system->last_remap();
+            if (selected_body_index >= 0 && selected_body_index < (int)remap.size())
+                selected_body_index = remap[selected_body_index];
+            if (dragging_idx >= 0 && dragging_idx < (int)remap.size())
+                dragging_idx = remap[dragging_idx];
+        }
+        static bool printed_after_step = false;
+        if (!printed_after_step)
+        {
+            std::cout << "SIM_DEBUG_POST: after first update" << "\n";
+            for (size_t i = 0; i < sim_world.size(); ++i)
+            {
+                std::cout << "SIM_DEBUG_POST: B" << i << " pos=(" << sim_world.position_x[i] << "," << sim_world.position_y[i] << ") ";
+                std::cout << "prev=(" << sim_world.previous_position_x[i] << "," << sim_world.previous_position_y[i] << ") ";
+                std::cout << "vel=(" << sim_world.vel_x[i] << "," << sim_world.vel_y[i] << ")\n";
+            }
+            printed_after_step = true;
+        }
+    }
+
+    // Smoothly move the dragged body towards the mouse
+    void follow_drag()
+    {
+        if (dragging_idx < 0 || dragging_idx >= (int)sim_world.size())
+            return;
+        // lerp factor (0..1) smaller = smoother
+        float lerp_f = 0.25f;
+        vec2 oldpos = sim_world.get_position(dragging_idx);
+        vec2 newpos = oldpos * (1.0f - lerp_f) + drag_target * lerp_f;
+        sim_world.set_position(dragging_idx, newpos);
+        // zero velocity while dragging to avoid physics fighting the drag
+        sim_world.vel_x[dragging_idx] = 0.0f;
+        sim_world.vel_y[dragging_idx] = 0.0f;
+        sim_world.previous_position_x[dragging_idx] = newpos.x;
+        sim_world.previous_position_y[dragging_idx] = newpos.y;
+    }
+
+    int body_at(const vec2 &point) const
+    {
+        float best_dist2 = 1e30f;
+        int best_idx = -1;
+        size_t n = sim_world.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            float dx = sim_world.position_x[i] - point.x;
+            float dy = sim_world.position_y[i] - point.y;
+            float d2 = dx * dx + dy * dy;
+            float r = sim_world.radius[i];
+            if (d2 < best_dist2 && d2 <= (r * r))
+            {
+                best_dist2 = d2;
+                best_idx = (int)i;
+            }
+        }
+        return best_idx;
+    }
+
+    // Keeps the tracked indices on their bodies when bodies a and b trade places
+    void follow_swap(int a, int b)
+    {
+        for (int *tracked : {&selected_body_index, &dragging_idx})
+        {
+            if (*tracked == a)
+                *tracked = b;
+            else if (*tracked == b)
+                *tracked = a;
+        }
+    }
+
+    // Recomputes previous_position from the velocity (Verlet keeps velocity implicit)
+    void sync_previous_position(int idx)
+    {
+        float dt = sim_world.delta_time;
+        if (dt > 0.0f)
+        {
+            sim_world.previous_position_x[idx] = sim_world.position_x[idx] - sim_world.vel_x[idx] * dt;
+            sim_world.previous_position_y[idx] = sim_world.position_y[idx] - sim_world.vel_y[idx] * dt;
+        }
+    }
+
+    void apply(const UiCommand &command)
+    {
+        switch (command.type)
+        {
+        case CommandType::TOGGLE_PAUSE:
+            paused = !paused;
+            break;
+        case CommandType::STEP:
+            if (paused)
+                step_next = true;
+            break;
+        case CommandType::SAVE_SNAPSHOT:
+            save_bodies();
+            break;
+        case CommandType::LOAD_SNAPSHOT:
+            load_bodies();
+            break;
+        case CommandType::SPAWN:
+        {
+            body nb = command.spawn;
+            float dt = sim_world.delta_time;
+            if (dt > 0.0f)
+                nb.previous_position = nb.position - nb.velocity * dt;
+            // A dynamic body takes the first static body's slot, which moves to the end
+            int end = (int)sim_world.size();
+            int idx = (int)sim_world.add_body(nb);
+            if (idx != end)
+                follow_swap(idx, end);
+            break;
+        }
+        case CommandType::GRAB:
+            selected_body_index = body_at(command.point);
+            dragging_idx = selected_body_index;
+            drag_target = command.point;
+            break;
+        case CommandType::DRAG_TO:
+            drag_target = command.point;
+            break;
+        case CommandType::RELEASE:
+            if (dragging_idx >= 0 && dragging_idx < (int)sim_world.size())
+            {
+                sim_world.vel_x[dragging_idx] = command.point.x;
+                sim_world.vel_y[dragging_idx] = command.point.y;
+                sync_previous_position(dragging_idx);
+            }
+            dragging_idx = -1;
+            break;
+        case CommandType::EDIT_SELECTED:
+            edit_selected(command.property, command.amount);
+            break;
+        case CommandType::REMOVE_SELECTED:
+            if (selected_body_index >= 0 && selected_body_index < (int)sim_world.size())
+            {
+                // remove_body moves other bodies into the hole
+                sim_world.remove_body(selected_body_index);
+                selected_body_index = -1;
+                dragging_idx = -1;
+            }
+            break;
+        case CommandType::NUDGE_GLOBAL_DAMPING:
+            sim_world.global_damping = std::min(0.5f, std::max(0.0f, sim_world.global_damping + command.amount));
+            break;
+        case CommandType::NUDGE_GRAVITY_SCALE:
+            gravity_scale = std::max(0.0f, gravity_scale + command.amount);
+            break;
+        }
+    }
+
+    void edit_selected(BodyProperty property, float amount)
+    {
+        int idx = selected_body_index;
+        if (idx < 0 || idx >= (int)sim_world.size())
+            return;
+        switch (property)
+        {
+        case BodyProperty::MASS:
+        {
+            // set_mass recomputes inv_mass and moves the body to the other
+            // range when it becomes static or dynamic
+            int moved = (int)sim_world.set_mass(idx, std::max(0.0f, sim_world.mass[idx] + amount));
+            if (moved != idx)
+                follow_swap(idx, moved);
+            idx = selected_body_index;
+            break;
+        }
+        case BodyProperty::RESTITUTION:
+            sim_world.restitution[idx] = std::min(1.0f, std::max(0.0f, sim_world.restitution[idx] + amount));
+            break;
+        case BodyProperty::RADIUS:
+            sim_world.radius[idx] = std::max(0.1f, sim_world.radius[idx] + amount);
+            break;
+        case BodyProperty::DAMPING:
+            sim_world.damping[idx] = std::max(0.0f, sim_world.damping[idx] + amount);
+            break;
+        case BodyProperty::FRICTION:
+            sim_world.friction[idx] = std::max(0.0f, sim_world.friction[idx] + amount);
+            break;
+        }
+        sync_previous_position(idx);
+    }
+
+    // Copy current state by building an in-memory snapshot from SoA arrays
+    void save_bodies()
+    {
+        size_t n = sim_world.size();
+        saved_bodies.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            saved_bodies[i].position = sim_world.get_position(i);
+            saved_bodies[i].previous_position = vec2(sim_world.previous_position_x[i], sim_world.previous_position_y[i]);
+            saved_bodies[i].velocity = vec2(sim_world.vel_x[i], sim_world.vel_y[i]);
+            saved_bodies[i].acceleration = vec2(sim_world.acc_x[i], sim_world.acc_y[i]);
+            saved_bodies[i].mass = sim_world.mass[i];
+            saved_bodies[i].inv_mass = sim_world.inv_mass[i];
+            saved_bodies[i].radius = sim_world.radius[i];
+            saved_bodies[i].damping = sim_world.damping[i];
+            saved_bodies[i].friction = sim_world.friction[i];
+            saved_bodies[i].restitution = sim_world.restitution[i];
+        }
+    }
+
+    void load_bodies()
+    {
+        if (saved_bodies.empty())
+            return;
+        // Restore by clearing and re-adding bodies (simple approach)
+        // Note: this keeps other per-world state (grid bounds)
+        // but resets per-particle SoA arrays to snapshot values.
+        sim_world.clear_bodies();
+        for (body b : saved_bodies)
+        {
+            b.inv_mass = (b.mass > 0.0f) ? 1.0f / b.mass : 0.0f;
+            float dt = sim_world.delta_time;
+            if (dt > 0.0f)
+                b.previous_position = b.position - b.velocity * dt;
+            sim_world.add_body(b);
+        }
+        selected_body_index = -1;
+        dragging_idx = -1;
+    }
+
+    // Copies what the renderer draws into the back buffer and hands it over.
+    // assign() reuses the buffer's capacity, so steady frames do not allocate.
+    void publish()
+    {
+        RenderSnapshot &out = frames.write_buffer();
+        out.step = steps;
+        out.position_x.assign(sim_world.position_x.begin(), sim_world.position_x.end());
+        out.position_y.assign(sim_world.position_y.begin(), sim_world.position_y.end());
+        out.radius.assign(sim_world.radius.begin(), sim_world.radius.end());
+        out.mass.assign(sim_world.mass.begin(), sim_world.mass.end());
+        out.inv_mass.assign(sim_world.inv_mass.begin(), sim_world.inv_mass.end());
+        out.selected = (selected_body_index < (int)sim_world.size()) ? selected_body_index : -1;
+        if (out.selected >= 0)
+        {
+            out.selected_restitution = sim_world.get_restitution(out.selected);
+            out.selected_damping = sim_world.get_damping(out.selected);
+            out.selected_friction = sim_world.get_friction(out.selected);
+        }
+        out.gravity_y = gravity.y * gravity_scale;
+        out.global_damping = sim_world.global_damping;
+        out.paused = paused;
+        frames.publish();
+    }
+};
+
 // ====================================================================
 // --- MAIN LOOP ---
 // ====================================================================
@@ -124,287 +568,119 @@ int main()
     sim_world.grid_info.min_y = vis_min_y;
     sim_world.grid_info.max_y = vis_max_y;
 
-    // Recompute grid sizes and resize grid storage (same logic as in world constructor)
-    {
-        float width = sim_world.grid_info.max_x - sim_world.grid_info.min_x;
-        float height = sim_world.grid_info.max_y - sim_world.grid_info.min_y;
-        int numCellsX = static_cast<int>(std::ceil(width / sim_world.grid_info.cell_size));
-        int numCellsY = static_cast<int>(std::ceil(height / sim_world.grid_info.cell_size));
-        sim_world.grid_info.num_cells_x = numCellsX;
-        sim_world.grid_info.num_cells_y = numCellsY;
-        int totalCells = std::max(1, numCellsX * numCellsY);
-        sim_world.grid.clear();
-        sim_world.grid.resize(totalCells);
-    }
+    // Recompute grid sizes and resize grid storage for the new bounds
+    sim_world.update_grid_dimensions();
 
     // Note: previous_position was already initialized in the initial bodies vector before
     // constructing `sim_world` so the SoA previous_position arrays are correct.
 
-    // Systems setup
-    systemManager manager;
-    manager.addSystem(std::make_unique<movementSystem>());
-    manager.addSystem(std::make_unique<collisionSystem>());
-
-    float accumulator = 0.0f;
-    // --- Selection and on-screen UI ---
-    int selected_body_index = -1;
-    auto select_body_at_screen = [&](int mx, int my) -> int
+    // The simulation thread owns the world (and its systems) from here on
+    simulationThread simulation(std::move(sim_world), gravity, fixed_dt);
+    simulation.start();
+    auto send = [&](const UiCommand &command)
     {
-        // Convert screen to world
-        float wx = (mx - center_x) / world_scale;
-        float wy = (center_y - my) / world_scale;
-        vec2 click_world(wx, wy);
-
-        float best_dist2 = 1e30f;
-        int best_idx = -1;
-        size_t n = sim_world.size();
-        for (size_t i = 0; i < n; ++i)
-        {
-            float px = sim_world.position_x[i];
-            float py = sim_world.position_y[i];
-            float r = (i < sim_world.radius.size()) ? sim_world.radius[i] : 0.0f;
-            float dx = px - click_world.x;
-            float dy = py - click_world.y;
-            float d2 = dx * dx + dy * dy;
-            if (d2 < best_dist2 && d2 <= (r * r))
-            {
-                best_dist2 = d2;
-                best_idx = (int)i;
-            }
-        }
-        return best_idx;
+        if (!simulation.send(command))
+            std::cout << "UI: simulation is behind, edit dropped\n";
+    };
+    auto send_type = [&](CommandType type, float amount = 0.0f)
+    {
+        UiCommand command;
+        command.type = type;
+        command.amount = amount;
+        send(command);
+    };
+    auto send_point = [&](CommandType type, const vec2 &point)
+    {
+        UiCommand command;
+        command.type = type;
+        command.point = point;
+        send(command);
+    };
+    auto send_edit = [&](BodyProperty property, float amount)
+    {
+        UiCommand command;
+        command.type = CommandType::EDIT_SELECTED;
+        command.property = property;
+        command.amount = amount;
+        send(command);
     };
 
     // --- Drag / Spawn state ---
-    static bool dragging = false;
-    static int dragging_idx = -1;
+    bool dragging = false;
     // ring buffer of last mouse positions (world coords) to compute throw velocity
-    static vec2 mouse_history[8];
-    static int mouse_history_idx = 0;
-    static int mouse_history_count = 0;
-    vec2 last_mouse_world = vec2(0, 0);
+    vec2 mouse_history[8];
+    int mouse_history_idx = 0;
+    int mouse_history_count = 0;
 
     // Spawn parameters (modifiable with keys)
-    static float spawn_mass = 1.0f;
-    static float spawn_radius = 2.0f;
-    static float spawn_restitution = 0.8f;
-    static float spawn_damping = 0.0f;
-    static float spawn_friction = 0.0f;
-    // Runtime tuning: global damping and gravity scale
-    static float gravity_scale = 1.0f;
+    float spawn_mass = 1.0f;
+    float spawn_radius = 2.0f;
+    float spawn_restitution = 0.8f;
+    float spawn_damping = 0.0f;
+    float spawn_friction = 0.0f;
+    // Runtime tuning (applied on the simulation thread):
     // Keys: '[' decrease damping, ']' increase damping
     //       ',' decrease gravity, '.' increase gravity
     // colors removed - rendering will use fixed colors (BLUE for dynamic, RED for static)
 
-    // Other code continues...
-
-    // --- 3. Main render and simulation loop ---
+    // --- 3. Main render loop (the simulation steps on its own thread) ---
     while (!WindowShouldClose())
     {
+        // Latest complete simulation frame (the previous one if none arrived since)
+        simulation.acquire_frame();
+        const RenderSnapshot &frame = simulation.frame();
 
-        // --- A. Time Stepping (Stable physics with fixed step) ---
-        accumulator += GetFrameTime();
-
-        // --- Pause/step/snapshot controls ---
-        static bool paused = false;
-        static bool step_next = false;
-        static std::vector<body> snapshot;
-
+        // --- A. Pause/step/snapshot controls ---
         if (IsKeyPressed(KEY_P))
-        {
-            paused = !paused;
-        }
+            send_type(CommandType::TOGGLE_PAUSE);
         if (IsKeyPressed(KEY_N))
-        {
-            // single step
-            if (paused)
-                step_next = true;
-        }
+            send_type(CommandType::STEP);
         if (IsKeyPressed(KEY_O))
-        {
-            // copy current state by building an in-memory snapshot from SoA arrays
-            snapshot.clear();
-            size_t n = sim_world.size();
-            snapshot.resize(n);
-            for (size_t i = 0; i < n; ++i)
-            {
-                snapshot[i].position = sim_world.get_position(i);
-                snapshot[i].previous_position = vec2(sim_world.previous_position_x[i], sim_world.previous_position_y[i]);
-                snapshot[i].velocity = vec2(sim_world.vel_x[i], sim_world.vel_y[i]);
-                snapshot[i].acceleration = vec2(sim_world.acc_x[i], sim_world.acc_y[i]);
-                snapshot[i].mass = (i < sim_world.mass.size()) ? sim_world.mass[i] : 0.0f;
-                snapshot[i].inv_mass = (i < sim_world.inv_mass.size()) ? sim_world.inv_mass[i] : 0.0f;
-                snapshot[i].radius = (i < sim_world.radius.size()) ? sim_world.radius[i] : 0.0f;
-                snapshot[i].damping = (i < sim_world.damping.size()) ? sim_world.damping[i] : 0.0f;
-                snapshot[i].friction = (i < sim_world.friction.size()) ? sim_world.friction[i] : 0.0f;
-                snapshot[i].restitution = (i < sim_world.restitution.size()) ? sim_world.restitution[i] : 1.0f;
-            }
-        }
+            send_type(CommandType::SAVE_SNAPSHOT);
         if (IsKeyPressed(KEY_L))
-        {
-            if (!snapshot.empty())
-            {
-                // prepare snapshot: recompute inv_mass and previous_position before restoring
-                for (auto &b : snapshot)
-                {
-                    b.inv_mass = (b.mass > 0.0f) ? 1.0f / b.mass : 0.0f;
-                    float dt = sim_world.delta_time;
-                    if (dt > 0.0f)
-                        b.previous_position = b.position - b.velocity * dt;
-                }
-                // Restore by clearing and re-adding bodies (simple approach)
-                // Note: this keeps other per-world state (grid bounds)
-                // but resets per-particle SoA arrays to snapshot values.
-                sim_world.position_x.clear();
-                sim_world.position_y.clear();
-                sim_world.previous_position_x.clear();
-                sim_world.previous_position_y.clear();
-                sim_world.vel_x.clear();
-                sim_world.vel_y.clear();
-                sim_world.acc_x.clear();
-                sim_world.acc_y.clear();
-                sim_world.mass.clear();
-                sim_world.inv_mass.clear();
-                sim_world.radius.clear();
-                sim_world.damping.clear();
-                sim_world.friction.clear();
-                sim_world.restitution.clear();
-                for (auto &b : snapshot)
-                {
-                    sim_world.add_body(b);
-                }
-            }
-        }
-
-        // Run physics only when not paused, or single-step requested
-        while (accumulator >= fixed_dt)
-        {
-            if (!paused || step_next)
-            {
-                // Apply runtime gravity scaling before the physics step
-                sim_world.gravity_x = gravity.x * gravity_scale;
-                sim_world.gravity_y = gravity.y * gravity_scale;
-                manager.update(sim_world, fixed_dt); // Update physics
-                static bool printed_after_step = false;
-                if (!printed_after_step)
-                {
-                    std::cout << "SIM_DEBUG_POST: after first update" << "\n";
-                    for (size_t i = 0; i < sim_world.size(); ++i)
-                    {
-                        std::cout << "SIM_DEBUG_POST: B" << i << " pos=(" << sim_world.position_x[i] << "," << sim_world.position_y[i] << ") ";
-                        std::cout << "prev=(" << sim_world.previous_position_x[i] << "," << sim_world.previous_position_y[i] << ") ";
-                        std::cout << "vel=(" << sim_world.vel_x[i] << "," << sim_world.vel_y[i] << ")\n";
-                    }
-                    printed_after_step = true;
-                }
-                step_next = false;
-            }
-            accumulator -= fixed_dt;
-            if (paused)
-                break; // when paused, only run one step per keypress
-        }
-
-        // boundary clamping removed: collisionSystem now handles wall/ground bounces
-
-        // Smoothly move selected/dragged body towards mouse while dragging
-        if (dragging && dragging_idx >= 0 && dragging_idx < (int)sim_world.size())
-        {
-            // Update position: set_position updates SoA arrays.
-            // For velocity/previous_position we update the internal arrays directly.
-            // Acquire new position below and assign via set_position.
-            // latest mouse world
-            vec2 latest_mouse = mouse_history[(mouse_history_idx - 1 + 8) % 8];
-            // lerp factor (0..1) smaller = smoother
-            float lerp_f = 0.25f;
-            vec2 oldpos = sim_world.get_position(dragging_idx);
-            vec2 newpos = oldpos * (1.0f - lerp_f) + latest_mouse * lerp_f;
-            sim_world.set_position(dragging_idx, newpos);
-            // zero velocity while dragging to avoid physics fighting the drag
-            sim_world.vel_x[dragging_idx] = 0.0f;
-            sim_world.vel_y[dragging_idx] = 0.0f;
-            float dt = sim_world.delta_time;
-            if (dt > 0.0f)
-            {
-                sim_world.previous_position_x[dragging_idx] = newpos.x - 0.0f * dt;
-                sim_world.previous_position_y[dragging_idx] = newpos.y - 0.0f * dt;
-            }
-        }
+            send_type(CommandType::LOAD_SNAPSHOT);
 
         // --- INPUT: Drag / Spawn / Selection and property modification ---
-        // Drag start (smooth)
-
+        // Pressing selects the body under the mouse and starts dragging it;
+        // the simulation thread picks it against its current state
         if (IsMouseButtonDown(MOUSE_LEFT_BUTTON))
         {
-            if (!dragging)
-            {
-                int mx = GetMouseX();
-                int my = GetMouseY();
-                int idx = select_body_at_screen(mx, my);
-                if (idx >= 0)
-                {
-                    dragging = true;
-                    dragging_idx = idx;
-                }
-            }
-            int mx = GetMouseX();
-            int my = GetMouseY();
-            float wx = (mx - center_x) / world_scale;
-            float wy = (center_y - my) / world_scale;
+            vec2 mouse_world = ScreenToWorld(GetMouseX(), GetMouseY());
+            send_point(dragging ? CommandType::DRAG_TO : CommandType::GRAB, mouse_world);
+            dragging = true;
             // push into history
-            mouse_history[mouse_history_idx] = vec2(wx, wy);
+            mouse_history[mouse_history_idx] = mouse_world;
             mouse_history_idx = (mouse_history_idx + 1) % 8;
             mouse_history_count = std::min(mouse_history_count + 1, 8);
         }
 
-        if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON))
+        if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON) && dragging)
         {
-            if (dragging && dragging_idx >= 0 && dragging_idx < (int)sim_world.size())
+            // compute average mouse velocity from history
+            vec2 throw_vel(0, 0);
+            if (mouse_history_count >= 2)
             {
-                // Update velocity on release. We update the SoA velocity and previous_position arrays
-                // and keep internal SoA arrays updated.
-                // compute average mouse velocity from history
-                if (mouse_history_count >= 2)
-                {
-                    int oldest = (mouse_history_idx - mouse_history_count + 8) % 8;
-                    vec2 oldest_pos = mouse_history[oldest];
-                    vec2 newest_pos = mouse_history[(mouse_history_idx - 1 + 8) % 8];
-                    vec2 delta = newest_pos - oldest_pos;
-                    float dt_total = (float)mouse_history_count * (1.0f / 60.0f); // approximate frame dt
-                    vec2 mouse_vel = (dt_total > 0.0f) ? delta * (1.0f / dt_total) : vec2(0, 0);
-                    // apply a scaled down version as throw velocity
-                    sim_world.vel_x[dragging_idx] = (mouse_vel * 0.5f).x;
-                    sim_world.vel_y[dragging_idx] = (mouse_vel * 0.5f).y;
-                }
-                else
-                {
-                    // fallback: small nudge
-                    sim_world.vel_x[dragging_idx] = 0.0f;
-                    sim_world.vel_y[dragging_idx] = 0.0f;
-                }
-                float dt = sim_world.delta_time;
-                if (dt > 0.0f)
-                {
-                    vec2 pos = sim_world.get_position(dragging_idx);
-                    sim_world.previous_position_x[dragging_idx] = pos.x - sim_world.vel_x[dragging_idx] * dt;
-                    sim_world.previous_position_y[dragging_idx] = pos.y - sim_world.vel_y[dragging_idx] * dt;
-                }
+                int oldest = (mouse_history_idx - mouse_history_count + 8) % 8;
+                vec2 oldest_pos = mouse_history[oldest];
+                vec2 newest_pos = mouse_history[(mouse_history_idx - 1 + 8) % 8];
+                vec2 delta = newest_pos - oldest_pos;
+                float dt_total = (float)mouse_history_count * (1.0f / 60.0f); // approximate frame dt
+                vec2 mouse_vel = (dt_total > 0.0f) ? delta * (1.0f / dt_total) : vec2(0, 0);
+                // apply a scaled down version as throw velocity
+                throw_vel = mouse_vel * 0.5f;
             }
+            send_point(CommandType::RELEASE, throw_vel);
             dragging = false;
-            dragging_idx = -1;
         }
 
         // Spawn new body with SPACE (at mouse)
         if (IsKeyPressed(KEY_SPACE))
         {
-            int mx = GetMouseX();
-            int my = GetMouseY();
-            float wx = (mx - center_x) / world_scale;
-            float wy = (center_y - my) / world_scale;
-            body nb = create_body(wx, wy, 0.0f, 0.0f, spawn_mass, spawn_radius, spawn_restitution, spawn_damping, spawn_friction);
-            float dt = sim_world.delta_time;
-            if (dt > 0.0f)
-                nb.previous_position = nb.position - nb.velocity * dt;
-            sim_world.add_body(nb);
+            vec2 mouse_world = ScreenToWorld(GetMouseX(), GetMouseY());
+            UiCommand command;
+            command.type = CommandType::SPAWN;
+            command.spawn = create_body(mouse_world.x, mouse_world.y, 0.0f, 0.0f, spawn_mass, spawn_radius, spawn_restitution, spawn_damping, spawn_friction);
+            send(command);
         }
 
         // Spawn parameter keys: 1/2 mass, 3/4 restitution, 5/6 radius
@@ -422,14 +698,14 @@ int main()
             spawn_radius += 0.1f;
         // Tweak global damping
         if (IsKeyPressed(KEY_LEFT_BRACKET))
-            sim_world.global_damping = std::max(0.0f, sim_world.global_damping - 0.005f);
+            send_type(CommandType::NUDGE_GLOBAL_DAMPING, -0.005f);
         if (IsKeyPressed(KEY_RIGHT_BRACKET))
-            sim_world.global_damping = std::min(0.5f, sim_world.global_damping + 0.005f);
+            send_type(CommandType::NUDGE_GLOBAL_DAMPING, 0.005f);
         // Tweak gravity scale
         if (IsKeyPressed(KEY_COMMA))
-            gravity_scale = std::max(0.0f, gravity_scale - 0.05f);
+            send_type(CommandType::NUDGE_GRAVITY_SCALE, -0.05f);
         if (IsKeyPressed(KEY_PERIOD))
-            gravity_scale += 0.05f;
+            send_type(CommandType::NUDGE_GRAVITY_SCALE, 0.05f);
         // Spawn damping/friction keys: 7/8 damping -, + ; 9/0 friction -, +
         if (IsKeyPressed(KEY_SEVEN))
             spawn_damping = std::max(0.0f, spawn_damping - 0.05f);
@@ -441,102 +717,36 @@ int main()
             spawn_friction += 0.05f;
         // color controls removed
 
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
-        {
-            int mx = GetMouseX();
-            int my = GetMouseY();
-            int idx = select_body_at_screen(mx, my);
-            selected_body_index = idx;
-        }
-
-        if (selected_body_index >= 0 && selected_body_index < (int)sim_world.size())
+        if (frame.selected >= 0)
         {
-            bool changed = false;
-
             // Adjustments: M/B mass +/-, R/T restitution +/-, S/A radius +/-
             if (IsKeyPressed(KEY_M))
-            {
-                sim_world.mass[selected_body_index] += 0.1f;
-                changed = true;
-            }
+                send_edit(BodyProperty::MASS, 0.1f);
             if (IsKeyPressed(KEY_B)) // alternative for lowercase b
-            {
-                sim_world.mass[selected_body_index] = std::max(0.0f, sim_world.mass[selected_body_index] - 0.1f);
-                changed = true;
-            }
+                send_edit(BodyProperty::MASS, -0.1f);
             if (IsKeyPressed(KEY_R))
-            {
-                if (selected_body_index < sim_world.restitution.size())
-                    sim_world.restitution[selected_body_index] = std::min(1.0f, sim_world.restitution[selected_body_index] + 0.05f);
-                changed = true;
-            }
+                send_edit(BodyProperty::RESTITUTION, 0.05f);
             if (IsKeyPressed(KEY_T)) // alternative for decreasing restitution
-            {
-                if (selected_body_index < sim_world.restitution.size())
-                    sim_world.restitution[selected_body_index] = std::max(0.0f, sim_world.restitution[selected_body_index] - 0.05f);
-                changed = true;
-            }
+                send_edit(BodyProperty::RESTITUTION, -0.05f);
             if (IsKeyPressed(KEY_S))
-            {
-                sim_world.radius[selected_body_index] = sim_world.radius[selected_body_index] + 0.1f;
-                changed = true;
-            }
+                send_edit(BodyProperty::RADIUS, 0.1f);
             if (IsKeyPressed(KEY_A)) // alternative for decreasing radius
-            {
-                sim_world.radius[selected_body_index] = std::max(0.1f, sim_world.radius[selected_body_index] - 0.1f);
-                changed = true;
-            }
+                send_edit(BodyProperty::RADIUS, -0.1f);
 
-            // Damping adjustments: Y increase, U decrease
+            // Damping adjustments: Y decrease, U increase
             if (IsKeyPressed(KEY_Y))
-            {
-                if (selected_body_index < sim_world.damping.size())
-                    sim_world.damping[selected_body_index] = std::max(0.0f, sim_world.damping[selected_body_index] - 0.01f);
-                changed = true;
-            }
+                send_edit(BodyProperty::DAMPING, -0.01f);
             if (IsKeyPressed(KEY_U))
-            {
-                if (selected_body_index < sim_world.damping.size())
-                    sim_world.damping[selected_body_index] += 0.01f;
-                changed = true;
-            }
-            // Friction adjustments: G increase, H decrease
+                send_edit(BodyProperty::DAMPING, 0.01f);
+            // Friction adjustments: G decrease, H increase
             if (IsKeyPressed(KEY_G))
-            {
-                if (selected_body_index < sim_world.friction.size())
-                    sim_world.friction[selected_body_index] = std::max(0.0f, sim_world.friction[selected_body_index] - 0.01f);
-                changed = true;
-            }
+                send_edit(BodyProperty::FRICTION, -0.01f);
             if (IsKeyPressed(KEY_H))
-            {
-                if (selected_body_index < sim_world.friction.size())
-                    sim_world.friction[selected_body_index] += 0.01f;
-                changed = true;
-            }
+                send_edit(BodyProperty::FRICTION, 0.01f);
 
             // Delete selected body (DEL or X)
             if (IsKeyPressed(KEY_X) || IsKeyPressed(KEY_DELETE))
-            {
-                sim_world.remove_body(selected_body_index);
-                selected_body_index = -1;
-                continue; // skip further handling for this frame
-            }
-
-            if (changed)
-            {
-                // Recompute inv_mass and synchronize previous_position in SoA arrays
-                float massVal = sim_world.mass[selected_body_index];
-                sim_world.inv_mass[selected_body_index] = (massVal > 0.0f) ? 1.0f / massVal : 0.0f;
-                float dt = sim_world.delta_time;
-                if (dt > 0.0f)
-                {
-                    float vx = sim_world.vel_x[selected_body_index];
-                    float vy = sim_world.vel_y[selected_body_index];
-                    sim_world.previous_position_x[selected_body_index] = sim_world.position_x[selected_body_index] - vx * dt;
-                    sim_world.previous_position_y[selected_body_index] = sim_world.position_y[selected_body_index] - vy * dt;
-                }
-                // SoA arrays are canonical. If UI changed SoA arrays above, they are ready.
-            }
+                send_type(CommandType::REMOVE_SELECTED);
         }
 
         // --- B. Rendering (Visualization) ---
@@ -550,14 +760,14 @@ int main()
         DrawText("Ground (Y = 0.0m)", 10, (int)ground_screen_pos.y - 20, 20, WHITE);
 
         // 2. Draw bodies (and labels)
-        for (size_t i = 0; i < sim_world.size(); ++i)
+        for (size_t i = 0; i < frame.position_x.size(); ++i)
         {
-            vec2 pos(sim_world.position_x[i], sim_world.position_y[i]);
-            int screen_radius = (int)(sim_world.radius[i] * world_scale);
+            vec2 pos(frame.position_x[i], frame.position_y[i]);
+            int screen_radius = (int)(frame.radius[i] * world_scale);
             vec2 screen_pos = WorldToScreen(pos);
 
             // Use fixed color per-body type: static=RED, dynamic=BLUE
-            Color draw_color = (sim_world.inv_mass[i] == 0.0f) ? RED : BLUE;
+            Color draw_color = (frame.inv_mass[i] == 0.0f) ? RED : BLUE;
 
             // Draw main circle
             DrawCircle((int)screen_pos.x, (int)screen_pos.y, screen_radius, draw_color);
@@ -565,11 +775,10 @@ int main()
             DrawCircleLines((int)screen_pos.x, (int)screen_pos.y, screen_radius, BLACK);
 
             // Label with id and mass above the body
-            float mass = (i < sim_world.mass.size()) ? sim_world.mass[i] : 0.0f;
-            DrawText(TextFormat("#%d m:%.2f", (int)i, mass), (int)screen_pos.x - screen_radius, (int)screen_pos.y - screen_radius - 18, 12, WHITE);
+            DrawText(TextFormat("#%d m:%.2f", (int)i, frame.mass[i]), (int)screen_pos.x - screen_radius, (int)screen_pos.y - screen_radius - 18, 12, WHITE);
 
             // Highlight if selected
-            if ((int)i == selected_body_index)
+            if ((int)i == frame.selected)
             {
                 DrawCircleLines((int)screen_pos.x, (int)screen_pos.y, screen_radius + 4, YELLOW);
                 // Mark with small label
@@ -578,7 +787,7 @@ int main()
         }
 
         // If none selected, show brief help
-        if (selected_body_index < 0)
+        if (frame.selected < 0)
         {
             DrawText("Click a body to select it. Keys: M/B mass +/-, R/T restitution +/-, S/A radius +/-", 10, screen_height - 24, 14, LIGHTGRAY);
         }
@@ -590,11 +799,11 @@ int main()
         // Primary HUD lines
         DrawFPS(hud_x, hud_y);
         hud_y += hud_line_h;
-        DrawText("Fixed DT: 1/60s", hud_x, hud_y, 16, WHITE);
+        DrawText(TextFormat("Fixed DT: 1/60s  Physics step: %llu%s", frame.step, frame.paused ? " (paused)" : ""), hud_x, hud_y, 16, WHITE);
         hud_y += hud_line_h;
-        DrawText(TextFormat("Gravity: %.2fm/s^2 (use , . to +/-)", sim_world.gravity_y * gravity_scale), hud_x, hud_y, 16, WHITE);
+        DrawText(TextFormat("Gravity: %.2fm/s^2 (use , . to +/-)", frame.gravity_y), hud_x, hud_y, 16, WHITE);
         hud_y += hud_line_h;
-        DrawText(TextFormat("Global damping: %.4f (use [ ] to +/-)", sim_world.global_damping), hud_x, hud_y, 16, WHITE);
+        DrawText(TextFormat("Global damping: %.4f (use [ ] to +/-)", frame.global_damping), hud_x, hud_y, 16, WHITE);
         hud_y += hud_line_h;
         DrawText("P: Pause/Resume  N: Step (when paused)", hud_x, hud_y, 14, LIGHTGRAY);
         hud_y += hud_line_h;
@@ -602,26 +811,19 @@ int main()
         hud_y += hud_line_h;
 
         // 4. Properties panel (if selected)
-        if (selected_body_index >= 0 && selected_body_index < (int)sim_world.size())
+        if (frame.selected >= 0)
         {
-            // Read properties from SoA arrays
-            float sel_mass = (selected_body_index < sim_world.mass.size()) ? sim_world.mass[selected_body_index] : 0.0f;
-            float sel_inv_mass = (selected_body_index < sim_world.inv_mass.size()) ? sim_world.inv_mass[selected_body_index] : 0.0f;
-            float sel_radius = (selected_body_index < sim_world.radius.size()) ? sim_world.radius[selected_body_index] : 0.0f;
-            // Prefer SoA values.
-            float sel_restitution = sim_world.get_restitution(selected_body_index);
-            float sel_damping = sim_world.get_damping(selected_body_index);
-            float sel_friction = sim_world.get_friction(selected_body_index);
+            int sel = frame.selected;
             int panel_x = screen_width - 260;
             int panel_y = 10;
             DrawRectangle(panel_x - 10, panel_y - 10, 250, 140, Fade(BLACK, 0.6f));
-            DrawText(TextFormat("Selected: %d", selected_body_index), panel_x, panel_y, 18, YELLOW);
-            DrawText(TextFormat("Mass: %.2f", sel_mass), panel_x, panel_y + 24, 16, WHITE);
-            DrawText(TextFormat("InvMass: %.4f", sel_inv_mass), panel_x, panel_y + 44, 16, WHITE);
-            DrawText(TextFormat("Radius: %.2f m", sel_radius), panel_x, panel_y + 64, 16, WHITE);
-            DrawText(TextFormat("Restitution: %.2f", sel_restitution), panel_x, panel_y + 84, 16, WHITE);
-            DrawText(TextFormat("Damping: %.2f", sel_damping), panel_x, panel_y + 104, 14, WHITE);
-            DrawText(TextFormat("Friction: %.2f", sel_friction), panel_x, panel_y + 124, 14, WHITE);
+            DrawText(TextFormat("Selected: %d", sel), panel_x, panel_y, 18, YELLOW);
+            DrawText(TextFormat("Mass: %.2f", frame.mass[sel]), panel_x, panel_y + 24, 16, WHITE);
+            DrawText(TextFormat("InvMass: %.4f", frame.inv_mass[sel]), panel_x, panel_y + 44, 16, WHITE);
+            DrawText(TextFormat("Radius: %.2f m", frame.radius[sel]), panel_x, panel_y + 64, 16, WHITE);
+            DrawText(TextFormat("Restitution: %.2f", frame.selected_restitution), panel_x, panel_y + 84, 16, WHITE);
+            DrawText(TextFormat("Damping: %.2f", frame.selected_damping), panel_x, panel_y + 104, 14, WHITE);
+            DrawText(TextFormat("Friction: %.2f", frame.selected_friction), panel_x, panel_y + 124, 14, WHITE);
             DrawText("Keys: M/B mass +/-, R/T restitution +/-, S/A radius +/-, Y/U damping, G/H friction", panel_x, panel_y + 144, 10, LIGHTGRAY);
         }
 
@@ -634,6 +836,7 @@ int main()
     }
 
     // --- 4. Resource cleanup ---
+    simulation.stop();
     CloseWindow();
     return 0;
-}
\ No newline at end of file
+}
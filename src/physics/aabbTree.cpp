@@ -0,0 +1,313 @@
+#include "physics/aabbTree.hpp"
+
+// Displacement multiplier used to extend fat AABBs in the direction of motion
+const float AABB_DISPLACEMENT_MULTIPLIER = 2.0f;
+
+aabbTree::aabbTree() {}
+
+void aabbTree::clear()
+{
+    nodes.clear();
+    root = NULL_NODE;
+    free_list = NULL_NODE;
+    proxy_count = 0;
+}
+
+// ====================================================================
+// --- NODE POOL ---
+// ====================================================================
+
+int aabbTree::allocate_node()
+{
+    if (free_list == NULL_NODE)
+    {
+        nodes.emplace_back();
+        return (int)nodes.size() - 1;
+    }
+    int node_id = free_list;
+    free_list = nodes[node_id].parent;
+    nodes[node_id] = Node();
+    return node_id;
+}
+
+void aabbTree::free_node(int node_id)
+{
+    nodes[node_id].parent = free_list;
+    nodes[node_id].height = -1;
+    free_list = node_id;
+}
+
+// ====================================================================
+// --- PROXIES ---
+// ====================================================================
+
+static AABB fatten(const AABB &tight, float margin)
+{
+    AABB fat;
+    fat.min_x = tight.min_x - margin;
+    fat.min_y = tight.min_y - margin;
+    fat.max_x = tight.max_x + margin;
+    fat.max_y = tight.max_y + margin;
+    return fat;
+}
+
+int aabbTree::create_proxy(const AABB &tight, int user_data, float margin)
+{
+    int proxy = allocate_node();
+    nodes[proxy].box = fatten(tight, margin);
+    nodes[proxy].user_data = user_data;
+    nodes[proxy].height = 0;
+    insert_leaf(proxy);
+    ++proxy_count;
+    return proxy;
+}
+
+void aabbTree::destroy_proxy(int proxy)
+{
+    remove_leaf(proxy);
+    free_node(proxy);
+    --proxy_count;
+}
+
+bool aabbTree::move_proxy(int proxy, const AABB &tight, float margin, float displacement_x, float displacement_y)
+{
+    AABB fat = fatten(tight, margin);
+
+    // Predict motion: stretch the fat box along the displacement
+    float dx = AABB_DISPLACEMENT_MULTIPLIER * displacement_x;
+    float dy = AABB_DISPLACEMENT_MULTIPLIER * displacement_y;
+    if (dx < 0.0f)
+        fat.min_x += dx;
+    else
+        fat.max_x += dx;
+    if (dy < 0.0f)
+        fat.min_y += dy;
+    else
+        fat.max_y += dy;
+
+    const AABB &tree_box = nodes[proxy].box;
+    if (aabb_contains(tree_box, tight))
+    {
+        // Still enclosed. Only reinsert if the stored box became much larger than
+        // needed (e.g. a fast body slowed down), since it would produce extra pairs.
+        AABB huge = fatten(fat, 4.0f * margin);
+        if (aabb_contains(huge, tree_box))
+            return false;
+    }
+
+    remove_leaf(proxy);
+    nodes[proxy].box = fat;
+    insert_leaf(proxy);
+    return true;
+}
+
+// ====================================================================
+// --- INSERTION / REMOVAL ---
+// ====================================================================
+
+void aabbTree::insert_leaf(int leaf)
+{
+    if (root == NULL_NODE)
+    {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    // 1. Find the best sibling by descending along the cheapest perimeter increase
+    AABB leaf_box = nodes[leaf].box;
+    int index = root;
+    while (!nodes[index].is_leaf())
+    {
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+
+        float area = aabb_perimeter(nodes[index].box);
+        float combined_area = aabb_perimeter(aabb_union(nodes[index].box, leaf_box));
+
+        // Cost of creating a new parent for this node and the new leaf
+        float cost = 2.0f * combined_area;
+        // Minimum cost of pushing the leaf further down the tree
+        float inheritance_cost = 2.0f * (combined_area - area);
+
+        auto descend_cost = [&](int child)
+        {
+            float new_area = aabb_perimeter(aabb_union(leaf_box, nodes[child].box));
+            if (nodes[child].is_leaf())
+                return new_area + inheritance_cost;
+            return (new_area - aabb_perimeter(nodes[child].box)) + inheritance_cost;
+        };
+        float cost1 = descend_cost(child1);
+        float cost2 = descend_cost(child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = (cost1 < cost2) ? child1 : child2;
+    }
+    int sibling = index;
+
+    // 2. Create a new parent for the sibling and the leaf
+    int old_parent = nodes[sibling].parent;
+    int new_parent = allocate_node();
+    nodes[new_parent].parent = old_parent;
+    nodes[new_parent].box = aabb_union(leaf_box, nodes[sibling].box);
+    nodes[new_parent].height = nodes[sibling].height + 1;
+    nodes[new_parent].child1 = sibling;
+    nodes[new_parent].child2 = leaf;
+    nodes[sibling].parent = new_parent;
+    nodes[leaf].parent = new_parent;
+
+    if (old_parent != NULL_NODE)
+    {
+        if (nodes[old_parent].child1 == sibling)
+            nodes[old_parent].child1 = new_parent;
+        else
+            nodes[old_parent].child2 = new_parent;
+    }
+    else
+    {
+        root = new_parent;
+    }
+
+    // 3. Walk back up, rebalancing and refitting ancestors
+    index = nodes[leaf].parent;
+    while (index != NULL_NODE)
+    {
+        index = balance(index);
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+        nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+        nodes[index].box = aabb_union(nodes[child1].box, nodes[child2].box);
+        index = nodes[index].parent;
+    }
+}
+
+void aabbTree::remove_leaf(int leaf)
+{
+    if (leaf == root)
+    {
+        root = NULL_NODE;
+        return;
+    }
+
+    int parent = nodes[leaf].parent;
+    int grand_parent = nodes[parent].parent;
+    int sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grand_parent == NULL_NODE)
+    {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        free_node(parent);
+        return;
+    }
+
+    // Replace the parent with the sibling and refit upwards
+    if (nodes[grand_parent].child1 == parent)
+        nodes[grand_parent].child1 = sibling;
+    else
+        nodes[grand_parent].child2 = sibling;
+    nodes[sibling].parent = grand_parent;
+    free_node(parent);
+
+    int index = grand_parent;
+    while (index != NULL_NODE)
+    {
+        index = balance(index);
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+        nodes[index].box = aabb_union(nodes[child1].box, nodes[child2].box);
+        nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+        index = nodes[index].parent;
+    }
+}
+
+// ====================================================================
+// --- TREE ROTATIONS ---
+// Node A with children B and C: if one side is more than one level
+// taller, its child is rotated up to replace A.
+// ====================================================================
+
+int aabbTree::balance(int iA)
+{
+    if (nodes[iA].is_leaf() || nodes[iA].height < 2)
+        return iA;
+
+    int iB = nodes[iA].child1;
+    int iC = nodes[iA].child2;
+    int height_difference = nodes[iC].height - nodes[iB].height;
+
+    // Rotate C up
+    if (height_difference > 1)
+    {
+        int iF = nodes[iC].child1;
+        int iG = nodes[iC].child2;
+
+        nodes[iC].child1 = iA;
+        nodes[iC].parent = nodes[iA].parent;
+        nodes[iA].parent = iC;
+
+        int c_parent = nodes[iC].parent;
+        if (c_parent != NULL_NODE)
+        {
+            if (nodes[c_parent].child1 == iA)
+                nodes[c_parent].child1 = iC;
+            else
+                nodes[c_parent].child2 = iC;
+        }
+        else
+        {
+            root = iC;
+        }
+
+        // Keep the taller grandchild under C, hand the shorter one to A
+        int keep = (nodes[iF].height > nodes[iG].height) ? iF : iG;
+        int give = (keep == iF) ? iG : iF;
+        nodes[iC].child2 = keep;
+        nodes[iA].child2 = give;
+        nodes[give].parent = iA;
+        nodes[iA].box = aabb_union(nodes[iB].box, nodes[give].box);
+        nodes[iC].box = aabb_union(nodes[iA].box, nodes[keep].box);
+        nodes[iA].height = 1 + std::max(nodes[iB].height, nodes[give].height);
+        nodes[iC].height = 1 + std::max(nodes[iA].height, nodes[keep].height);
+        return iC;
+    }
+
+    // Rotate B up
+    if (height_difference < -1)
+    {
+        int iD = nodes[iB].child1;
+        int iE = nodes[iB].child2;
+
+        nodes[iB].child1 = iA;
+        nodes[iB].parent = nodes[iA].parent;
+        nodes[iA].parent = iB;
+
+        int b_parent = nodes[iB].parent;
+        if (b_parent != NULL_NODE)
+        {
+            if (nodes[b_parent].child1 == iA)
+                nodes[b_parent].child1 = iB;
+            else
+                nodes[b_parent].child2 = iB;
+        }
+        else
+        {
+            root = iB;
+        }
+
+        int keep = (nodes[iD].height > nodes[iE].height) ? iD : iE;
+        int give = (keep == iD) ? iE : iD;
+        nodes[iB].child2 = keep;
+        nodes[iA].child1 = give;
+        nodes[give].parent = iA;
+        nodes[iA].box = aabb_union(nodes[iC].box, nodes[give].box);
+        nodes[iB].box = aabb_union(nodes[iA].box, nodes[keep].box);
+        nodes[iA].height = 1 + std::max(nodes[iC].height, nodes[give].height);
+        nodes[iB].height = 1 + std::max(nodes[iA].height, nodes[keep].height);
+        return iB;
+    }
+
+    return iA;
+}
@@ -0,0 +1,122 @@
+#include "physics/contactCache.hpp"
+
+contactCache::contactCache() {}
+
+uint64_t contactCache::pack_key(int idxA, int idxB)
+{
+    uint32_t low = (uint32_t)((idxA < idxB) ? idxA : idxB);
+    uint32_t high = (uint32_t)((idxA < idxB) ? idxB : idxA);
+    return (uint64_t(high) << 32) | uint64_t(low);
+}
+
+// splitmix64 finalizer (same mixing as hashGrid)
+uint64_t contactCache::hash_key(uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+void contactCache::clear()
+{
+    slots.clear();
+    slot_mask = 0;
+    used_slots = 0;
+    generation = 1;
+}
+
+void contactCache::begin_frame()
+{
+    ++generation;
+
+    // Stale entries keep occupying their slot until the table is half full,
+    // then only the live ones are carried over.
+    if (used_slots * 2 >= slots.size() && !slots.empty())
+    {
+        size_t live = live_count();
+        size_t new_capacity = 16;
+        while (new_capacity < 4 * live)
+            new_capacity <<= 1;
+        rehash(new_capacity);
+    }
+}
+
+void contactCache::rehash(size_t new_capacity)
+{
+    std::vector<Slot> old_slots;
+    old_slots.swap(slots);
+    slots.assign(new_capacity, Slot());
+    slot_mask = new_capacity - 1;
+    used_slots = 0;
+
+    for (const Slot &old : old_slots)
+    {
+        if (!is_live(old))
+            continue;
+        uint64_t slot = hash_key(old.key) & slot_mask;
+        while (slots[slot].stamp != 0)
+            slot = (slot + 1) & slot_mask;
+        slots[slot] = old;
+        ++used_slots;
+    }
+}
+
+uint64_t contactCache::probe(uint64_t key) const
+{
+    uint64_t slot = hash_key(key) & slot_mask;
+    while (slots[slot].stamp != 0 && slots[slot].key != key)
+        slot = (slot + 1) & slot_mask;
+    return slot;
+}
+
+const contactCache::Contact *contactCache::find(int idxA, int idxB) const
+{
+    if (slots.empty())
+        return nullptr;
+    const Slot &slot = slots[probe(pack_key(idxA, idxB))];
+    return (slot.stamp == generation) ? &slot.contact : nullptr;
+}
+
+const contactCache::Contact *contactCache::find_previous(int idxA, int idxB) const
+{
+    if (slots.empty())
+        return nullptr;
+    const Slot &slot = slots[probe(pack_key(idxA, idxB))];
+    return (slot.stamp != 0 && slot.stamp + 1 == generation) ? &slot.contact : nullptr;
+}
+
+void contactCache::store(int idxA, int idxB, const Contact &contact)
+{
+    if (slots.empty())
+        rehash(16);
+
+    uint64_t key = pack_key(idxA, idxB);
+    uint64_t slot = probe(key);
+    if (slots[slot].stamp == 0)
+    {
+        // New entry: keep the load factor at or below 0.5
+        if ((used_slots + 1) * 2 > slots.size())
+        {
+            rehash(slots.size() * 2);
+            slot = probe(key);
+        }
+        slots[slot].key = key;
+        ++used_slots;
+    }
+    slots[slot].contact = contact;
+    slots[slot].stamp = generation;
+}
+
+size_t contactCache::live_count() const
+{
+    size_t live = 0;
+    for (const Slot &slot : slots)
+    {
+        if (is_live(slot))
+            ++live;
+    }
+    return live;
+}
@@ -0,0 +1,714 @@
+#include "physics/contactSolver.hpp"
+#include "physics/contactCache.hpp"
+#include "physics/world.hpp"
+#include "utils/threadPool.hpp"
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+
+// Share of last frame's impulse re-applied when warm starting
+const float SOLVER_WARM_START_FACTOR = 0.8f;
+// Threshold to snap velocity to zero after solving (matches the single-pass solver)
+const float SOLVER_VELOCITY_EPSILON = 1e-6f;
+
+// ====================================================================
+// --- CONTACT BUFFER ---
+// ====================================================================
+
+void ContactBuffer::clear()
+{
+    body_a.clear();
+    body_b.clear();
+    normal_x.clear();
+    normal_y.clear();
+    penetration.clear();
+    normal_mass.clear();
+    restitution.clear();
+    target_velocity.clear();
+    normal_impulse.clear();
+}
+
+void ContactBuffer::add(int idxA, int idxB, float nx, float ny, float depth, float mass_n, float bounce)
+{
+    body_a.push_back(idxA);
+    body_b.push_back(idxB);
+    normal_x.push_back(nx);
+    normal_y.push_back(ny);
+    penetration.push_back(depth);
+    normal_mass.push_back(mass_n);
+    restitution.push_back(bounce);
+    target_velocity.push_back(0.0f);
+    normal_impulse.push_back(0.0f);
+}
+
+void ContactBuffer::permute(const std::vector<int> &order)
+{
+    auto reorder = [&](auto &column)
+    {
+        auto source = column;
+        for (size_t k = 0; k < order.size(); ++k)
+            column[k] = source[order[k]];
+    };
+    reorder(body_a);
+    reorder(body_b);
+    reorder(normal_x);
+    reorder(normal_y);
+    reorder(penetration);
+    reorder(normal_mass);
+    reorder(restitution);
+    reorder(target_velocity);
+    reorder(normal_impulse);
+}
+
+// ====================================================================
+// --- COLLECTION ---
+// ====================================================================
+
+contactSolver::contactSolver() {}
+
+void contactSolver::clear()
+{
+    buffer.clear();
+    color_offsets.clear();
+    touched_bodies.clear();
+    island_offsets.clear();
+    for (int idx : island_members)
+        island_parent[idx] = -1;
+    island_members.clear();
+    overflow_color = false;
+}
+
+bool contactSolver::add_contact(const world &simulation_world, int idxA, int idxB, float margin)
+{
+    float inverse_mass_sum = simulation_world.inv_mass[idxA] + simulation_world.inv_mass[idxB];
+    if (inverse_mass_sum <= 0.0f)
+        return false;
+
+    float dx = simulation_world.position_x[idxB] - simulation_world.position_x[idxA];
+    float dy = simulation_world.position_y[idxB] - simulation_world.position_y[idxA];
+    float distance_squared = dx * dx + dy * dy;
+    float sum_of_radii = simulation_world.radius[idxA] + simulation_world.radius[idxB];
+    float reach = sum_of_radii + margin;
+    if (distance_squared <= 1e-6f || distance_squared > reach * reach)
+        return false;
+
+    float distance = std::sqrt(distance_squared);
+    float effective_restitution = (simulation_world.get_restitution(idxA) + simulation_world.get_restitution(idxB)) * 0.5f;
+    buffer.add(idxA, idxB, dx / distance, dy / distance, sum_of_radii - distance, 1.0f / inverse_mass_sum, effective_restitution);
+    if (simulation_world.inv_mass[idxA] != 0.0f && simulation_world.inv_mass[idxB] != 0.0f)
+        unite_bodies(idxA, idxB);
+    return true;
+}
+
+// ====================================================================
+// --- ISLANDS (union-find) ---
+// ====================================================================
+
+int contactSolver::find_island_root(int body)
+{
+    if (body >= (int)island_parent.size())
+        return body;
+    while (island_parent[body] >= 0)
+    {
+        int parent = island_parent[body];
+        if (island_parent[parent] >= 0)
+            island_parent[body] = island_parent[parent]; // path halving
+        body = island_parent[body];
+    }
+    return body;
+}
+
+void contactSolver::link_bodies(const world &simulation_world, int idxA, int idxB)
+{
+    if (simulation_world.inv_mass[idxA] != 0.0f && simulation_world.inv_mass[idxB] != 0.0f)
+        unite_bodies(idxA, idxB);
+}
+
+void contactSolver::unite_bodies(int idxA, int idxB)
+{
+    int highest = std::max(idxA, idxB);
+    if (highest >= (int)island_parent.size())
+        island_parent.resize(highest + 1, -1);
+
+    int root_A = find_island_root(idxA);
+    int root_B = find_island_root(idxB);
+    if (root_A == root_B)
+        return;
+    // The lower index becomes the root, so roots do not depend on contact order
+    if (root_A > root_B)
+        std::swap(root_A, root_B);
+    island_parent[root_B] = root_A;
+    island_members.push_back(root_B);
+}
+
+// Sorts the buffer by island (islands in order of their first contact) and
+// counts the dynamic bodies of each island.
+void contactSolver::build_islands(const world &simulation_world)
+{
+    size_t count = buffer.size();
+    size_t n = simulation_world.size();
+    std::vector<int> island_of_root(n, -1);
+    std::vector<int> contact_island(count);
+    int islands = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+        int a = buffer.body_a[k];
+        int dynamic_body = (simulation_world.inv_mass[a] != 0.0f) ? a : buffer.body_b[k];
+        int root = find_island_root(dynamic_body);
+        if (island_of_root[root] < 0)
+            island_of_root[root] = islands++;
+        contact_island[k] = island_of_root[root];
+    }
+
+    island_offsets.assign(islands + 1, 0);
+    for (size_t k = 0; k < count; ++k)
+        ++island_offsets[contact_island[k] + 1];
+    for (int i = 0; i < islands; ++i)
+        island_offsets[i + 1] += island_offsets[i];
+
+    island_order.resize(count);
+    std::vector<int> cursor(island_offsets.begin(), island_offsets.end() - 1);
+    for (size_t k = 0; k < count; ++k)
+        island_order[cursor[contact_island[k]]++] = (int)k;
+    buffer.permute(island_order);
+
+    // Dynamic bodies per island: each counted once, through its root
+    island_body_counts.assign(islands, 0);
+    std::vector<uint8_t> counted(n, 0);
+    for (size_t k = 0; k < count; ++k)
+    {
+        for (int idx : {buffer.body_a[k], buffer.body_b[k]})
+        {
+            if (simulation_world.inv_mass[idx] == 0.0f || counted[idx])
+                continue;
+            counted[idx] = 1;
+            ++island_body_counts[island_of_root[find_island_root(idx)]];
+        }
+    }
+}
+
+// One task per island: its contacts are contiguous and share no dynamic
+// body with any other island.
+void contactSolver::solve_islands(world &simulation_world, threadPool *pool)
+{
+    int islands = island_count();
+    island_solve_ns.assign(islands, 0);
+    int velocity_iterations = std::max(simulation_world.solver_settings.velocity_iterations, 1);
+    int position_iterations = simulation_world.solver_settings.position_iterations;
+
+    auto solve_range = [&](int first, int last)
+    {
+        for (int island = first; island < last; ++island)
+        {
+            auto t0 = std::chrono::high_resolution_clock::now();
+            size_t begin = (size_t)island_offsets[island];
+            size_t end = (size_t)island_offsets[island + 1];
+            for (int iteration = 0; iteration < velocity_iterations; ++iteration)
+            {
+                for (size_t k = begin; k < end; ++k)
+                    solve_velocity_contact(simulation_world, k);
+            }
+            integrate_positions(simulation_world, begin, end);
+            for (int iteration = 0; iteration < position_iterations; ++iteration)
+            {
+                for (size_t k = begin; k < end; ++k)
+                    solve_position_contact(simulation_world, k);
+            }
+            auto t1 = std::chrono::high_resolution_clock::now();
+            island_solve_ns[island] = (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        }
+    };
+
+    if (pool)
+        pool->parallel_for(islands, solve_range, 1);
+    else
+        solve_range(0, islands);
+}
+
+// ====================================================================
+// --- GRAPH COLORING ---
+// ====================================================================
+
+// Greedy coloring in buffer order: each contact takes the lowest color
+// not yet used by either of its dynamic bodies. The buffer is then sorted
+// by color (stable, so the order inside a color stays deterministic).
+void contactSolver::color_contacts(const world &simulation_world)
+{
+    size_t count = buffer.size();
+    body_color_masks.assign(simulation_world.size(), 0);
+    contact_colors.resize(count);
+
+    int used_colors = 0;
+    overflow_color = false;
+    for (size_t k = 0; k < count; ++k)
+    {
+        int a = buffer.body_a[k];
+        int b = buffer.body_b[k];
+        bool dynamic_A = simulation_world.inv_mass[a] != 0.0f;
+        bool dynamic_B = simulation_world.inv_mass[b] != 0.0f;
+        uint64_t used = (dynamic_A ? body_color_masks[a] : 0) | (dynamic_B ? body_color_masks[b] : 0);
+        if (used == ~uint64_t(0))
+        {
+            contact_colors[k] = MAX_COLORS;
+            overflow_color = true;
+            continue;
+        }
+
+        int color = 0;
+        while (used & (uint64_t(1) << color))
+            ++color;
+        contact_colors[k] = color;
+        used_colors = std::max(used_colors, color + 1);
+        if (dynamic_A)
+            body_color_masks[a] |= uint64_t(1) << color;
+        if (dynamic_B)
+            body_color_masks[b] |= uint64_t(1) << color;
+    }
+
+    // Counting sort by color; the overflow batch goes last
+    int num_colors = overflow_color ? MAX_COLORS + 1 : used_colors;
+    std::vector<int> color_counts(num_colors + 1, 0);
+    for (size_t k = 0; k < count; ++k)
+        ++color_counts[contact_colors[k] + 1];
+    for (int c = 0; c < num_colors; ++c)
+        color_counts[c + 1] += color_counts[c];
+
+    color_order.resize(count);
+    std::vector<int> cursor(color_counts.begin(), color_counts.end() - 1);
+    for (size_t k = 0; k < count; ++k)
+        color_order[cursor[contact_colors[k]]++] = (int)k;
+    buffer.permute(color_order);
+
+    // The overflow batch, if any, is appended as the last color
+    color_offsets.assign(color_counts.begin(), color_counts.begin() + used_colors + 1);
+    if (overflow_color)
+        color_offsets.push_back((int)count);
+}
+
+template <typename ContactKernel>
+void contactSolver::sweep_contacts(threadPool *pool, ContactKernel &&solve_contact)
+{
+    if (!pool || color_offsets.empty())
+    {
+        for (size_t k = 0; k < buffer.size(); ++k)
+            solve_contact(k);
+        return;
+    }
+
+    int colors = color_count();
+    for (int c = 0; c < colors; ++c)
+    {
+        int begin = color_offsets[c];
+        int end = color_offsets[c + 1];
+        if (overflow_color && c == colors - 1)
+        {
+            for (int k = begin; k < end; ++k)
+                solve_contact((size_t)k);
+            continue;
+        }
+        pool->parallel_for(end - begin, [&](int chunk_begin, int chunk_end)
+                           {
+            for (int k = begin + chunk_begin; k < begin + chunk_end; ++k)
+                solve_contact((size_t)k); });
+    }
+}
+
+// ====================================================================
+// --- JACOBI ---
+// ====================================================================
+
+void contactSolver::build_body_contacts(const world &simulation_world)
+{
+    size_t n = simulation_world.size();
+    size_t count = buffer.size();
+    body_contact_offsets.assign(n + 1, 0);
+    for (size_t k = 0; k < count; ++k)
+    {
+        for (int idx : {buffer.body_a[k], buffer.body_b[k]})
+        {
+            if (simulation_world.inv_mass[idx] != 0.0f)
+                ++body_contact_offsets[idx + 1];
+        }
+    }
+
+    touched_bodies.clear();
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (body_contact_offsets[i + 1] > 0)
+            touched_bodies.push_back((int)i);
+    }
+
+    contact_scale.resize(count);
+    for (size_t k = 0; k < count; ++k)
+    {
+        int busiest = std::max(body_contact_offsets[buffer.body_a[k] + 1], body_contact_offsets[buffer.body_b[k] + 1]);
+        contact_scale[k] = 1.0f / (float)busiest;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        body_contact_offsets[i + 1] += body_contact_offsets[i];
+
+    // Filled in buffer order, so each body gathers its contacts in that order
+    body_contact_list.resize(body_contact_offsets[n]);
+    std::vector<int> cursor(body_contact_offsets.begin(), body_contact_offsets.end() - 1);
+    for (size_t k = 0; k < count; ++k)
+    {
+        for (int idx : {buffer.body_a[k], buffer.body_b[k]})
+        {
+            if (simulation_world.inv_mass[idx] != 0.0f)
+                body_contact_list[cursor[idx]++] = (int)k;
+        }
+    }
+
+    contact_delta_x.assign(count, 0.0f);
+    contact_delta_y.assign(count, 0.0f);
+}
+
+void contactSolver::apply_jacobi_deltas(world &simulation_world, std::vector<float> &column_x, std::vector<float> &column_y, threadPool *pool)
+{
+    auto gather = [&](int begin, int end)
+    {
+        for (int t = begin; t < end; ++t)
+        {
+            int idx = touched_bodies[t];
+            float sum_x = 0.0f;
+            float sum_y = 0.0f;
+            for (int e = body_contact_offsets[idx]; e < body_contact_offsets[idx + 1]; ++e)
+            {
+                int k = body_contact_list[e];
+                float sign = (buffer.body_b[k] == idx) ? 1.0f : -1.0f;
+                sum_x += sign * contact_delta_x[k];
+                sum_y += sign * contact_delta_y[k];
+            }
+            column_x[idx] += sum_x * simulation_world.inv_mass[idx];
+            column_y[idx] += sum_y * simulation_world.inv_mass[idx];
+        }
+    };
+
+    if (pool)
+        pool->parallel_for((int)touched_bodies.size(), gather);
+    else
+        gather(0, (int)touched_bodies.size());
+}
+
+void contactSolver::solve_velocities_jacobi(world &simulation_world, threadPool *pool)
+{
+    int iterations = std::max(simulation_world.solver_settings.velocity_iterations, 1);
+    auto compute = [&](int begin, int end)
+    {
+        for (int k = begin; k < end; ++k)
+        {
+            int a = buffer.body_a[k];
+            int b = buffer.body_b[k];
+            float nx = buffer.normal_x[k];
+            float ny = buffer.normal_y[k];
+            float velocity_along_normal = (simulation_world.vel_x[b] - simulation_world.vel_x[a]) * nx +
+                                          (simulation_world.vel_y[b] - simulation_world.vel_y[a]) * ny;
+
+            float old_impulse = buffer.normal_impulse[k];
+            float new_impulse = std::max(old_impulse + (buffer.target_velocity[k] - velocity_along_normal) * buffer.normal_mass[k] * contact_scale[k], 0.0f);
+            buffer.normal_impulse[k] = new_impulse;
+            float delta = new_impulse - old_impulse;
+            contact_delta_x[k] = nx * delta;
+            contact_delta_y[k] = ny * delta;
+        }
+    };
+
+    int count = (int)buffer.size();
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        if (pool)
+            pool->parallel_for(count, compute);
+        else
+            compute(0, count);
+        apply_jacobi_deltas(simulation_world, simulation_world.vel_x, simulation_world.vel_y, pool);
+    }
+}
+
+void contactSolver::solve_positions_jacobi(world &simulation_world, threadPool *pool)
+{
+    const SolverSettings &settings = simulation_world.solver_settings;
+    auto compute = [&](int begin, int end)
+    {
+        for (int k = begin; k < end; ++k)
+        {
+            int a = buffer.body_a[k];
+            int b = buffer.body_b[k];
+            float dx = simulation_world.position_x[b] - simulation_world.position_x[a];
+            float dy = simulation_world.position_y[b] - simulation_world.position_y[a];
+            float distance_squared = dx * dx + dy * dy;
+            float nx = buffer.normal_x[k];
+            float ny = buffer.normal_y[k];
+            float distance = 0.0f;
+            if (distance_squared > 1e-12f)
+            {
+                distance = std::sqrt(distance_squared);
+                nx = dx / distance;
+                ny = dy / distance;
+            }
+
+            float penetration = simulation_world.radius[a] + simulation_world.radius[b] - distance;
+            float correction = std::max(penetration - settings.position_correction_slop, 0.0f) * settings.position_correction_percent * buffer.normal_mass[k] * contact_scale[k];
+            contact_delta_x[k] = nx * correction;
+            contact_delta_y[k] = ny * correction;
+        }
+    };
+
+    int count = (int)buffer.size();
+    for (int iteration = 0; iteration < settings.position_iterations; ++iteration)
+    {
+        if (pool)
+            pool->parallel_for(count, compute);
+        else
+            compute(0, count);
+        apply_jacobi_deltas(simulation_world, simulation_world.position_x, simulation_world.position_y, pool);
+    }
+}
+
+// ====================================================================
+// --- SOLVER STAGES ---
+// ====================================================================
+
+void contactSolver::solve(world &simulation_world, contactCache *cache, ContactIteration iteration, threadPool *pool)
+{
+    if (buffer.size() == 0)
+        return;
+
+    if (iteration == ContactIteration::COLORED)
+        color_contacts(simulation_world);
+    else if (iteration == ContactIteration::JACOBI)
+        build_body_contacts(simulation_world);
+    else if (iteration == ContactIteration::ISLANDS)
+        build_islands(simulation_world);
+    threadPool *sweep_pool = (iteration == ContactIteration::SEQUENTIAL) ? nullptr : pool;
+
+    prepare(simulation_world);
+    if (cache)
+        warm_start(simulation_world, *cache);
+    if (iteration == ContactIteration::ISLANDS)
+    {
+        solve_islands(simulation_world, sweep_pool);
+    }
+    else
+    {
+        if (iteration == ContactIteration::JACOBI)
+            solve_velocities_jacobi(simulation_world, sweep_pool);
+        else
+            solve_velocities(simulation_world, sweep_pool);
+        integrate_positions(simulation_world, 0, buffer.size());
+        if (iteration == ContactIteration::JACOBI)
+            solve_positions_jacobi(simulation_world, sweep_pool);
+        else
+            solve_positions(simulation_world, sweep_pool);
+    }
+    sync_verlet_state(simulation_world);
+    if (cache)
+        store_impulses(*cache);
+}
+
+// The centred velocity stored by the integrator lags half a step behind the
+// motion actually taken; contacts are solved on (position - previous_position) / dt.
+void contactSolver::prepare(world &simulation_world)
+{
+    float dt = simulation_world.delta_time;
+    if (dt > 0.0f)
+    {
+        float inv_dt = 1.0f / dt;
+        for (size_t k = 0; k < buffer.size(); ++k)
+        {
+            for (int idx : {buffer.body_a[k], buffer.body_b[k]})
+            {
+                if (simulation_world.inv_mass[idx] == 0.0f)
+                    continue;
+                simulation_world.vel_x[idx] = (simulation_world.position_x[idx] - simulation_world.previous_position_x[idx]) * inv_dt;
+                simulation_world.vel_y[idx] = (simulation_world.position_y[idx] - simulation_world.previous_position_y[idx]) * inv_dt;
+            }
+        }
+    }
+
+    // Restitution target from the approach speed before any impulse of this frame
+    for (size_t k = 0; k < buffer.size(); ++k)
+    {
+        int a = buffer.body_a[k];
+        int b = buffer.body_b[k];
+        float velocity_along_normal = (simulation_world.vel_x[b] - simulation_world.vel_x[a]) * buffer.normal_x[k] +
+                                      (simulation_world.vel_y[b] - simulation_world.vel_y[a]) * buffer.normal_y[k];
+        buffer.target_velocity[k] = (velocity_along_normal < 0.0f) ? -buffer.restitution[k] * velocity_along_normal : 0.0f;
+    }
+}
+
+// Contacts that existed last frame are resting: unless they approach faster than
+// SolverSettings::bounce_threshold they do not bounce, and they start from the
+// non-restitution share of their old impulse, projected on the new normal.
+void contactSolver::warm_start(world &simulation_world, contactCache &cache)
+{
+    for (size_t k = 0; k < buffer.size(); ++k)
+    {
+        const contactCache::Contact *previous = cache.find_previous(buffer.body_a[k], buffer.body_b[k]);
+        if (!previous)
+            continue;
+
+        // target = restitution * approach speed, so this compares the approach speed
+        if (buffer.target_velocity[k] <= buffer.restitution[k] * simulation_world.solver_settings.bounce_threshold)
+            buffer.target_velocity[k] = 0.0f;
+        float nx = buffer.normal_x[k];
+        float ny = buffer.normal_y[k];
+        float alignment = std::max(nx * previous->normal_x + ny * previous->normal_y, 0.0f);
+        float impulse = previous->resting_impulse * SOLVER_WARM_START_FACTOR * alignment;
+        if (impulse <= 0.0f)
+            continue;
+        buffer.normal_impulse[k] = impulse;
+
+        int a = buffer.body_a[k];
+        int b = buffer.body_b[k];
+        float inverse_mass_A = simulation_world.inv_mass[a];
+        float inverse_mass_B = simulation_world.inv_mass[b];
+        simulation_world.vel_x[a] -= nx * impulse * inverse_mass_A;
+        simulation_world.vel_y[a] -= ny * impulse * inverse_mass_A;
+        simulation_world.vel_x[b] += nx * impulse * inverse_mass_B;
+        simulation_world.vel_y[b] += ny * impulse * inverse_mass_B;
+    }
+}
+
+void contactSolver::solve_velocity_contact(world &simulation_world, size_t k)
+{
+    int a = buffer.body_a[k];
+    int b = buffer.body_b[k];
+    float nx = buffer.normal_x[k];
+    float ny = buffer.normal_y[k];
+
+    float velocity_along_normal = (simulation_world.vel_x[b] - simulation_world.vel_x[a]) * nx +
+                                  (simulation_world.vel_y[b] - simulation_world.vel_y[a]) * ny;
+
+    // Clamp the accumulated impulse, apply only the change
+    float old_impulse = buffer.normal_impulse[k];
+    float new_impulse = std::max(old_impulse + (buffer.target_velocity[k] - velocity_along_normal) * buffer.normal_mass[k], 0.0f);
+    buffer.normal_impulse[k] = new_impulse;
+    float delta = new_impulse - old_impulse;
+
+    // Static bodies are shared between colors: never write them
+    float inverse_mass_A = simulation_world.inv_mass[a];
+    float inverse_mass_B = simulation_world.inv_mass[b];
+    if (inverse_mass_A != 0.0f)
+    {
+        simulation_world.vel_x[a] -= nx * delta * inverse_mass_A;
+        simulation_world.vel_y[a] -= ny * delta * inverse_mass_A;
+    }
+    if (inverse_mass_B != 0.0f)
+    {
+        simulation_world.vel_x[b] += nx * delta * inverse_mass_B;
+        simulation_world.vel_y[b] += ny * delta * inverse_mass_B;
+    }
+}
+
+void contactSolver::solve_velocities(world &simulation_world, threadPool *pool)
+{
+    int iterations = std::max(simulation_world.solver_settings.velocity_iterations, 1);
+    for (int iteration = 0; iteration < iterations; ++iteration)
+        sweep_contacts(pool, [&](size_t k)
+                       { solve_velocity_contact(simulation_world, k); });
+}
+
+// Redo this step's position update with the solved velocities, starting from
+// where each body was before the integrator moved it.
+void contactSolver::integrate_positions(world &simulation_world, size_t begin, size_t end)
+{
+    float dt = simulation_world.delta_time;
+    if (dt <= 0.0f)
+        return;
+    for (size_t k = begin; k < end; ++k)
+    {
+        for (int idx : {buffer.body_a[k], buffer.body_b[k]})
+        {
+            if (simulation_world.inv_mass[idx] == 0.0f)
+                continue;
+            simulation_world.position_x[idx] = simulation_world.previous_position_x[idx] + simulation_world.vel_x[idx] * dt;
+            simulation_world.position_y[idx] = simulation_world.previous_position_y[idx] + simulation_world.vel_y[idx] * dt;
+        }
+    }
+}
+
+// Split position correction: penetration is removed by moving positions only,
+// so it never turns into velocity.
+void contactSolver::solve_position_contact(world &simulation_world, size_t k)
+{
+    const SolverSettings &settings = simulation_world.solver_settings;
+    int a = buffer.body_a[k];
+    int b = buffer.body_b[k];
+
+    float dx = simulation_world.position_x[b] - simulation_world.position_x[a];
+    float dy = simulation_world.position_y[b] - simulation_world.position_y[a];
+    float distance_squared = dx * dx + dy * dy;
+    float nx = buffer.normal_x[k];
+    float ny = buffer.normal_y[k];
+    float distance = 0.0f;
+    if (distance_squared > 1e-12f)
+    {
+        distance = std::sqrt(distance_squared);
+        nx = dx / distance;
+        ny = dy / distance;
+    }
+
+    float penetration = simulation_world.radius[a] + simulation_world.radius[b] - distance;
+    float correction = std::max(penetration - settings.position_correction_slop, 0.0f) * settings.position_correction_percent * buffer.normal_mass[k];
+    if (correction <= 0.0f)
+        return;
+
+    float inverse_mass_A = simulation_world.inv_mass[a];
+    float inverse_mass_B = simulation_world.inv_mass[b];
+    if (inverse_mass_A != 0.0f)
+    {
+        simulation_world.position_x[a] -= nx * correction * inverse_mass_A;
+        simulation_world.position_y[a] -= ny * correction * inverse_mass_A;
+    }
+    if (inverse_mass_B != 0.0f)
+    {
+        simulation_world.position_x[b] += nx * correction * inverse_mass_B;
+        simulation_world.position_y[b] += ny * correction * inverse_mass_B;
+    }
+}
+
+void contactSolver::solve_positions(world &simulation_world, threadPool *pool)
+{
+    for (int iteration = 0; iteration < simulation_world.solver_settings.position_iterations; ++iteration)
+        sweep_contacts(pool, [&](size_t k)
+                       { solve_position_contact(simulation_world, k); });
+}
+
+void contactSolver::sync_verlet_state(world &simulation_world)
+{
+    float dt = simulation_world.delta_time;
+    for (size_t k = 0; k < buffer.size(); ++k)
+    {
+        for (int idx : {buffer.body_a[k], buffer.body_b[k]})
+        {
+            if (simulation_world.inv_mass[idx] == 0.0f)
+                continue;
+            if (std::fabs(simulation_world.vel_x[idx]) < SOLVER_VELOCITY_EPSILON)
+                simulation_world.vel_x[idx] = 0.0f;
+            if (std::fabs(simulation_world.vel_y[idx]) < SOLVER_VELOCITY_EPSILON)
+                simulation_world.vel_y[idx] = 0.0f;
+            if (dt > 0.0f)
+            {
+                simulation_world.previous_position_x[idx] = simulation_world.position_x[idx] - simulation_world.vel_x[idx] * dt;
+                simulation_world.previous_position_y[idx] = simulation_world.position_y[idx] - simulation_world.vel_y[idx] * dt;
+            }
+        }
+    }
+}
+
+void contactSolver::store_impulses(contactCache &cache) const
+{
+    for (size_t k = 0; k < buffer.size(); ++k)
+    {
+        contactCache::Contact contact;
+        contact.normal_impulse = buffer.normal_impulse[k];
+        // A bouncing contact's impulse is mostly restitution: do not carry it over
+        contact.resting_impulse = (buffer.target_velocity[k] > 0.0f) ? 0.0f : buffer.normal_impulse[k];
+        contact.target_velocity = buffer.target_velocity[k];
+        contact.normal_x = buffer.normal_x[k];
+        contact.normal_y = buffer.normal_y[k];
+        contact.solved = true;
+        cache.store(buffer.body_a[k], buffer.body_b[k], contact);
+    }
+}
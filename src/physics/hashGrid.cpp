@@ -0,0 +1,99 @@
+#include "physics/hashGrid.hpp"
+#include <cmath>
+
+hashGrid::hashGrid() {}
+
+uint64_t hashGrid::pack_key(int32_t cx, int32_t cy)
+{
+    return (uint64_t(uint32_t(cy)) << 32) | uint64_t(uint32_t(cx));
+}
+
+// splitmix64 finalizer: neighbouring cells land far apart in the table
+uint64_t hashGrid::hash_key(uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+int32_t hashGrid::cell_coord(float position, float inv_cell_size)
+{
+    float c = std::floor(position * inv_cell_size);
+    if (!(c > (float)-MAX_CELL_COORD))
+        return -MAX_CELL_COORD;
+    if (c > (float)MAX_CELL_COORD)
+        return MAX_CELL_COORD;
+    return (int32_t)c;
+}
+
+void hashGrid::build(const float *position_x, const float *position_y, size_t n, float cell_size)
+{
+    // 1. Size the table for a load factor of at most 0.5 (occupied cells <= bodies)
+    size_t capacity = 16;
+    while (capacity < 2 * n)
+        capacity <<= 1;
+    slot_keys.resize(capacity);
+    slot_cells.assign(capacity, -1);
+    slot_mask = capacity - 1;
+
+    occupied_cells.clear();
+    body_cells.resize(n);
+
+    // 2. Find or create the cell of every body and count its population
+    float inv_cell_size = 1.0f / cell_size;
+    for (size_t i = 0; i < n; ++i)
+    {
+        int32_t cx = cell_coord(position_x[i], inv_cell_size);
+        int32_t cy = cell_coord(position_y[i], inv_cell_size);
+        uint64_t key = pack_key(cx, cy);
+
+        uint64_t slot = hash_key(key) & slot_mask;
+        while (slot_cells[slot] >= 0 && slot_keys[slot] != key)
+            slot = (slot + 1) & slot_mask;
+
+        if (slot_cells[slot] < 0)
+        {
+            slot_keys[slot] = key;
+            slot_cells[slot] = (int)occupied_cells.size();
+            occupied_cells.push_back({cx, cy, 0, 0});
+        }
+        int cell = slot_cells[slot];
+        body_cells[i] = cell;
+        ++occupied_cells[cell].end;
+    }
+
+    // 3. Prefix sum over occupied cells
+    int running_total = 0;
+    for (Cell &cell : occupied_cells)
+    {
+        int count = cell.end;
+        cell.begin = running_total;
+        cell.end = running_total;
+        running_total += count;
+    }
+
+    // 4. Scatter (ascending body index inside each cell)
+    sorted.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        sorted[occupied_cells[body_cells[i]].end++] = (int)i;
+    }
+}
+
+int hashGrid::find_cell(int32_t cx, int32_t cy) const
+{
+    if (slot_cells.empty())
+        return -1;
+    uint64_t key = pack_key(cx, cy);
+    uint64_t slot = hash_key(key) & slot_mask;
+    while (slot_cells[slot] >= 0)
+    {
+        if (slot_keys[slot] == key)
+            return slot_cells[slot];
+        slot = (slot + 1) & slot_mask;
+    }
+    return -1;
+}
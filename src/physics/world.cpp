@@ -1,6 +1,8 @@
 #include "physics/world.hpp"
 #include "physics/body.hpp"
 #include <utility>
+#include <type_traits>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -8,6 +10,7 @@ world::world() : gravity_x(0.0f),
                  gravity_y(-41.63f),
                  delta_time(1.0f / 60.0f)
 {
+    update_grid_dimensions();
 }
 
 world::world(
@@ -48,22 +51,12 @@ world::world(
       radius(std::move(radius_in))
 {
 
-    float width = grid_info.max_x - grid_info.min_x;
-    float height = grid_info.max_y - grid_info.min_y;
-
-    int numCellsX = static_cast<int>(std::ceil(width / grid_info.cell_size));
-    int numCellsY = static_cast<int>(std::ceil(height / grid_info.cell_size));
-
-    grid_info.num_cells_x = numCellsX;
-    grid_info.num_cells_y = numCellsY;
-
-    int totalCells = numCellsX * numCellsY;
-    particle_start_indices.resize(totalCells);
-    grid.clear();
-    grid.resize(totalCells);
+    partition_bodies();
+    update_grid_dimensions();
 }
 
-// SoA constructor: accept position arrays (by copy). Other arrays can be populated later.
+// SoA constructor: accept position arrays (by copy). Other arrays can be populated later;
+// every body starts static (inv_mass 0), so call partition_bodies() after filling inv_mass.
 world::world(const std::vector<float> &position_x_in, const std::vector<float> &position_y_in, const vec2 &gravity_vec, float delta_time_in)
     : position_x(position_x_in), position_y(position_y_in), gravity_x(gravity_vec.x), gravity_y(gravity_vec.y), delta_time(delta_time_in)
 {
@@ -80,6 +73,9 @@ world::world(const std::vector<float> &position_x_in, const std::vector<float> &
     damping.resize(n);
     friction.resize(n);
     restitution.resize(n);
+    sleeping.resize(n);
+    sleep_timer.resize(n);
+    sleep_island.assign(n, -1);
 
     // initialize previous positions to current positions
     for (size_t i = 0; i < n; ++i)
@@ -88,22 +84,65 @@ world::world(const std::vector<float> &position_x_in, const std::vector<float> &
         previous_position_y[i] = position_y[i];
     }
 
-    float width = grid_info.max_x - grid_info.min_x;
-    float height = grid_info.max_y - grid_info.min_y;
+    partition_bodies();
+    update_grid_dimensions();
+}
 
-    int numCellsX = static_cast<int>(std::ceil(width / grid_info.cell_size));
-    int numCellsY = static_cast<int>(std::ceil(height / grid_info.cell_size));
+// Every per-body SoA column. Keep this list in sync when adding columns so
+// remove_body and permute_bodies move the new data along with the body.
+template <typename ColumnFn>
+static void for_each_body_column(world &w, ColumnFn &&fn)
+{
+    fn(w.position_x);
+    fn(w.position_y);
+    fn(w.previous_position_x);
+    fn(w.previous_position_y);
+    fn(w.vel_x);
+    fn(w.vel_y);
+    fn(w.acc_x);
+    fn(w.acc_y);
+    fn(w.mass);
+    fn(w.inv_mass);
+    fn(w.radius);
+    fn(w.damping);
+    fn(w.friction);
+    fn(w.restitution);
+    fn(w.sleeping);
+    fn(w.sleep_timer);
+    fn(w.sleep_island);
+}
 
-    grid_info.num_cells_x = numCellsX;
-    grid_info.num_cells_y = numCellsY;
+// Exchanges bodies a and b in every populated column
+static void swap_bodies(world &w, size_t a, size_t b)
+{
+    size_t n = w.size();
+    for_each_body_column(w, [&](auto &column)
+                         {
+                             if (column.size() != n)
+                                 return;
+                             std::swap(column[a], column[b]); });
+}
+
+// New index k holds old body order[k]; returns old index -> new index
+static std::vector<int> apply_body_order(world &w, const std::vector<int> &order)
+{
+    size_t n = w.size();
+    std::vector<int> remap(n);
+    for (size_t k = 0; k < n; ++k)
+        remap[order[k]] = (int)k;
 
-    int totalCells = numCellsX * numCellsY;
-    particle_start_indices.resize(totalCells);
-    grid.clear();
-    grid.resize(totalCells);
+    for_each_body_column(w, [&](auto &column)
+                         {
+                             if (column.size() != n)
+                                 return;
+                             typename std::decay<decltype(column)>::type reordered(n);
+                             for (size_t k = 0; k < n; ++k)
+                                 reordered[k] = column[order[k]];
+                             column.swap(reordered); });
+    return remap;
 }
 
-void world::add_body(const body &b)
+size_t world::add_body(const body &b)
 {
     position_x.push_back(b.position.x);
     position_y.push_back(b.position.y);
@@ -119,41 +158,128 @@ void world::add_body(const body &b)
     damping.push_back(b.damping);
     friction.push_back(b.friction);
     restitution.push_back(b.restitution);
+    sleeping.push_back(0);
+    sleep_timer.push_back(0.0f);
+    sleep_island.push_back(-1);
+    ++body_layout_version;
+
+    size_t idx = position_x.size() - 1;
+    if (b.inv_mass > 0.0f)
+    {
+        // The first static body makes room at the end of the dynamic range
+        if (idx != dynamic_count)
+        {
+            swap_bodies(*this, idx, dynamic_count);
+            idx = dynamic_count;
+            ++static_layout_version;
+        }
+        ++dynamic_count;
+    }
+    else
+        ++static_layout_version;
+    return idx;
 }
 
 void world::remove_body(size_t idx)
 {
-    if (idx >= position_x.size())
+    size_t n = position_x.size();
+    if (idx >= n)
         return;
-    // swap-remove to keep O(1)
-    size_t last = position_x.size() - 1;
-    if (idx != last)
+    // swap-remove to keep O(1): the last dynamic body fills a dynamic hole and
+    // the last body fills the slot it left, so both ranges stay contiguous
+    size_t last = n - 1;
+    auto move_body = [&](size_t dst, size_t src)
+    {
+        for_each_body_column(*this, [&](auto &column)
+                             {
+                                 if (column.size() != n)
+                                     return; // column not populated in this world
+                                 column[dst] = column[src]; });
+    };
+    if (idx < dynamic_count)
+    {
+        size_t last_dynamic = dynamic_count - 1;
+        move_body(idx, last_dynamic);
+        if (last_dynamic != last)
+        {
+            move_body(last_dynamic, last);
+            ++static_layout_version;
+        }
+        --dynamic_count;
+    }
+    else
+    {
+        move_body(idx, last);
+        ++static_layout_version;
+    }
+    for_each_body_column(*this, [&](auto &column)
+                         {
+                             if (column.size() == n)
+                                 column.pop_back(); });
+    ++body_layout_version;
+}
+
+void world::clear_bodies()
+{
+    for_each_body_column(*this, [](auto &column)
+                         { column.clear(); });
+    dynamic_count = 0;
+    ++body_layout_version;
+    ++static_layout_version;
+}
+
+std::vector<int> world::permute_bodies(const std::vector<int> &new_order)
+{
+    size_t n = position_x.size();
+    std::vector<int> order(new_order.begin(), new_order.end());
+    std::stable_partition(order.begin(), order.end(), [&](int idx)
+                          { return (size_t)idx < dynamic_count; });
+    for (size_t k = dynamic_count; k < n; ++k)
     {
-        position_x[idx] = position_x[last];
-        position_y[idx] = position_y[last];
-        vel_x[idx] = vel_x[last];
-        vel_y[idx] = vel_y[last];
-        acc_x[idx] = acc_x[last];
-        acc_y[idx] = acc_y[last];
-        mass[idx] = mass[last];
-        inv_mass[idx] = inv_mass[last];
-        radius[idx] = radius[last];
-        damping[idx] = damping[last];
-        friction[idx] = friction[last];
-        restitution[idx] = restitution[last];
+        if (order[k] != (int)k)
+        {
+            ++static_layout_version;
+            break;
+        }
     }
-    position_x.pop_back();
-    position_y.pop_back();
-    vel_x.pop_back();
-    vel_y.pop_back();
-    acc_x.pop_back();
-    acc_y.pop_back();
-    mass.pop_back();
-    inv_mass.pop_back();
-    radius.pop_back();
-    damping.pop_back();
-    friction.pop_back();
-    restitution.pop_back();
+    std::vector<int> remap = apply_body_order(*this, order);
+    ++body_layout_version;
+    return remap;
+}
+
+size_t world::set_mass(size_t idx, float new_mass)
+{
+    if (idx >= position_x.size())
+        return idx;
+    mass[idx] = new_mass;
+    inv_mass[idx] = (new_mass > 0.0f) ? 1.0f / new_mass : 0.0f;
+    bool was_dynamic = idx < dynamic_count;
+    if (was_dynamic == (inv_mass[idx] > 0.0f))
+        return idx;
+
+    // The body trades places with the dynamic body next to the boundary
+    size_t boundary = was_dynamic ? dynamic_count - 1 : dynamic_count;
+    swap_bodies(*this, idx, boundary);
+    dynamic_count = was_dynamic ? dynamic_count - 1 : dynamic_count + 1;
+    ++body_layout_version;
+    ++static_layout_version;
+    return boundary;
+}
+
+// Bodies without an inv_mass entry count as static
+std::vector<int> world::partition_bodies()
+{
+    size_t n = position_x.size();
+    std::vector<int> order(n);
+    for (size_t i = 0; i < n; ++i)
+        order[i] = (int)i;
+    auto dynamic = [&](int idx)
+    { return (size_t)idx < inv_mass.size() && inv_mass[idx] > 0.0f; };
+    auto boundary = std::stable_partition(order.begin(), order.end(), dynamic);
+    dynamic_count = boundary - order.begin();
+    ++body_layout_version;
+    ++static_layout_version;
+    return apply_body_order(*this, order);
 }
 
 vec2 world::get_position(size_t idx) const
@@ -167,6 +293,8 @@ void world::set_position(size_t idx, const vec2 &p)
 {
     if (idx >= position_x.size())
         return;
+    if (is_static(idx))
+        ++static_layout_version;
     position_x[idx] = p.x;
     position_y[idx] = p.y;
     // Keep previous_position consistent to avoid large implied velocities
@@ -181,6 +309,23 @@ void world::set_position(size_t idx, const vec2 &p)
         vel_x[idx] = 0.0f;
         vel_y[idx] = 0.0f;
     }
+    wake_body(idx);
+}
+
+void world::wake_body(size_t idx)
+{
+    if (!is_sleeping(idx))
+        return;
+    int island = (idx < sleep_island.size()) ? sleep_island[idx] : -1;
+    size_t n = sleeping.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i != idx && (island < 0 || i >= sleep_island.size() || sleep_island[i] != island))
+            continue;
+        sleeping[i] = 0;
+        if (i < sleep_timer.size())
+            sleep_timer[i] = 0.0f;
+    }
 }
 
 // Legacy conversion helpers removed; no legacy definitions remain here.
@@ -219,3 +364,35 @@ int world::get_grid_index(const vec2 &posicion) const
 
     return index;
 }
+
+void world::update_grid_dimensions()
+{
+    float width = grid_info.max_x - grid_info.min_x;
+    float height = grid_info.max_y - grid_info.min_y;
+
+    int numCellsX = std::max(1, static_cast<int>(std::ceil(width / grid_info.cell_size)));
+    int numCellsY = std::max(1, static_cast<int>(std::ceil(height / grid_info.cell_size)));
+
+    grid_info.num_cells_x = numCellsX;
+    grid_info.num_cells_y = numCellsY;
+
+    // One extra entry so cell c always spans [start[c], start[c + 1])
+    particle_start_indices.assign(numCellsX * numCellsY + 1, 0);
+}
+
+void world::set_time_step(float new_delta_time)
+{
+    if (new_delta_time == delta_time)
+        return;
+    if (delta_time > 0.0f)
+    {
+        float scale = new_delta_time / delta_time;
+        size_t n = size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            previous_position_x[i] = position_x[i] - (position_x[i] - previous_position_x[i]) * scale;
+            previous_position_y[i] = position_y[i] - (position_y[i] - previous_position_y[i]) * scale;
+        }
+    }
+    delta_time = new_delta_time;
+}
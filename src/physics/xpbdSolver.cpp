@@ -0,0 +1,239 @@
+#include "physics/xpbdSolver.hpp"
+#include "physics/contactSolver.hpp"
+#include "physics/world.hpp"
+#include <cmath>
+#include <algorithm>
+
+// Same floor as collisionSystem::solve_boundary_contacts
+const float XPBD_GROUND_Y = 0.0f;
+// Approach speeds below this many gravity steps do not bounce (resting jitter)
+const float XPBD_RESTITUTION_THRESHOLD_STEPS = 2.0f;
+
+const uint8_t WALL_FLOOR = 1;
+const uint8_t WALL_LEFT = 2;
+const uint8_t WALL_RIGHT = 4;
+const uint8_t WALL_CEILING = 8;
+
+xpbdSolver::xpbdSolver() {}
+
+void xpbdSolver::solve(world &simulation_world, const ContactBuffer &contacts, bool bounded)
+{
+    if (simulation_world.delta_time <= 0.0f)
+        return;
+
+    record_predicted_velocities(simulation_world, contacts);
+
+    lambda.assign(contacts.size(), 0.0f);
+    boundary_hits.assign(simulation_world.size(), 0);
+    int iterations = std::max(simulation_world.solver_settings.xpbd_iterations, 1);
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        solve_contact_constraints(simulation_world, contacts);
+        if (bounded)
+            project_boundaries(simulation_world);
+    }
+
+    derive_velocities(simulation_world, contacts);
+}
+
+// ====================================================================
+// --- PREDICTION ---
+// ====================================================================
+
+void xpbdSolver::record_predicted_velocities(world &simulation_world, const ContactBuffer &contacts)
+{
+    size_t n = simulation_world.size();
+    float inv_dt = 1.0f / simulation_world.delta_time;
+    predicted_vel_x.resize(n);
+    predicted_vel_y.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        predicted_vel_x[i] = (simulation_world.position_x[i] - simulation_world.previous_position_x[i]) * inv_dt;
+        predicted_vel_y[i] = (simulation_world.position_y[i] - simulation_world.previous_position_y[i]) * inv_dt;
+    }
+
+    contact_normal_velocity.resize(contacts.size());
+    for (size_t k = 0; k < contacts.size(); ++k)
+    {
+        int a = contacts.body_a[k];
+        int b = contacts.body_b[k];
+        contact_normal_velocity[k] = (predicted_vel_x[b] - predicted_vel_x[a]) * contacts.normal_x[k] +
+                                     (predicted_vel_y[b] - predicted_vel_y[a]) * contacts.normal_y[k];
+    }
+}
+
+// ====================================================================
+// --- POSITION CONSTRAINTS ---
+// ====================================================================
+
+void xpbdSolver::solve_contact_constraints(world &simulation_world, const ContactBuffer &contacts)
+{
+    float dt = simulation_world.delta_time;
+    float compliance = simulation_world.solver_settings.contact_compliance / (dt * dt);
+
+    for (size_t k = 0; k < contacts.size(); ++k)
+    {
+        int a = contacts.body_a[k];
+        int b = contacts.body_b[k];
+        float inverse_mass_A = simulation_world.inv_mass[a];
+        float inverse_mass_B = simulation_world.inv_mass[b];
+
+        float dx = simulation_world.position_x[b] - simulation_world.position_x[a];
+        float dy = simulation_world.position_y[b] - simulation_world.position_y[a];
+        float distance_squared = dx * dx + dy * dy;
+        float nx = contacts.normal_x[k];
+        float ny = contacts.normal_y[k];
+        float distance = 0.0f;
+        if (distance_squared > 1e-12f)
+        {
+            distance = std::sqrt(distance_squared);
+            nx = dx / distance;
+            ny = dy / distance;
+        }
+
+        // Inequality constraint: only separated when violated
+        float constraint = distance - (simulation_world.radius[a] + simulation_world.radius[b]);
+        if (constraint >= 0.0f)
+            continue;
+
+        float delta_lambda = (-constraint - compliance * lambda[k]) / (inverse_mass_A + inverse_mass_B + compliance);
+        delta_lambda = std::max(lambda[k] + delta_lambda, 0.0f) - lambda[k];
+        lambda[k] += delta_lambda;
+
+        simulation_world.position_x[a] -= nx * delta_lambda * inverse_mass_A;
+        simulation_world.position_y[a] -= ny * delta_lambda * inverse_mass_A;
+        simulation_world.position_x[b] += nx * delta_lambda * inverse_mass_B;
+        simulation_world.position_y[b] += ny * delta_lambda * inverse_mass_B;
+    }
+}
+
+// Walls have infinite mass and zero compliance: a projection.
+void xpbdSolver::project_boundaries(world &simulation_world)
+{
+    const GridInfo &grid = simulation_world.grid_info;
+    size_t n = simulation_world.dynamic_count;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (simulation_world.is_sleeping(i))
+            continue;
+
+        float r = simulation_world.radius[i];
+        float &px = simulation_world.position_x[i];
+        float &py = simulation_world.position_y[i];
+        if (py - r < XPBD_GROUND_Y)
+        {
+            py = XPBD_GROUND_Y + r;
+            boundary_hits[i] |= WALL_FLOOR;
+        }
+        if (px - r < grid.min_x)
+        {
+            px = grid.min_x + r;
+            boundary_hits[i] |= WALL_LEFT;
+        }
+        if (px + r > grid.max_x)
+        {
+            px = grid.max_x - r;
+            boundary_hits[i] |= WALL_RIGHT;
+        }
+        if (py + r > grid.max_y)
+        {
+            py = grid.max_y - r;
+            boundary_hits[i] |= WALL_CEILING;
+        }
+    }
+}
+
+// ====================================================================
+// --- VELOCITY UPDATE ---
+// ====================================================================
+
+// Velocity along one axis after a wall at side `toward_wall` (-1 below/left,
+// +1 above/right) pushed the body. A body moving into the wall bounces; one
+// that was already leaving keeps its predicted speed instead of the push.
+static float wall_velocity(float derived, float predicted, float toward_wall, float restitution, float bounce_threshold)
+{
+    float approach = predicted * toward_wall;
+    if (approach >= 0.0f)
+        return (approach > bounce_threshold) ? -predicted * restitution : 0.0f;
+    float away = -toward_wall;
+    return std::min(derived * away, predicted * away) * away;
+}
+
+void xpbdSolver::derive_velocities(world &simulation_world, const ContactBuffer &contacts)
+{
+    // Static bodies keep their (zero) velocities
+    size_t n = simulation_world.dynamic_count;
+    float dt = simulation_world.delta_time;
+    float inv_dt = 1.0f / dt;
+    float gravity = std::sqrt(simulation_world.gravity_x * simulation_world.gravity_x + simulation_world.gravity_y * simulation_world.gravity_y);
+    float bounce_threshold = XPBD_RESTITUTION_THRESHOLD_STEPS * gravity * dt;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        simulation_world.vel_x[i] = (simulation_world.position_x[i] - simulation_world.previous_position_x[i]) * inv_dt;
+        simulation_world.vel_y[i] = (simulation_world.position_y[i] - simulation_world.previous_position_y[i]) * inv_dt;
+    }
+
+    // Contact restitution: the normal velocity of a contact that was closing
+    // becomes -e times its approach speed. Whatever the positions moved beyond
+    // that (penetration left over from earlier steps) is not kept as velocity,
+    // otherwise resting piles would pop: a contact that was already separating
+    // leaves no faster than it did before the solve.
+    for (size_t k = 0; k < contacts.size(); ++k)
+    {
+        if (lambda[k] <= 0.0f)
+            continue;
+        int a = contacts.body_a[k];
+        int b = contacts.body_b[k];
+        float inverse_mass_A = simulation_world.inv_mass[a];
+        float inverse_mass_B = simulation_world.inv_mass[b];
+        float nx = contacts.normal_x[k];
+        float ny = contacts.normal_y[k];
+
+        float approach = contact_normal_velocity[k];
+        float velocity_along_normal = (simulation_world.vel_x[b] - simulation_world.vel_x[a]) * nx +
+                                      (simulation_world.vel_y[b] - simulation_world.vel_y[a]) * ny;
+        float target;
+        if (approach > 0.0f)
+        {
+            if (velocity_along_normal <= approach)
+                continue;
+            target = approach;
+        }
+        else
+        {
+            float restitution = (-approach > bounce_threshold) ? contacts.restitution[k] : 0.0f;
+            target = -restitution * approach;
+        }
+
+        float impulse = (target - velocity_along_normal) / (inverse_mass_A + inverse_mass_B);
+        simulation_world.vel_x[a] -= nx * impulse * inverse_mass_A;
+        simulation_world.vel_y[a] -= ny * impulse * inverse_mass_A;
+        simulation_world.vel_x[b] += nx * impulse * inverse_mass_B;
+        simulation_world.vel_y[b] += ny * impulse * inverse_mass_B;
+    }
+
+    // Wall restitution (the projection itself adds no velocity), then previous
+    // positions consistent with the final velocities
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint8_t hits = boundary_hits[i];
+        if (hits)
+        {
+            float restitution = simulation_world.get_restitution(i);
+            float &vx = simulation_world.vel_x[i];
+            float &vy = simulation_world.vel_y[i];
+            if (hits & WALL_FLOOR)
+                vy = wall_velocity(vy, predicted_vel_y[i], -1.0f, restitution, bounce_threshold);
+            if (hits & WALL_CEILING)
+                vy = wall_velocity(vy, predicted_vel_y[i], 1.0f, restitution, bounce_threshold);
+            if (hits & WALL_LEFT)
+                vx = wall_velocity(vx, predicted_vel_x[i], -1.0f, restitution, bounce_threshold);
+            if (hits & WALL_RIGHT)
+                vx = wall_velocity(vx, predicted_vel_x[i], 1.0f, restitution, bounce_threshold);
+        }
+
+        simulation_world.previous_position_x[i] = simulation_world.position_x[i] - simulation_world.vel_x[i] * dt;
+        simulation_world.previous_position_y[i] = simulation_world.position_y[i] - simulation_world.vel_y[i] * dt;
+    }
+}
@@ -2,18 +2,29 @@
 #include "physics/world.hpp"
 #include "physics/body.hpp"
 #include "math/vec2.hpp"
+#include "utils/threadPool.hpp"
 #include <iostream>
+#include <chrono>
 #include <cmath>
 #include <algorithm>
 #include <vector>
+#include <limits>
+#include <cstdlib>
 
 // ====================================================================
 // --- TUNING CONFIGURATION (Move to a header or settings) ---
 // ====================================================================
 // It's recommended to move these values to private members or a configuration class.
-const float POSITION_CORRECTION_SLOP = 0.001f;  // Minimum penetration before correcting
-const float POSITION_CORRECTION_PERCENT = 0.2f; // Percentage of penetration to correct (smaller to avoid energy loss)
 const float VELOCITY_EPSILON = 1e-6f;           // Threshold to snap velocity to zero (smaller to avoid early sleeping)
+const float AABB_TREE_MARGIN = 0.1f;            // Fat AABB margin (world units) for the AABB tree
+const float AABB_TREE_RADIUS_MARGIN = 0.1f;     // Extra fat margin proportional to the body radius
+const float DEFAULT_NEIGHBOUR_SKIN = 0.5f;      // Verlet list skin (world units) beyond the sum of radii
+const float WARM_START_FACTOR = 0.8f;           // Share of last frame's impulse re-applied (1 overshoots in dense piles)
+const float DEFAULT_CCD_MOTION_FRACTION = 0.5f; // Share of the radius a body may move per step before it is swept
+const float CCD_CONTACT_SLOP = 0.01f;           // Overlap left at the time of impact so the narrow phase sees the contact
+const float GROUND_Y_LIMIT = 0.0f;              // Floor used by solve_boundary_contacts
+const int GRID_BUILD_GRAIN = 8192;              // Bodies per block of the parallel grid build
+const int BOUNDARY_GRAIN = 4096;                // Bodies per parallel_for range in solve_boundary_contacts
 
 // ====================================================================
 // --- CONSTRUCTOR/DESTRUCTOR ---
@@ -22,29 +33,315 @@ const float VELOCITY_EPSILON = 1e-6f;           // Threshold to snap velocity to
 collisionSystem::collisionSystem() {}
 collisionSystem::~collisionSystem() {}
 
+void collisionSystem::set_pair_generation_mode(PairGenerationMode mode) { pair_mode = mode; }
+PairGenerationMode collisionSystem::get_pair_generation_mode() const { return pair_mode; }
+
+void collisionSystem::set_broad_phase(BroadPhaseType type)
+{
+    broad_phase = type;
+    reset_broad_phase_caches();
+}
+
+bool collisionSystem::has_world_bounds(const world &simulation_world) { return simulation_world.grid_info.bounded; }
+
+BroadPhaseType collisionSystem::active_broad_phase(const world &simulation_world) const
+{
+    if (broad_phase == BroadPhaseType::UNIFORM_GRID && !has_world_bounds(simulation_world))
+        return BroadPhaseType::HASHED_GRID;
+    return broad_phase;
+}
+
+void collisionSystem::reset_broad_phase_caches()
+{
+    sap_entries.clear();
+    tree.clear();
+    tree_proxies.clear();
+    hgrid_entries.clear();
+    hgrid_cells.clear();
+}
+BroadPhaseType collisionSystem::get_broad_phase() const { return broad_phase; }
+
+void collisionSystem::set_neighbour_list(bool enabled, float skin)
+{
+    neighbour_list_enabled = enabled;
+    neighbour_skin = (skin > 0.0f) ? skin : DEFAULT_NEIGHBOUR_SKIN;
+    neighbour_offsets.clear();
+}
+bool collisionSystem::get_neighbour_list_enabled() const { return neighbour_list_enabled; }
+
+void collisionSystem::set_continuous_collision(bool enabled, float motion_fraction)
+{
+    continuous_collision_enabled = enabled;
+    ccd_motion_fraction = (motion_fraction > 0.0f) ? motion_fraction : DEFAULT_CCD_MOTION_FRACTION;
+}
+bool collisionSystem::get_continuous_collision_enabled() const { return continuous_collision_enabled; }
+
+void collisionSystem::set_warm_starting(bool enabled)
+{
+    warm_starting = enabled;
+    contact_cache.clear();
+}
+bool collisionSystem::get_warm_starting() const { return warm_starting; }
+
+void collisionSystem::set_contact_solver(ContactSolverType type)
+{
+    contact_solver_type = type;
+    contact_cache.clear();
+}
+ContactSolverType collisionSystem::get_contact_solver() const { return contact_solver_type; }
+
+// Static or asleep: pairs of two such bodies need no test at all
+static bool is_resting(const world &simulation_world, int idx)
+{
+    return simulation_world.inv_mass[idx] == 0.0f || simulation_world.is_sleeping(idx);
+}
+
+void collisionSystem::set_solver_threads(int threads)
+{
+    solver_threads = threads;
+    solver_pool.reset();
+}
+int collisionSystem::get_solver_threads() const
+{
+    if (shared_pool && solver_threads <= 0)
+        return shared_pool->thread_count();
+    if (solver_threads <= 0)
+        return 1;
+    return solver_pool ? solver_pool->thread_count() : solver_threads;
+}
+
+threadPool *collisionSystem::worker_pool()
+{
+    if (solver_threads <= 0)
+        return shared_pool;
+    if (!solver_pool)
+        solver_pool = std::make_unique<threadPool>(solver_threads);
+    return solver_pool.get();
+}
+
 // ====================================================================
 // --- GRID PHASES (Spatial Hashing) ---
 // ====================================================================
 
-void collisionSystem::clear_spatial_grid(world &simulation_world)
+// Counting sort of the dynamic body indices by cell into the flat world columns,
+// split into contiguous blocks of bodies that run on the worker pool:
+// 1. cell id per body and count per block and cell (parallel), 2. prefix sum over
+// cells then blocks (serial, num_cells * blocks), 3. scatter (parallel, each
+// block writes at its own offsets). Blocks are scattered in body order, so
+// indices stay ascending inside a cell and the result does not depend on the
+// block count. No per-cell allocations; every cell becomes a contiguous range
+// of sorted_indices.
+void collisionSystem::populate_spatial_grid(world &simulation_world)
 {
-    for (auto &cell_body_list : simulation_world.grid)
+    refresh_static_grid(simulation_world);
+
+    size_t n = simulation_world.dynamic_count;
+    int num_cells = simulation_world.num_grid_cells();
+
+    std::vector<int> &cell_id = simulation_world.particle_cell_id;
+    std::vector<int> &cell_start = simulation_world.particle_start_indices;
+    std::vector<int> &sorted = simulation_world.sorted_indices;
+
+    // Sleeping bodies have not moved since their cell was computed
+    bool cells_valid = cell_id.size() == n && grid_layout_version == simulation_world.body_layout_version &&
+                       grid_cell_awake.size() == (size_t)num_cells;
+    cell_id.resize(n);
+    cell_start.assign(num_cells + 1, 0);
+    grid_cell_awake.assign(num_cells, 0);
+
+    threadPool *pool = worker_pool();
+    int threads = pool ? pool->thread_count() : 1;
+    int blocks = std::max(1, std::min(threads, (int)(n / GRID_BUILD_GRAIN)));
+    auto for_each_block = [&](auto &&task)
+    {
+        if (pool)
+            pool->parallel_for(blocks, task, 1);
+        else
+            task(0, blocks);
+    };
+    grid_block_counts.assign((size_t)blocks * num_cells, 0);
+    grid_block_awake.assign((size_t)blocks * num_cells, 0);
+    auto block_begin = [&](int block)
+    { return (size_t)((uint64_t)n * block / blocks); };
+
+    // 1. Cell ids and per-block counts
+    for_each_block([&](int first_block, int last_block)
+                   {
+        for (int block = first_block; block < last_block; ++block)
+        {
+            int *counts = &grid_block_counts[(size_t)block * num_cells];
+            int *awake = &grid_block_awake[(size_t)block * num_cells];
+            for (size_t i = block_begin(block); i < block_begin(block + 1); ++i)
+            {
+                bool sleeping = simulation_world.is_sleeping(i);
+                int grid_index;
+                if (cells_valid && sleeping)
+                    grid_index = cell_id[i];
+                else
+                    grid_index = simulation_world.get_grid_index(vec2(simulation_world.position_x[i], simulation_world.position_y[i]));
+                cell_id[i] = grid_index;
+                if (grid_index >= 0)
+                {
+                    ++counts[grid_index];
+                    if (!sleeping)
+                        ++awake[grid_index];
+                }
+            }
+        } });
+    grid_layout_version = simulation_world.body_layout_version;
+
+    // 2. Exclusive prefix sum: cell c starts at cell_start[c], and block b
+    //    writes its bodies of cell c from grid_block_counts[b * num_cells + c]
+    int running_total = 0;
+    for (int c = 0; c < num_cells; ++c)
     {
-        cell_body_list.clear();
+        cell_start[c] = running_total;
+        for (int block = 0; block < blocks; ++block)
+        {
+            size_t entry = (size_t)block * num_cells + c;
+            int count = grid_block_counts[entry];
+            grid_block_counts[entry] = running_total;
+            running_total += count;
+            grid_cell_awake[c] += grid_block_awake[entry];
+        }
     }
+    cell_start[num_cells] = running_total;
+
+    // 3. Scatter
+    sorted.resize(running_total);
+    for_each_block([&](int first_block, int last_block)
+                   {
+        for (int block = first_block; block < last_block; ++block)
+        {
+            int *offsets = &grid_block_counts[(size_t)block * num_cells];
+            for (size_t i = block_begin(block); i < block_begin(block + 1); ++i)
+            {
+                int c = cell_id[i];
+                if (c >= 0)
+                    sorted[offsets[c]++] = (int)i;
+            }
+        } });
 }
 
-void collisionSystem::populate_spatial_grid(world &simulation_world)
+// Same counting sort over the static range [dynamic_count, size). Level
+// geometry made of thousands of static circles is binned once instead of
+// every frame.
+void collisionSystem::refresh_static_grid(world &simulation_world)
+{
+    const GridInfo &grid = simulation_world.grid_info;
+    int num_cells = simulation_world.num_grid_cells();
+    size_t begin = simulation_world.dynamic_count;
+    size_t n = simulation_world.size();
+    if (static_cell_start.size() == (size_t)num_cells + 1 && static_grid_version == simulation_world.static_layout_version &&
+        static_grid_bodies == n - begin && static_grid_min_x == grid.min_x && static_grid_min_y == grid.min_y &&
+        static_grid_cells_x == grid.num_cells_x && static_grid_cells_y == grid.num_cells_y)
+        return;
+
+    static_grid_version = simulation_world.static_layout_version;
+    static_grid_bodies = n - begin;
+    static_grid_min_x = grid.min_x;
+    static_grid_min_y = grid.min_y;
+    static_grid_cells_x = grid.num_cells_x;
+    static_grid_cells_y = grid.num_cells_y;
+    ++static_grid_builds;
+
+    std::vector<int> cell_id(n - begin);
+    static_cell_start.assign(num_cells + 1, 0);
+    for (size_t i = begin; i < n; ++i)
+    {
+        int grid_index = simulation_world.get_grid_index(vec2(simulation_world.position_x[i], simulation_world.position_y[i]));
+        cell_id[i - begin] = grid_index;
+        if (grid_index >= 0)
+            ++static_cell_start[grid_index];
+    }
+
+    int running_total = 0;
+    for (int c = 0; c < num_cells; ++c)
+    {
+        running_total += static_cell_start[c];
+        static_cell_start[c] = running_total;
+    }
+    static_cell_start[num_cells] = running_total;
+
+    static_sorted_indices.resize(running_total);
+    for (size_t i = n; i-- > begin;)
+    {
+        int c = cell_id[i - begin];
+        if (c >= 0)
+            static_sorted_indices[--static_cell_start[c]] = (int)i;
+    }
+}
+
+// ====================================================================
+// --- SWEEP AND PRUNE ---
+// ====================================================================
+
+void collisionSystem::update_sweep_and_prune(world &simulation_world)
 {
     size_t n = simulation_world.position_x.size();
+    bool needs_full_sort = false;
+
+    if (sap_entries.size() != n)
+    {
+        sap_entries.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            sap_entries[i].body = (int)i;
+        needs_full_sort = true;
+    }
+    if (n == 0)
+        return;
+
+    // Axis of greatest variance (single pass, sums relative to the first body for precision)
+    float ref_x = simulation_world.position_x[0];
+    float ref_y = simulation_world.position_y[0];
+    double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_yy = 0.0;
     for (size_t i = 0; i < n; ++i)
     {
-        vec2 pos(simulation_world.position_x[i], simulation_world.position_y[i]);
-        int grid_index = simulation_world.get_grid_index(pos);
-        if (grid_index >= 0)
+        double dx = simulation_world.position_x[i] - ref_x;
+        double dy = simulation_world.position_y[i] - ref_y;
+        sum_x += dx;
+        sum_y += dy;
+        sum_xx += dx * dx;
+        sum_yy += dy * dy;
+    }
+    double variance_x = sum_xx - sum_x * sum_x / double(n);
+    double variance_y = sum_yy - sum_y * sum_y / double(n);
+    int axis = (variance_y > variance_x) ? 1 : 0;
+    if (axis != sap_axis)
+    {
+        sap_axis = axis;
+        needs_full_sort = true;
+    }
+
+    const std::vector<float> &sweep_pos = (sap_axis == 0) ? simulation_world.position_x : simulation_world.position_y;
+    const std::vector<float> &other_pos = (sap_axis == 0) ? simulation_world.position_y : simulation_world.position_x;
+    for (auto &entry : sap_entries)
+    {
+        float r = simulation_world.radius[entry.body] + broad_phase_margin;
+        entry.min = sweep_pos[entry.body] - r;
+        entry.max = sweep_pos[entry.body] + r;
+        entry.other_min = other_pos[entry.body] - r;
+        entry.other_max = other_pos[entry.body] + r;
+    }
+
+    if (needs_full_sort)
+    {
+        std::sort(sap_entries.begin(), sap_entries.end(), [](const SapEntry &a, const SapEntry &b)
+                  { return a.min < b.min; });
+        return;
+    }
+
+    // Insertion sort: bodies barely move between Verlet steps, so this is ~O(n)
+    for (size_t i = 1; i < n; ++i)
+    {
+        SapEntry key = sap_entries[i];
+        size_t j = i;
+        while (j > 0 && sap_entries[j - 1].min > key.min)
         {
-            simulation_world.grid[grid_index].push_back((int)i);
+            sap_entries[j] = sap_entries[j - 1];
+            --j;
         }
+        sap_entries[j] = key;
     }
 }
 
@@ -52,23 +349,220 @@ void collisionSystem::populate_spatial_grid(world &simulation_world)
 // --- BROAD PHASE: Generate Candidate Pairs ---
 // ====================================================================
 
-std::vector<std::pair<int, int>> collisionSystem::broad_phase_generate_pairs(world &simulation_world)
+// ====================================================================
+// --- AABB TREE (Dynamic BVH) ---
+// ====================================================================
+
+static AABB body_aabb(const world &simulation_world, size_t i)
 {
-    std::vector<std::pair<int, int>> potential_collision_pairs;
+    float r = simulation_world.radius[i];
+    AABB box;
+    box.min_x = simulation_world.position_x[i] - r;
+    box.min_y = simulation_world.position_y[i] - r;
+    box.max_x = simulation_world.position_x[i] + r;
+    box.max_y = simulation_world.position_y[i] + r;
+    return box;
+}
+
+void collisionSystem::update_aabb_tree(world &simulation_world)
+{
+    size_t n = simulation_world.position_x.size();
+
+    if (tree_proxies.size() != n)
+    {
+        tree.clear();
+        tree_proxies.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            float margin = AABB_TREE_MARGIN + AABB_TREE_RADIUS_MARGIN * simulation_world.radius[i];
+            tree_proxies[i] = tree.create_proxy(body_aabb(simulation_world, i), (int)i, margin);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (is_resting(simulation_world, (int)i) && aabb_contains(tree.get_fat_aabb(tree_proxies[i]), body_aabb(simulation_world, i)))
+            continue; // static or asleep, and still enclosed
+
+        float margin = AABB_TREE_MARGIN + AABB_TREE_RADIUS_MARGIN * simulation_world.radius[i];
+        // Verlet displacement of the last step predicts the next one
+        float dx = simulation_world.position_x[i] - simulation_world.previous_position_x[i];
+        float dy = simulation_world.position_y[i] - simulation_world.previous_position_y[i];
+        tree.move_proxy(tree_proxies[i], body_aabb(simulation_world, i), margin, dx, dy);
+    }
+}
+
+// ====================================================================
+// --- HIERARCHICAL GRID (radius classes) ---
+// ====================================================================
+
+// Cell coordinates are biased into 30 bits each; the level takes the top 4 bits.
+static const int64_t HGRID_COORD_BIAS = int64_t(1) << 29;
+static const uint64_t HGRID_COORD_MASK = (uint64_t(1) << 30) - 1;
+
+static uint64_t hgrid_key(int level, int64_t cx, int64_t cy)
+{
+    return (uint64_t(level) << 60) | ((uint64_t(cy + HGRID_COORD_BIAS) & HGRID_COORD_MASK) << 30) | (uint64_t(cx + HGRID_COORD_BIAS) & HGRID_COORD_MASK);
+}
+
+// Level L cell coordinates are clamped to [-(2^28 >> L), (2^28 >> L) - 1], so
+// keys and their +-1 neighbours never wrap. Bodies beyond the range share the
+// edge cells (more candidate pairs, none missed), and the limits halve with
+// each level, so clamping agrees with the parent shift of the pair walk.
+static const int64_t HGRID_COORD_LIMIT = int64_t(1) << 28;
+
+static int64_t hgrid_cell_coord(float offset, float cell_size, int level)
+{
+    int64_t limit = HGRID_COORD_LIMIT >> level;
+    float c = std::floor(offset / cell_size);
+    if (!(c > (float)-limit)) // also catches NaN
+        return -limit;
+    if (c >= (float)limit)
+        return limit - 1;
+    return (int64_t)c;
+}
+
+static int64_t hgrid_cell_x(uint64_t key) { return int64_t(key & HGRID_COORD_MASK) - HGRID_COORD_BIAS; }
+static int64_t hgrid_cell_y(uint64_t key) { return int64_t((key >> 30) & HGRID_COORD_MASK) - HGRID_COORD_BIAS; }
+static int hgrid_level(uint64_t key) { return int(key >> 60); }
+
+void collisionSystem::update_hierarchical_grid(world &simulation_world)
+{
+    size_t n = simulation_world.position_x.size();
+    hgrid_entries.resize(n);
+    hgrid_cells.clear();
+    hgrid_occupied_levels = 0;
+    if (n == 0)
+        return;
+
+    // Finest level fits the smallest body, unless the largest one would then
+    // need more than HGRID_MAX_LEVELS doublings
+    float min_radius = simulation_world.radius[0];
+    float max_radius = simulation_world.radius[0];
+    for (size_t i = 1; i < n; ++i)
+    {
+        min_radius = std::min(min_radius, simulation_world.radius[i]);
+        max_radius = std::max(max_radius, simulation_world.radius[i]);
+    }
+    float max_diameter = 2.0f * (max_radius + broad_phase_margin);
+    hgrid_base_cell_size = std::max({2.0f * min_radius, 1e-3f, std::ldexp(max_diameter, -(HGRID_MAX_LEVELS - 1))});
+
+    float origin_x = simulation_world.grid_info.min_x;
+    float origin_y = simulation_world.grid_info.min_y;
+    for (size_t i = 0; i < n; ++i)
+    {
+        float diameter = 2.0f * (simulation_world.radius[i] + broad_phase_margin);
+        int level = 0;
+        float cell_size = hgrid_base_cell_size;
+        while (cell_size < diameter && level < HGRID_MAX_LEVELS - 1)
+        {
+            cell_size *= 2.0f;
+            ++level;
+        }
+        int64_t cx = hgrid_cell_coord(simulation_world.position_x[i] - origin_x, cell_size, level);
+        int64_t cy = hgrid_cell_coord(simulation_world.position_y[i] - origin_y, cell_size, level);
+        hgrid_entries[i].key = hgrid_key(level, cx, cy);
+        hgrid_entries[i].body = (int)i;
+        hgrid_occupied_levels |= (1u << level);
+    }
+
+    std::sort(hgrid_entries.begin(), hgrid_entries.end(), [](const HGridEntry &a, const HGridEntry &b)
+              { return a.key < b.key || (a.key == b.key && a.body < b.body); });
+
+    // Compact runs of equal keys into the occupied cell table
+    int begin = 0;
+    for (int k = 1; k <= (int)n; ++k)
+    {
+        if (k == (int)n || hgrid_entries[k].key != hgrid_entries[begin].key)
+        {
+            hgrid_cells.push_back({hgrid_entries[begin].key, begin, k});
+            begin = k;
+        }
+    }
+}
+
+int collisionSystem::find_hgrid_cell(uint64_t key) const
+{
+    auto it = std::lower_bound(hgrid_cells.begin(), hgrid_cells.end(), key, [](const HGridCell &cell, uint64_t k)
+                               { return cell.key < k; });
+    if (it == hgrid_cells.end() || it->key != key)
+        return -1;
+    return (int)(it - hgrid_cells.begin());
+}
+
+// Shared by the materialized and streaming paths. With skip_resting_pairs,
+// pairs of two static or sleeping bodies never reach `visit`.
+template <typename PairVisitor>
+void collisionSystem::for_each_candidate_pair(world &simulation_world, PairVisitor &&visit)
+{
+    if (!skip_resting_pairs)
+    {
+        for_each_broad_phase_pair(simulation_world, visit);
+        return;
+    }
+    for_each_broad_phase_pair(simulation_world, [&](int idxA, int idxB)
+                              {
+                                  if (is_resting(simulation_world, idxA) && is_resting(simulation_world, idxB))
+                                      return;
+                                  visit(idxA, idxB); });
+}
 
+// Dispatches to the walker of the selected broad phase.
+template <typename PairVisitor>
+void collisionSystem::for_each_broad_phase_pair(world &simulation_world, PairVisitor &&visit)
+{
+    switch (active_broad_phase(simulation_world))
+    {
+    case BroadPhaseType::SWEEP_AND_PRUNE:
+        for_each_sap_pair(visit);
+        break;
+    case BroadPhaseType::AABB_TREE:
+        for_each_tree_pair(simulation_world, visit);
+        break;
+    case BroadPhaseType::HIERARCHICAL_GRID:
+        for_each_hgrid_pair(visit);
+        break;
+    case BroadPhaseType::HASHED_GRID:
+        for_each_hash_grid_pair(visit);
+        break;
+    case BroadPhaseType::UNIFORM_GRID:
+    default:
+        for_each_grid_pair(simulation_world, visit);
+        break;
+    }
+}
+
+// Walks the contiguous cell ranges of the flat grid with a half stencil and hands
+// every candidate pair to `visit`.
+template <typename PairVisitor>
+void collisionSystem::for_each_grid_pair(world &simulation_world, PairVisitor &&visit)
+{
     int num_cells_x = simulation_world.grid_info.num_cells_x;
     int num_cells_y = simulation_world.grid_info.num_cells_y;
+    int num_cells = simulation_world.num_grid_cells();
+    const std::vector<int> &cell_start = simulation_world.particle_start_indices;
+    const std::vector<int> &sorted = simulation_world.sorted_indices;
 
-    // Neighbor offsets: only check right, down, and down-right to avoid duplicates
-    const int neighbor_offsets[3][2] = {
-        {1, 0}, // Right
-        {0, 1}, // Down
-        {1, 1}  // Down-Right
+    // Half stencil: every neighbouring cell pair is visited exactly once
+    const int neighbor_offsets[4][2] = {
+        {1, 0},  // Right
+        {-1, 1}, // Down-Left
+        {0, 1},  // Down
+        {1, 1}   // Down-Right
     };
 
-    for (size_t cell_index = 0; cell_index < simulation_world.grid.size(); ++cell_index)
+    // Two cells without an awake dynamic body cannot produce a pair to solve
+    bool skip_resting_cells = skip_resting_pairs && grid_cell_awake.size() == (size_t)num_cells;
+    bool has_static_grid = static_cell_start.size() == (size_t)num_cells + 1 && !static_sorted_indices.empty();
+
+    for (int cell_index = 0; cell_index < num_cells; ++cell_index)
     {
-        auto &current_cell_bodies = simulation_world.grid[cell_index];
+        int begin = cell_start[cell_index];
+        int end = cell_start[cell_index + 1];
+        if (begin == end)
+            continue;
+        bool cell_resting = skip_resting_cells && grid_cell_awake[cell_index] == 0;
 
         int current_cell_y = cell_index / num_cells_x;
         int current_cell_x = cell_index % num_cells_x;
@@ -76,44 +570,530 @@ std::vector<std::pair<int, int>> collisionSystem::broad_phase_generate_pairs(wor
         // 1. Check against neighbor cells
         for (const auto &offset : neighbor_offsets)
         {
-            int offset_x = offset[0];
-            int offset_y = offset[1];
+            int neighbor_cell_x = current_cell_x + offset[0];
+            int neighbor_cell_y = current_cell_y + offset[1];
 
-            int neighbor_cell_x = current_cell_x + offset_x;
-            int neighbor_cell_y = current_cell_y + offset_y;
-
-            if (neighbor_cell_x >= num_cells_x || neighbor_cell_y >= num_cells_y)
+            if (neighbor_cell_x < 0 || neighbor_cell_x >= num_cells_x || neighbor_cell_y >= num_cells_y)
             {
                 continue;
             }
 
             int neighbor_index = neighbor_cell_y * num_cells_x + neighbor_cell_x;
-            auto &neighbor_cell_bodies = simulation_world.grid[neighbor_index];
+            if (cell_resting && grid_cell_awake[neighbor_index] == 0)
+                continue;
+            int neighbor_begin = cell_start[neighbor_index];
+            int neighbor_end = cell_start[neighbor_index + 1];
 
-            for (int idxA : current_cell_bodies)
+            for (int a = begin; a < end; ++a)
             {
-                for (int idxB : neighbor_cell_bodies)
+                for (int b = neighbor_begin; b < neighbor_end; ++b)
                 {
-                    potential_collision_pairs.emplace_back(idxA, idxB);
+                    visit(sorted[a], sorted[b]);
                 }
             }
         }
 
         // 2. Check within the same cell
-        for (size_t i = 0; i < current_cell_bodies.size(); ++i)
+        if (cell_resting)
+            continue;
+        for (int a = begin; a < end; ++a)
+        {
+            for (int b = a + 1; b < end; ++b)
+            {
+                visit(sorted[a], sorted[b]);
+            }
+        }
+
+        // 3. Check against the static bodies of the surrounding 3x3 cells. Static
+        //    bodies are never binned with the dynamic ones, so every static pair
+        //    is found from its dynamic side only, and static/static pairs never come up.
+        if (!has_static_grid)
+            continue;
+        int static_x0 = std::max(current_cell_x - 1, 0);
+        int static_x1 = std::min(current_cell_x + 1, num_cells_x - 1);
+        int static_y0 = std::max(current_cell_y - 1, 0);
+        int static_y1 = std::min(current_cell_y + 1, num_cells_y - 1);
+        for (int static_y = static_y0; static_y <= static_y1; ++static_y)
         {
-            int idxA = current_cell_bodies[i];
-            for (size_t j = i + 1; j < current_cell_bodies.size(); ++j)
+            for (int static_x = static_x0; static_x <= static_x1; ++static_x)
             {
-                int idxB = current_cell_bodies[j];
-                potential_collision_pairs.emplace_back(idxA, idxB);
+                int static_index = static_y * num_cells_x + static_x;
+                int static_begin = static_cell_start[static_index];
+                int static_end = static_cell_start[static_index + 1];
+                for (int a = begin; a < end; ++a)
+                {
+                    for (int b = static_begin; b < static_end; ++b)
+                    {
+                        visit(sorted[a], static_sorted_indices[b]);
+                    }
+                }
             }
         }
     }
+}
 
+// Sweeps the sorted intervals: every entry is tested against the following ones
+// until their min passes its max, then filtered on the other axis.
+template <typename PairVisitor>
+void collisionSystem::for_each_sap_pair(PairVisitor &&visit)
+{
+    size_t n = sap_entries.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        const SapEntry &a = sap_entries[i];
+        for (size_t j = i + 1; j < n; ++j)
+        {
+            const SapEntry &b = sap_entries[j];
+            if (b.min > a.max)
+                break;
+            if (b.other_min > a.other_max || b.other_max < a.other_min)
+                continue;
+            visit(a.body, b.body);
+        }
+    }
+}
+
+// Each dynamic body queries the tree with its tight box. Since tight boxes sit inside
+// fat boxes, every overlapping pair is found from both sides: keep j > i for
+// dynamic/dynamic pairs and let the dynamic body report pairs with static ones.
+// Static bodies never query, which is what keeps level geometry cheap.
+template <typename PairVisitor>
+void collisionSystem::for_each_tree_pair(world &simulation_world, PairVisitor &&visit)
+{
+    // Sleeping bodies do not query either when resting pairs are skipped
+    auto queries = [&](int idx)
+    {
+        return simulation_world.inv_mass[idx] != 0.0f && !(skip_resting_pairs && simulation_world.is_sleeping(idx));
+    };
+    size_t n = simulation_world.position_x.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!queries((int)i))
+            continue;
+        int idxA = (int)i;
+        // Both sides' margins go on the query box; the stored fat boxes cover the tight ones
+        AABB query_box = body_aabb(simulation_world, i);
+        query_box.min_x -= 2.0f * broad_phase_margin;
+        query_box.min_y -= 2.0f * broad_phase_margin;
+        query_box.max_x += 2.0f * broad_phase_margin;
+        query_box.max_y += 2.0f * broad_phase_margin;
+        tree.query(query_box, [&](int idxB)
+                   {
+                       if (idxB == idxA)
+                           return;
+                       if (queries(idxB) && idxB < idxA)
+                           return;
+                       visit(idxA, idxB); });
+    }
+}
+
+// Every occupied cell is tested against its own level (same cell + half stencil)
+// and against the 3x3 neighbourhood of its parent cell on each coarser occupied
+// level. A coarser cell is at least as wide as both diameters, so any contact
+// lies within one coarse cell; finer levels are never visited, so no pair repeats.
+template <typename PairVisitor>
+void collisionSystem::for_each_hgrid_pair(PairVisitor &&visit)
+{
+    const int half_stencil[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+
+    for (const HGridCell &cell : hgrid_cells)
+    {
+        int level = hgrid_level(cell.key);
+        int64_t cx = hgrid_cell_x(cell.key);
+        int64_t cy = hgrid_cell_y(cell.key);
+
+        // 1. Same level: inside the cell, then the half stencil
+        for (int a = cell.begin; a < cell.end; ++a)
+        {
+            for (int b = a + 1; b < cell.end; ++b)
+            {
+                visit(hgrid_entries[a].body, hgrid_entries[b].body);
+            }
+        }
+        for (const auto &offset : half_stencil)
+        {
+            int neighbor = find_hgrid_cell(hgrid_key(level, cx + offset[0], cy + offset[1]));
+            if (neighbor < 0)
+                continue;
+            const HGridCell &other = hgrid_cells[neighbor];
+            for (int a = cell.begin; a < cell.end; ++a)
+            {
+                for (int b = other.begin; b < other.end; ++b)
+                {
+                    visit(hgrid_entries[a].body, hgrid_entries[b].body);
+                }
+            }
+        }
+
+        // 2. Coarser levels: cells are aligned, so the parent cell is a shift away
+        for (int coarse = level + 1; coarse < HGRID_MAX_LEVELS; ++coarse)
+        {
+            if (!(hgrid_occupied_levels & (1u << coarse)))
+                continue;
+            int shift = coarse - level;
+            // Arithmetic shift floors negative coordinates too
+            int64_t pcx = cx >> shift;
+            int64_t pcy = cy >> shift;
+            for (int oy = -1; oy <= 1; ++oy)
+            {
+                for (int ox = -1; ox <= 1; ++ox)
+                {
+                    int neighbor = find_hgrid_cell(hgrid_key(coarse, pcx + ox, pcy + oy));
+                    if (neighbor < 0)
+                        continue;
+                    const HGridCell &other = hgrid_cells[neighbor];
+                    for (int a = cell.begin; a < cell.end; ++a)
+                    {
+                        for (int b = other.begin; b < other.end; ++b)
+                        {
+                            visit(hgrid_entries[a].body, hgrid_entries[b].body);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Same half-stencil walk as the flat grid, over occupied cells only; neighbours
+// are found through the hash table, so there are no bounds to fall outside of.
+template <typename PairVisitor>
+void collisionSystem::for_each_hash_grid_pair(PairVisitor &&visit)
+{
+    const int half_stencil[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+    const std::vector<hashGrid::Cell> &cells = hash_grid.cells();
+    const std::vector<int> &sorted = hash_grid.sorted_bodies();
+
+    for (const hashGrid::Cell &cell : cells)
+    {
+        for (int a = cell.begin; a < cell.end; ++a)
+        {
+            for (int b = a + 1; b < cell.end; ++b)
+            {
+                visit(sorted[a], sorted[b]);
+            }
+        }
+        for (const auto &offset : half_stencil)
+        {
+            int neighbor = hash_grid.find_cell(cell.cx + offset[0], cell.cy + offset[1]);
+            if (neighbor < 0)
+                continue;
+            const hashGrid::Cell &other = cells[neighbor];
+            for (int a = cell.begin; a < cell.end; ++a)
+            {
+                for (int b = other.begin; b < other.end; ++b)
+                {
+                    visit(sorted[a], sorted[b]);
+                }
+            }
+        }
+    }
+}
+
+std::vector<std::pair<int, int>> collisionSystem::broad_phase_generate_pairs(world &simulation_world)
+{
+    std::vector<std::pair<int, int>> potential_collision_pairs;
+    for_each_candidate_pair(simulation_world, [&](int idxA, int idxB)
+                            { potential_collision_pairs.emplace_back(idxA, idxB); });
     return potential_collision_pairs;
 }
 
+// ====================================================================
+// --- VERLET NEIGHBOUR LISTS ---
+// ====================================================================
+
+// The list stays valid while no body has moved more than half the skin since the
+// build: two bodies then closed their gap by at most one skin.
+bool collisionSystem::neighbour_list_is_stale(const world &simulation_world) const
+{
+    size_t n = simulation_world.position_x.size();
+    if (neighbour_offsets.size() != n + 1 || simulation_world.body_layout_version != neighbour_layout_version)
+        return true;
+
+    float half_skin = 0.5f * neighbour_skin;
+    float limit_squared = half_skin * half_skin;
+    for (size_t i = 0; i < n; ++i)
+    {
+        float dx = simulation_world.position_x[i] - neighbour_reference_x[i];
+        float dy = simulation_world.position_y[i] - neighbour_reference_y[i];
+        if (dx * dx + dy * dy > limit_squared)
+            return true;
+    }
+    return false;
+}
+
+// Runs the selected broad phase with every body inflated by half the skin and keeps
+// pairs closer than the sum of radii plus the skin, stored per lower body index (CSR).
+// The uniform and hashed grids cannot widen their stencil: there the skin only
+// helps while the largest diameter plus the skin fits in GridInfo::cell_size.
+void collisionSystem::rebuild_neighbour_list(world &simulation_world)
+{
+    size_t n = simulation_world.position_x.size();
+
+    broad_phase_margin = 0.5f * neighbour_skin;
+    bool skip_resting = skip_resting_pairs;
+    skip_resting_pairs = false;
+    prepare_broad_phase(simulation_world);
+
+    std::vector<std::pair<int, int>> close_pairs;
+    for_each_candidate_pair(simulation_world, [&](int idxA, int idxB)
+                            {
+                                if (simulation_world.inv_mass[idxA] == 0.0f && simulation_world.inv_mass[idxB] == 0.0f)
+                                    return;
+                                float dx = simulation_world.position_x[idxA] - simulation_world.position_x[idxB];
+                                float dy = simulation_world.position_y[idxA] - simulation_world.position_y[idxB];
+                                float reach = simulation_world.radius[idxA] + simulation_world.radius[idxB] + neighbour_skin;
+                                if (dx * dx + dy * dy <= reach * reach)
+                                    close_pairs.emplace_back(std::min(idxA, idxB), std::max(idxA, idxB)); });
+    broad_phase_margin = 0.0f;
+    skip_resting_pairs = skip_resting;
+
+    // Counting sort of the pairs by owner into offsets / neighbours
+    neighbour_offsets.assign(n + 1, 0);
+    for (const auto &pair : close_pairs)
+        ++neighbour_offsets[pair.first + 1];
+    for (size_t i = 0; i < n; ++i)
+        neighbour_offsets[i + 1] += neighbour_offsets[i];
+    neighbour_indices.resize(close_pairs.size());
+    std::vector<int> cursor(neighbour_offsets.begin(), neighbour_offsets.end() - 1);
+    for (const auto &pair : close_pairs)
+        neighbour_indices[cursor[pair.first]++] = pair.second;
+
+    neighbour_reference_x = simulation_world.position_x;
+    neighbour_reference_y = simulation_world.position_y;
+    neighbour_layout_version = simulation_world.body_layout_version;
+}
+
+// Most frames are a linear scan of the compact list.
+void collisionSystem::refresh_neighbour_list(world &simulation_world)
+{
+    if (neighbour_list_is_stale(simulation_world))
+    {
+        rebuild_neighbour_list(simulation_world);
+        ++simulation_world.neighbour_list_rebuilds;
+    }
+}
+
+void collisionSystem::neighbour_list_check_and_resolve(world &simulation_world)
+{
+    auto t_b0 = std::chrono::high_resolution_clock::now();
+    refresh_neighbour_list(simulation_world);
+    auto t_b1 = std::chrono::high_resolution_clock::now();
+    simulation_world.broad_phase_us = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(t_b1 - t_b0).count();
+
+    auto t_n0 = std::chrono::high_resolution_clock::now();
+    int n = (int)simulation_world.position_x.size();
+    for (int idxA = 0; idxA < n; ++idxA)
+    {
+        for (int k = neighbour_offsets[idxA]; k < neighbour_offsets[idxA + 1]; ++k)
+        {
+            process_candidate_pair(idxA, neighbour_indices[k], simulation_world);
+        }
+    }
+    auto t_n1 = std::chrono::high_resolution_clock::now();
+    simulation_world.narrow_phase_us = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(t_n1 - t_n0).count();
+}
+
+// ====================================================================
+// --- ITERATIVE SOLVER PATH ---
+// ====================================================================
+
+void collisionSystem::collect_contacts(world &simulation_world, float contact_margin)
+{
+    // Broad phase: neighbour list refresh or backend preparation.
+    // A neighbour list only guarantees pairs that touch, so the margin is best effort there.
+    auto t_b0 = std::chrono::high_resolution_clock::now();
+    if (neighbour_list_enabled)
+        refresh_neighbour_list(simulation_world);
+    else
+    {
+        broad_phase_margin = 0.5f * contact_margin;
+        prepare_broad_phase(simulation_world);
+    }
+    auto t_b1 = std::chrono::high_resolution_clock::now();
+    simulation_world.broad_phase_us = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(t_b1 - t_b0).count();
+
+    // Narrow phase: collect the overlapping pairs into the contact buffer
+    auto t_n0 = std::chrono::high_resolution_clock::now();
+    contact_solver.clear();
+    auto collect = [&](int idxA, int idxB)
+    {
+        if (is_resting(simulation_world, idxA) && is_resting(simulation_world, idxB))
+            return;
+        if (contact_solver.add_contact(simulation_world, idxA, idxB, contact_margin))
+            wake_touching_pair(idxA, idxB, simulation_world);
+    };
+    if (neighbour_list_enabled)
+    {
+        int n = (int)simulation_world.position_x.size();
+        for (int idxA = 0; idxA < n; ++idxA)
+        {
+            for (int k = neighbour_offsets[idxA]; k < neighbour_offsets[idxA + 1]; ++k)
+                collect(idxA, neighbour_indices[k]);
+        }
+    }
+    else
+    {
+        for_each_candidate_pair(simulation_world, collect);
+        broad_phase_margin = 0.0f;
+    }
+    auto t_n1 = std::chrono::high_resolution_clock::now();
+    simulation_world.narrow_phase_us = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(t_n1 - t_n0).count();
+}
+
+void collisionSystem::iterative_check_and_resolve(world &simulation_world)
+{
+    collect_contacts(simulation_world);
+
+    // Resolution: iterate the whole buffer (in parallel for GRAPH_COLORED, JACOBI and ISLANDS)
+    auto t_r0 = std::chrono::high_resolution_clock::now();
+    ContactIteration iteration = ContactIteration::SEQUENTIAL;
+    if (contact_solver_type == ContactSolverType::GRAPH_COLORED)
+        iteration = ContactIteration::COLORED;
+    else if (contact_solver_type == ContactSolverType::JACOBI)
+        iteration = ContactIteration::JACOBI;
+    else if (contact_solver_type == ContactSolverType::ISLANDS)
+        iteration = ContactIteration::ISLANDS;
+    threadPool *pool = (iteration != ContactIteration::SEQUENTIAL) ? worker_pool() : nullptr;
+    contact_solver.solve(simulation_world, warm_starting ? &contact_cache : nullptr, iteration, pool);
+    auto t_r1 = std::chrono::high_resolution_clock::now();
+    simulation_world.resolve_phase_us += (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(t_r1 - t_r0).count();
+
+    simulation_world.solver_contacts += contact_solver.contacts().size();
+    int colors = contact_solver.color_count();
+    simulation_world.contact_colors = std::max(simulation_world.contact_colors, (unsigned long long)colors);
+    for (int c = 0; c < colors; ++c)
+        simulation_world.largest_color_batch = std::max(simulation_world.largest_color_batch, (unsigned long long)contact_solver.color_batch_size(c));
+
+    int islands = contact_solver.island_count();
+    simulation_world.island_count += (unsigned long long)islands;
+    const std::vector<int> &island_bodies = contact_solver.get_island_body_counts();
+    const std::vector<long long> &island_ns = contact_solver.get_island_solve_ns();
+    long long total_ns = 0;
+    long long largest_ns = 0;
+    for (int i = 0; i < islands; ++i)
+    {
+        total_ns += island_ns[i];
+        largest_ns = std::max(largest_ns, island_ns[i]);
+
+        size_t bucket = 0;
+        for (int bodies = island_bodies[i]; bodies > 1; bodies >>= 1)
+            ++bucket;
+        if (bucket >= simulation_world.island_size_histogram.size())
+            simulation_world.island_size_histogram.resize(bucket + 1, 0);
+        ++simulation_world.island_size_histogram[bucket];
+    }
+    simulation_world.island_solve_us += (unsigned long long)(total_ns / 1000);
+    simulation_world.largest_island_us = std::max(simulation_world.largest_island_us, (unsigned long long)(largest_ns / 1000));
+}
+
+void collisionSystem::xpbd_check_and_resolve(world &simulation_world)
+{
+    // Pairs that only touch after the floor or another contact pushes them
+    // must already be in the buffer when the constraints are iterated
+    collect_contacts(simulation_world, simulation_world.solver_settings.xpbd_contact_margin);
+
+    auto t_r0 = std::chrono::high_resolution_clock::now();
+    xpbd_solver.solve(simulation_world, contact_solver.contacts(), has_world_bounds(simulation_world));
+    auto t_r1 = std::chrono::high_resolution_clock::now();
+    simulation_world.resolve_phase_us += (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(t_r1 - t_r0).count();
+    simulation_world.solver_contacts += contact_solver.contacts().size();
+}
+
+// ====================================================================
+// --- WARM STARTING ---
+// ====================================================================
+
+// Re-applies last frame's accumulated impulse of every contact that still
+// touches, before any pair is solved. Resting contacts then start close to
+// their converged impulse and the single pass only has to correct the change.
+void collisionSystem::warm_start_contacts(world &simulation_world)
+{
+    size_t n = simulation_world.position_x.size();
+    float dt = simulation_world.delta_time;
+
+    // 1. Test every contact before any impulse moves the bodies
+    warm_contacts.clear();
+    contact_cache.for_each_previous([&](int idxA, int idxB, contactCache::Contact contact)
+                                    {
+        if ((size_t)idxB >= n || contact.resting_impulse <= 0.0f)
+            return;
+        if (simulation_world.is_sleeping(idxA) || simulation_world.is_sleeping(idxB))
+            return;
+        float dx = simulation_world.position_x[idxB] - simulation_world.position_x[idxA];
+        float dy = simulation_world.position_y[idxB] - simulation_world.position_y[idxA];
+        float distance_squared = dx * dx + dy * dy;
+        float sum_of_radii = simulation_world.radius[idxA] + simulation_world.radius[idxB];
+        if (distance_squared <= 1e-6f || distance_squared >= sum_of_radii * sum_of_radii)
+            return;
+
+        float inv_distance = 1.0f / std::sqrt(distance_squared);
+        float normal_x = dx * inv_distance;
+        float normal_y = dy * inv_distance;
+        float approach_velocity = (simulation_world.vel_x[idxB] - simulation_world.vel_x[idxA]) * normal_x +
+                                  (simulation_world.vel_y[idxB] - simulation_world.vel_y[idxA]) * normal_y;
+        // Already separating: its old impulse would only be taken back by the
+        // narrow phase, but the contacts solved before that would see it
+        if (approach_velocity > 0.0f)
+            return;
+
+        // Resting contacts aim for 0; one hit hard enough to bounce keeps its restitution
+        contact.target_velocity = 0.0f;
+        if (-approach_velocity > simulation_world.solver_settings.bounce_threshold)
+            contact.target_velocity = -(simulation_world.get_restitution(idxA) + simulation_world.get_restitution(idxB)) * 0.5f * approach_velocity;
+        contact.solved = false;
+        WarmContact warm;
+        warm.idxA = idxA;
+        warm.idxB = idxB;
+        // Only the part of the old impulse along the new normal carries over
+        float alignment = normal_x * contact.normal_x + normal_y * contact.normal_y;
+        contact.normal_impulse = contact.resting_impulse * WARM_START_FACTOR * std::max(alignment, 0.0f);
+        contact.normal_x = normal_x;
+        contact.normal_y = normal_y;
+        warm.impulse_x = normal_x * contact.normal_impulse;
+        warm.impulse_y = normal_y * contact.normal_impulse;
+        warm_contacts.push_back(warm);
+
+        // Carried into this frame: the narrow phase reads it back as the applied impulse
+        contact_cache.store(idxA, idxB, contact); });
+
+    // 2. Apply the cached impulses
+    for (const WarmContact &warm : warm_contacts)
+    {
+        float inverse_mass_A = simulation_world.inv_mass[warm.idxA];
+        float inverse_mass_B = simulation_world.inv_mass[warm.idxB];
+        simulation_world.vel_x[warm.idxA] -= warm.impulse_x * inverse_mass_A;
+        simulation_world.vel_y[warm.idxA] -= warm.impulse_y * inverse_mass_A;
+        simulation_world.vel_x[warm.idxB] += warm.impulse_x * inverse_mass_B;
+        simulation_world.vel_y[warm.idxB] += warm.impulse_y * inverse_mass_B;
+    }
+
+    // 3. Keep the Verlet state consistent with the new velocities
+    if (dt > 0.0f)
+    {
+        for (const WarmContact &warm : warm_contacts)
+        {
+            for (int idx : {warm.idxA, warm.idxB})
+            {
+                simulation_world.previous_position_x[idx] = simulation_world.position_x[idx] - simulation_world.vel_x[idx] * dt;
+                simulation_world.previous_position_y[idx] = simulation_world.position_y[idx] - simulation_world.vel_y[idx] * dt;
+            }
+        }
+    }
+}
+
+// Warm-started contacts the narrow phase skipped (pushed apart by earlier pairs
+// before their turn) still carry the impulse applied at the start of the frame.
+void collisionSystem::settle_warm_started_contacts(world &simulation_world)
+{
+    for (const WarmContact &warm : warm_contacts)
+    {
+        const contactCache::Contact *contact = contact_cache.find(warm.idxA, warm.idxB);
+        if (contact && !contact->solved)
+            resolve_contact_with_impulse(warm.idxA, warm.idxB, simulation_world);
+    }
+}
+
 // ====================================================================
 // --- CIRCLE-CIRCLE CHECK (Narrow Phase Detection) ---
 // ====================================================================
@@ -135,6 +1115,24 @@ bool collisionSystem::check_for_overlap(int idxA, int idxB, world &simulation_wo
 // --- NARROW PHASE: Check and Resolve ---
 // ====================================================================
 
+void collisionSystem::process_candidate_pair(int idxA, int idxB, world &simulation_world)
+{
+    if (is_resting(simulation_world, idxA) && is_resting(simulation_world, idxB))
+        return;
+
+    if (check_for_overlap(idxA, idxB, simulation_world))
+    {
+        wake_touching_pair(idxA, idxB, simulation_world);
+        if (simulation_world.sleep_settings.enabled)
+            contact_solver.link_bodies(simulation_world, idxA, idxB);
+        auto t_r0 = std::chrono::high_resolution_clock::now();
+        resolve_contact_with_impulse(idxA, idxB, simulation_world);
+        auto t_r1 = std::chrono::high_resolution_clock::now();
+        auto resolve_us = std::chrono::duration_cast<std::chrono::microseconds>(t_r1 - t_r0).count();
+        simulation_world.resolve_phase_us += (unsigned long long)resolve_us;
+    }
+}
+
 void collisionSystem::narrow_phase_check_and_resolve(world &simulation_world)
 {
     // Broad phase timing
@@ -142,26 +1140,45 @@ void collisionSystem::narrow_phase_check_and_resolve(world &simulation_world)
     auto potential_pairs = broad_phase_generate_pairs(simulation_world);
     auto t_b1 = std::chrono::high_resolution_clock::now();
     auto broad_us = std::chrono::duration_cast<std::chrono::microseconds>(t_b1 - t_b0).count();
-    simulation_world.broad_phase_us = (unsigned long long)broad_us;
+    simulation_world.broad_phase_us += (unsigned long long)broad_us;
 
     // Narrow phase timing
     auto t_n0 = std::chrono::high_resolution_clock::now();
     for (auto &[idxA, idxB] : potential_pairs)
     {
-        float invA = simulation_world.inv_mass[idxA];
-        float invB = simulation_world.inv_mass[idxB];
-        if (invA == 0.0f && invB == 0.0f)
-            continue;
+        process_candidate_pair(idxA, idxB, simulation_world);
+    }
+    auto t_n1 = std::chrono::high_resolution_clock::now();
+    auto narrow_us = std::chrono::duration_cast<std::chrono::microseconds>(t_n1 - t_n0).count();
+    simulation_world.narrow_phase_us = (unsigned long long)narrow_us;
+}
+
+// Fused broad + narrow phase: candidates go into a small fixed-size batch while the
+// cell stencil is walked and the batch is tested/resolved as soon as it fills up.
+// Pairs are processed in the same order as the materialized path, so results match.
+// The walk is counted as narrow phase time (broad phase only covers the grid build).
+void collisionSystem::streaming_check_and_resolve(world &simulation_world)
+{
+    auto t_n0 = std::chrono::high_resolution_clock::now();
 
-        if (check_for_overlap(idxA, idxB, simulation_world))
+    std::pair<int, int> batch[PAIR_BATCH_SIZE];
+    int batch_count = 0;
+    auto flush_batch = [&]()
+    {
+        for (int k = 0; k < batch_count; ++k)
         {
-            auto t_r0 = std::chrono::high_resolution_clock::now();
-            resolve_contact_with_impulse(idxA, idxB, simulation_world);
-            auto t_r1 = std::chrono::high_resolution_clock::now();
-            auto resolve_us = std::chrono::duration_cast<std::chrono::microseconds>(t_r1 - t_r0).count();
-            simulation_world.resolve_phase_us += (unsigned long long)resolve_us;
+            process_candidate_pair(batch[k].first, batch[k].second, simulation_world);
         }
-    }
+        batch_count = 0;
+    };
+
+    for_each_candidate_pair(simulation_world, [&](int idxA, int idxB)
+                            {
+                                batch[batch_count++] = std::make_pair(idxA, idxB);
+                                if (batch_count == PAIR_BATCH_SIZE)
+                                    flush_batch(); });
+    flush_batch();
+
     auto t_n1 = std::chrono::high_resolution_clock::now();
     auto narrow_us = std::chrono::duration_cast<std::chrono::microseconds>(t_n1 - t_n0).count();
     simulation_world.narrow_phase_us = (unsigned long long)narrow_us;
@@ -184,7 +1201,11 @@ void collisionSystem::resolve_contact_with_impulse(int idxA, int idxB, world &si
     float distance = std::sqrt(distance_squared);
     float sum_of_radii = simulation_world.radius[idxA] + simulation_world.radius[idxB];
     float penetration_depth = sum_of_radii - distance;
-    if (penetration_depth <= 0.0f)
+
+    // Contact carried over from the previous frame; its impulse was already
+    // applied by warm_start_contacts()
+    const contactCache::Contact *cached = warm_starting ? contact_cache.find(idxA, idxB) : nullptr;
+    if (penetration_depth <= 0.0f && !cached)
         return;
 
     vec2 collision_normal = displacement_vector * (1.0f / distance);
@@ -195,7 +1216,8 @@ void collisionSystem::resolve_contact_with_impulse(int idxA, int idxB, world &si
     if (inverse_mass_sum <= 0.0f)
         return;
 
-    float correction_magnitude = std::max(penetration_depth - POSITION_CORRECTION_SLOP, 0.0f) / inverse_mass_sum * POSITION_CORRECTION_PERCENT;
+    const SolverSettings &settings = simulation_world.solver_settings;
+    float correction_magnitude = std::max(penetration_depth - settings.position_correction_slop, 0.0f) / inverse_mass_sum * settings.position_correction_percent;
     vec2 position_correction_vector = collision_normal * correction_magnitude;
 
     // Apply correction to SoA positions
@@ -209,14 +1231,37 @@ void collisionSystem::resolve_contact_with_impulse(int idxA, int idxB, world &si
     vec2 velB(simulation_world.vel_x[idxB], simulation_world.vel_y[idxB]);
     vec2 relative_velocity = velB - velA;
     float velocity_along_normal = dot(relative_velocity, collision_normal);
-    if (velocity_along_normal > 0.0f)
-        return;
 
-    float effective_restitution = (simulation_world.get_restitution(idxA) + simulation_world.get_restitution(idxB)) * 0.5f;
+    // A new contact bounces with the approach speed it arrives with; a
+    // warm-started one keeps the target warm_start_contacts() gave it
+    contactCache::Contact contact;
+    if (cached)
+    {
+        contact = *cached;
+    }
+    else
+    {
+        if (velocity_along_normal > 0.0f)
+            return;
+        float effective_restitution = (simulation_world.get_restitution(idxA) + simulation_world.get_restitution(idxB)) * 0.5f;
+        contact.target_velocity = -effective_restitution * velocity_along_normal;
+    }
+    float cached_impulse = contact.normal_impulse;
 
-    float impulse_scalar = -(1.0f + effective_restitution) * velocity_along_normal;
-    impulse_scalar /= inverse_mass_sum;
-    vec2 collision_impulse_vector = collision_normal * impulse_scalar;
+    // Accumulated impulse is clamped to >= 0 (contacts only push); only the change is applied
+    float accumulated_impulse = std::max(cached_impulse + (contact.target_velocity - velocity_along_normal) / inverse_mass_sum, 0.0f);
+    if (warm_starting)
+    {
+        contact.solved = true;
+        contact.normal_impulse = accumulated_impulse;
+        // Share that only stops the approach: the bounce is not carried over
+        contact.resting_impulse = std::min(accumulated_impulse, std::max(cached_impulse - velocity_along_normal / inverse_mass_sum, 0.0f));
+        contact.normal_x = collision_normal.x;
+        contact.normal_y = collision_normal.y;
+        contact_cache.store(idxA, idxB, contact);
+    }
+
+    vec2 collision_impulse_vector = collision_normal * (accumulated_impulse - cached_impulse);
 
     velA = velA - collision_impulse_vector * inverse_mass_A;
     velB = velB + collision_impulse_vector * inverse_mass_B;
@@ -237,18 +1282,21 @@ void collisionSystem::resolve_contact_with_impulse(int idxA, int idxB, world &si
     }
 
     // Ensure positions are nudged slightly outward to avoid exact-contact re-penetration
-    const float BOUNDARY_EPS = 1e-4f;
-    // clamp A
-    float min_x = simulation_world.grid_info.min_x;
-    float max_x = simulation_world.grid_info.max_x;
-    float min_y = simulation_world.grid_info.min_y;
-    float max_y = simulation_world.grid_info.max_y;
-    float rA = simulation_world.radius[idxA];
-    float rB = simulation_world.radius[idxB];
-    simulation_world.position_x[idxA] = std::min(std::max(simulation_world.position_x[idxA], min_x + rA + BOUNDARY_EPS), max_x - rA - BOUNDARY_EPS);
-    simulation_world.position_y[idxA] = std::min(std::max(simulation_world.position_y[idxA], min_y + rA + BOUNDARY_EPS), max_y - rA - BOUNDARY_EPS);
-    simulation_world.position_x[idxB] = std::min(std::max(simulation_world.position_x[idxB], min_x + rB + BOUNDARY_EPS), max_x - rB - BOUNDARY_EPS);
-    simulation_world.position_y[idxB] = std::min(std::max(simulation_world.position_y[idxB], min_y + rB + BOUNDARY_EPS), max_y - rB - BOUNDARY_EPS);
+    if (has_world_bounds(simulation_world))
+    {
+        const float BOUNDARY_EPS = 1e-4f;
+        // clamp A
+        float min_x = simulation_world.grid_info.min_x;
+        float max_x = simulation_world.grid_info.max_x;
+        float min_y = simulation_world.grid_info.min_y;
+        float max_y = simulation_world.grid_info.max_y;
+        float rA = simulation_world.radius[idxA];
+        float rB = simulation_world.radius[idxB];
+        simulation_world.position_x[idxA] = std::min(std::max(simulation_world.position_x[idxA], min_x + rA + BOUNDARY_EPS), max_x - rA - BOUNDARY_EPS);
+        simulation_world.position_y[idxA] = std::min(std::max(simulation_world.position_y[idxA], min_y + rA + BOUNDARY_EPS), max_y - rA - BOUNDARY_EPS);
+        simulation_world.position_x[idxB] = std::min(std::max(simulation_world.position_x[idxB], min_x + rB + BOUNDARY_EPS), max_x - rB - BOUNDARY_EPS);
+        simulation_world.position_y[idxB] = std::min(std::max(simulation_world.position_y[idxB], min_y + rB + BOUNDARY_EPS), max_y - rB - BOUNDARY_EPS);
+    }
 
     // 4. LOW-VELOCITY ELIMINATION (Sleeping) - operate on SoA velocities
     if (std::fabs(simulation_world.vel_x[idxA]) < VELOCITY_EPSILON)
@@ -267,76 +1315,442 @@ void collisionSystem::resolve_contact_with_impulse(int idxA, int idxB, world &si
 
 void collisionSystem::solve_boundary_contacts(world &simulation_world)
 {
-    size_t n = simulation_world.position_x.size();
+    // Static bodies never move, so only the dynamic range can leave the box
+    size_t n = simulation_world.dynamic_count;
     float min_x = simulation_world.grid_info.min_x;
     float max_x = simulation_world.grid_info.max_x;
     float min_y = simulation_world.grid_info.min_y;
     float max_y = simulation_world.grid_info.max_y;
-    const float ground_y_limit = 0.0f;
+    const float ground_y_limit = GROUND_Y_LIMIT;
+    float dt = simulation_world.delta_time;
+    // Without bounds the pass only snaps small velocities and re-derives previous positions
+    bool bounded = has_world_bounds(simulation_world);
 
+    // Bodies are independent: ranges run on the worker pool
+    auto solve_range = [&](int begin, int end)
+    {
+        for (size_t i = (size_t)begin; i < (size_t)end; ++i)
+        {
+            if (simulation_world.is_sleeping(i))
+                continue;
+
+            float px = simulation_world.position_x[i];
+            float py = simulation_world.position_y[i];
+            float vx = simulation_world.vel_x[i];
+            float vy = simulation_world.vel_y[i];
+            float r = simulation_world.radius[i];
+            float restitution = simulation_world.get_restitution(i);
+
+            if (bounded)
+            {
+                if (py - r < ground_y_limit)
+                {
+                    py = ground_y_limit + r;
+                    if (vy < 0.0f)
+                        vy = -vy * restitution;
+                }
+
+                if (px - r < min_x)
+                {
+                    px = min_x + r;
+                    if (vx < 0.0f)
+                        vx = -vx * restitution;
+                }
+
+                if (px + r > max_x)
+                {
+                    px = max_x - r;
+                    if (vx > 0.0f)
+                        vx = -vx * restitution;
+                }
+
+                if (py + r > max_y)
+                {
+                    py = max_y - r;
+                    if (vy > 0.0f)
+                        vy = -vy * restitution;
+                }
+            }
+
+            if (std::fabs(vx) < VELOCITY_EPSILON)
+                vx = 0.0f;
+            if (std::fabs(vy) < VELOCITY_EPSILON)
+                vy = 0.0f;
+
+            simulation_world.position_x[i] = px;
+            simulation_world.position_y[i] = py;
+            simulation_world.vel_x[i] = vx;
+            simulation_world.vel_y[i] = vy;
+
+            if (dt > 0.0f)
+            {
+                simulation_world.previous_position_x[i] = px - vx * dt;
+                simulation_world.previous_position_y[i] = py - vy * dt;
+            }
+            // small inward nudge to avoid exact contact with boundaries which can cause
+            // re-penetration or sticky behavior due to floating point rounding.
+            const float NUDGE = 1e-4f;
+            if (bounded)
+            {
+                simulation_world.position_x[i] = std::min(std::max(simulation_world.position_x[i], min_x + r + NUDGE), max_x - r - NUDGE);
+                simulation_world.position_y[i] = std::min(std::max(simulation_world.position_y[i], min_y + r + NUDGE), max_y - r - NUDGE);
+            }
+        }
+    };
+    if (threadPool *pool = worker_pool())
+        pool->parallel_for((int)n, solve_range, BOUNDARY_GRAIN);
+    else
+        solve_range(0, (int)n);
+}
+
+// ====================================================================
+// --- CONTINUOUS COLLISION (swept circles) ---
+// ====================================================================
+
+// Earliest t in [0, 1] at which a circle starting at (x0, y0) and moving by
+// (dx, dy) comes within `reach` of the point (cx, cy). Pairs already within
+// reach at t = 0 or moving apart are left to the discrete phases.
+static bool swept_circle_time_of_impact(float x0, float y0, float dx, float dy, float cx, float cy, float reach, float &t_out)
+{
+    float mx = x0 - cx;
+    float my = y0 - cy;
+    float c = mx * mx + my * my - reach * reach;
+    float half_b = mx * dx + my * dy;
+    if (c <= 0.0f || half_b >= 0.0f)
+        return false;
+    float a = dx * dx + dy * dy;
+    float discriminant = half_b * half_b - a * c;
+    if (discriminant < 0.0f)
+        return false;
+    float t = (-half_b - std::sqrt(discriminant)) / a;
+    if (t > 1.0f)
+        return false;
+    t_out = t;
+    return true;
+}
+
+// Time at which a coordinate moving from `start` by `delta` crosses `limit`
+// (the furthest the body centre may go toward a wall).
+static void clip_to_wall(float start, float delta, float limit, float &t_hit)
+{
+    float end = start + delta;
+    bool crosses = (delta < 0.0f) ? (start >= limit && end < limit) : (start <= limit && end > limit);
+    if (crosses)
+        t_hit = std::min(t_hit, (limit - start) / delta);
+}
+
+// Runs on the end-of-step positions left by the integrator. The swept AABB of
+// each fast body, inflated by the largest radius, is rasterized onto the
+// uniform grids (dynamic and static), so candidates come from the cells the
+// sweep crosses whatever broad phase is selected. Without world bounds
+// (GridInfo::bounded) the uniform grids would miss everything outside GridInfo, so
+// dynamic and static bodies are looked up in the hash grid instead, walking
+// only the cells along the swept segment. Fast
+// bodies are handled one after another, each against the positions the
+// earlier ones were pulled back to.
+void collisionSystem::solve_continuous_collisions(world &simulation_world)
+{
+    size_t n = simulation_world.size();
+    ccd_fast_bodies.clear();
+    float max_radius = 0.0f;
     for (size_t i = 0; i < n; ++i)
     {
-        if (simulation_world.inv_mass[i] == 0.0f)
+        float r = simulation_world.radius[i];
+        max_radius = std::max(max_radius, r);
+        if (simulation_world.is_static(i) || simulation_world.is_sleeping(i))
             continue;
+        float dx = simulation_world.position_x[i] - simulation_world.previous_position_x[i];
+        float dy = simulation_world.position_y[i] - simulation_world.previous_position_y[i];
+        float limit = ccd_motion_fraction * r;
+        if (dx * dx + dy * dy > limit * limit)
+            ccd_fast_bodies.push_back((int)i);
+    }
+    if (ccd_fast_bodies.empty())
+        return;
+    simulation_world.ccd_bodies += ccd_fast_bodies.size();
 
-        float px = simulation_world.position_x[i];
-        float py = simulation_world.position_y[i];
-        float vx = simulation_world.vel_x[i];
-        float vy = simulation_world.vel_y[i];
-        float r = simulation_world.radius[i];
-        float restitution = simulation_world.get_restitution(i);
+    bool bounded = has_world_bounds(simulation_world);
+    const GridInfo &grid = simulation_world.grid_info;
+    if (bounded)
+        populate_spatial_grid(simulation_world);
+    else
+        hash_grid.build(simulation_world.position_x.data(), simulation_world.position_y.data(), n, grid.cell_size);
+    // Candidates come from both grids: the dynamic one and the cached static one
+    const std::vector<int> *cell_starts[2] = {&simulation_world.particle_start_indices, &static_cell_start};
+    const std::vector<int> *sorted_ids[2] = {&simulation_world.sorted_indices, &static_sorted_indices};
+    const std::vector<hashGrid::Cell> &hash_cells = hash_grid.cells();
+    const std::vector<int> &hash_sorted = hash_grid.sorted_bodies();
+
+    for (int idx : ccd_fast_bodies)
+    {
+        float r = simulation_world.radius[idx];
+        float x0 = simulation_world.previous_position_x[idx];
+        float y0 = simulation_world.previous_position_y[idx];
+        float dx = simulation_world.position_x[idx] - x0;
+        float dy = simulation_world.position_y[idx] - y0;
+        float t_hit = 1.0f;
+
+        auto sweep_against = [&](int other)
+        {
+            if (other == idx)
+                return;
+            float contact_reach = r + simulation_world.radius[other] - CCD_CONTACT_SLOP;
+            float t;
+            if (swept_circle_time_of_impact(x0, y0, dx, dy, simulation_world.position_x[other], simulation_world.position_y[other], contact_reach, t))
+                t_hit = std::min(t_hit, t);
+        };
 
-        if (py - r < ground_y_limit)
+        float reach = r + max_radius;
+        if (!bounded)
         {
-            py = ground_y_limit + r;
-            if (vy < 0.0f)
-                vy = -vy * restitution;
+            // Walk the cells the swept segment crosses (DDA) and take every
+            // occupied cell within `reach` of them
+            float inv_cell_size = 1.0f / grid.cell_size;
+            int32_t cx = hashGrid::cell_coord(x0, inv_cell_size);
+            int32_t cy = hashGrid::cell_coord(y0, inv_cell_size);
+            int32_t end_cx = hashGrid::cell_coord(x0 + dx, inv_cell_size);
+            int32_t end_cy = hashGrid::cell_coord(y0 + dy, inv_cell_size);
+            int ring = (int)std::ceil(reach * inv_cell_size);
+            long long steps = std::llabs((long long)end_cx - cx) + std::llabs((long long)end_cy - cy);
+            long long block = (2LL * ring + 1) * (2LL * ring + 1);
+            if ((steps + 1) * block > (long long)hash_cells.size())
+            {
+                // Longer walk than there are occupied cells: test every body
+                for (int other : hash_sorted)
+                    sweep_against(other);
+            }
+            else
+            {
+                float span_x = (x0 + dx) * inv_cell_size - x0 * inv_cell_size;
+                float span_y = (y0 + dy) * inv_cell_size - y0 * inv_cell_size;
+                int step_x = (span_x > 0.0f) ? 1 : -1;
+                int step_y = (span_y > 0.0f) ? 1 : -1;
+                const float never = std::numeric_limits<float>::infinity();
+                float t_delta_x = (span_x != 0.0f) ? 1.0f / std::fabs(span_x) : never;
+                float t_delta_y = (span_y != 0.0f) ? 1.0f / std::fabs(span_y) : never;
+                float t_max_x = (span_x != 0.0f) ? ((float)(cx + (step_x > 0 ? 1 : 0)) - x0 * inv_cell_size) / span_x : never;
+                float t_max_y = (span_y != 0.0f) ? ((float)(cy + (step_y > 0 ? 1 : 0)) - y0 * inv_cell_size) / span_y : never;
+
+                ccd_hash_cells.clear();
+                for (long long visited = 0; visited <= steps; ++visited)
+                {
+                    for (int oy = -ring; oy <= ring; ++oy)
+                    {
+                        for (int ox = -ring; ox <= ring; ++ox)
+                        {
+                            int cell = hash_grid.find_cell(cx + ox, cy + oy);
+                            if (cell >= 0)
+                                ccd_hash_cells.push_back(cell);
+                        }
+                    }
+                    // Rounding may disagree with the end cell: never step past it on an axis
+                    bool advance_x = (cy == end_cy) || (cx != end_cx && t_max_x < t_max_y);
+                    if (advance_x)
+                    {
+                        cx += step_x;
+                        t_max_x += t_delta_x;
+                    }
+                    else
+                    {
+                        cy += step_y;
+                        t_max_y += t_delta_y;
+                    }
+                }
+                std::sort(ccd_hash_cells.begin(), ccd_hash_cells.end());
+                ccd_hash_cells.erase(std::unique(ccd_hash_cells.begin(), ccd_hash_cells.end()), ccd_hash_cells.end());
+                for (int cell : ccd_hash_cells)
+                {
+                    for (int k = hash_cells[cell].begin; k < hash_cells[cell].end; ++k)
+                        sweep_against(hash_sorted[k]);
+                }
+            }
+        }
+        else
+        {
+            // Cells under the swept AABB, grown by the largest radius
+            float sweep_min_x = std::min(x0, x0 + dx) - reach;
+            float sweep_min_y = std::min(y0, y0 + dy) - reach;
+            float sweep_max_x = std::max(x0, x0 + dx) + reach;
+            float sweep_max_y = std::max(y0, y0 + dy) + reach;
+            int cell_x0 = std::max(0, (int)std::floor((sweep_min_x - grid.min_x) / grid.cell_size));
+            int cell_y0 = std::max(0, (int)std::floor((sweep_min_y - grid.min_y) / grid.cell_size));
+            int cell_x1 = std::min(grid.num_cells_x - 1, (int)std::floor((sweep_max_x - grid.min_x) / grid.cell_size));
+            int cell_y1 = std::min(grid.num_cells_y - 1, (int)std::floor((sweep_max_y - grid.min_y) / grid.cell_size));
+            for (int cy = cell_y0; cy <= cell_y1; ++cy)
+            {
+                for (int cx = cell_x0; cx <= cell_x1; ++cx)
+                {
+                    int cell = cy * grid.num_cells_x + cx;
+                    for (int g = 0; g < 2; ++g)
+                    {
+                        const std::vector<int> &cell_start = *cell_starts[g];
+                        const std::vector<int> &sorted = *sorted_ids[g];
+                        for (int k = cell_start[cell]; k < cell_start[cell + 1]; ++k)
+                            sweep_against(sorted[k]);
+                    }
+                }
+            }
         }
 
-        if (px - r < min_x)
+        if (bounded)
         {
-            px = min_x + r;
-            if (vx < 0.0f)
-                vx = -vx * restitution;
+            clip_to_wall(y0, dy, GROUND_Y_LIMIT + r, t_hit);
+            clip_to_wall(y0, dy, grid.max_y - r, t_hit);
+            clip_to_wall(x0, dx, grid.min_x + r, t_hit);
+            clip_to_wall(x0, dx, grid.max_x - r, t_hit);
         }
+        if (t_hit >= 1.0f)
+            continue;
+
+        // Stop at the impact; the step displacement (the Verlet velocity) is kept
+        float hit_x = x0 + dx * t_hit;
+        float hit_y = y0 + dy * t_hit;
+        simulation_world.position_x[idx] = hit_x;
+        simulation_world.position_y[idx] = hit_y;
+        simulation_world.previous_position_x[idx] = hit_x - dx;
+        simulation_world.previous_position_y[idx] = hit_y - dy;
+        ++simulation_world.ccd_impacts;
+    }
+}
+
+// ====================================================================
+// --- SLEEPING ---
+// ====================================================================
+
+// A sleeping body that an awake body touches wakes up and is solved with it.
+// Waking its island is batched: one scan per step however many islands were hit.
+void collisionSystem::wake_touching_pair(int idxA, int idxB, world &simulation_world)
+{
+    for (int idx : {idxA, idxB})
+    {
+        if (!simulation_world.is_sleeping(idx))
+            continue;
+        simulation_world.sleeping[idx] = 0;
+        simulation_world.sleep_timer[idx] = 0.0f;
+        woken_islands.push_back(simulation_world.sleep_island[idx]);
+    }
+}
 
-        if (px + r > max_x)
+// Islands come from the contact solver's union-find, filled by the narrow
+// phase of every solver path. An island falls asleep as a whole, so a body
+// resting on a moving one stays awake.
+void collisionSystem::update_sleep(world &simulation_world)
+{
+    const SleepSettings &settings = simulation_world.sleep_settings;
+    size_t n = simulation_world.size();
+    if (!settings.enabled || simulation_world.sleeping.size() != n || simulation_world.sleep_timer.size() != n || simulation_world.sleep_island.size() != n)
+    {
+        // Disabling sleep wakes everything
+        if (simulation_world.sleeping_bodies > 0)
         {
-            px = max_x - r;
-            if (vx > 0.0f)
-                vx = -vx * restitution;
+            std::fill(simulation_world.sleeping.begin(), simulation_world.sleeping.end(), 0);
+            std::fill(simulation_world.sleep_timer.begin(), simulation_world.sleep_timer.end(), 0.0f);
         }
+        simulation_world.sleeping_bodies = 0;
+        return;
+    }
 
-        if (py + r > max_y)
+    // Speed is measured on the displacement since the last step: the stored
+    // velocity lags gravity by half a step and never reads zero in a pile
+    bool reference_valid = sleep_reference_x.size() == n && sleep_layout_version == simulation_world.body_layout_version;
+    // 0. Islands touched during the step wake as a whole
+    if (!woken_islands.empty())
+    {
+        std::sort(woken_islands.begin(), woken_islands.end());
+        for (size_t i = 0; i < n; ++i)
         {
-            py = max_y - r;
-            if (vy > 0.0f)
-                vy = -vy * restitution;
+            if (simulation_world.sleeping[i] && std::binary_search(woken_islands.begin(), woken_islands.end(), simulation_world.sleep_island[i]))
+            {
+                simulation_world.sleeping[i] = 0;
+                simulation_world.sleep_timer[i] = 0.0f;
+            }
         }
+        woken_islands.clear();
+    }
 
-        if (std::fabs(vx) < VELOCITY_EPSILON)
-            vx = 0.0f;
-        if (std::fabs(vy) < VELOCITY_EPSILON)
-            vy = 0.0f;
+    float dt = simulation_world.delta_time;
+    float max_travel = settings.linear_threshold * dt;
+    float travel_squared_limit = max_travel * max_travel;
 
-        simulation_world.position_x[i] = px;
-        simulation_world.position_y[i] = py;
-        simulation_world.vel_x[i] = vx;
-        simulation_world.vel_y[i] = vy;
+    // 1. Rest timers, and the shortest one of each island
+    size_t dynamic_count = simulation_world.dynamic_count;
+    island_rest_time.assign(n, std::numeric_limits<float>::max());
+    for (size_t i = 0; i < dynamic_count; ++i)
+    {
+        if (simulation_world.sleeping[i])
+            continue;
+        float &timer = simulation_world.sleep_timer[i];
+        if (reference_valid)
+        {
+            float dx = simulation_world.position_x[i] - sleep_reference_x[i];
+            float dy = simulation_world.position_y[i] - sleep_reference_y[i];
+            timer = (dx * dx + dy * dy < travel_squared_limit) ? timer + dt : 0.0f;
+        }
+        else
+            timer = 0.0f;
+        int root = contact_solver.find_island_root((int)i);
+        island_rest_time[root] = std::min(island_rest_time[root], timer);
+    }
 
-        float dt = simulation_world.delta_time;
-        if (dt > 0.0f)
+    // 2. Islands whose members all rested long enough fall asleep together
+    unsigned long long asleep = 0;
+    for (size_t i = 0; i < dynamic_count; ++i)
+    {
+        if (!simulation_world.sleeping[i])
         {
-            simulation_world.previous_position_x[i] = px - vx * dt;
-            simulation_world.previous_position_y[i] = py - vy * dt;
+            int root = contact_solver.find_island_root((int)i);
+            if (island_rest_time[root] < settings.time_to_sleep)
+                continue;
+            simulation_world.sleeping[i] = 1;
+            simulation_world.sleep_island[i] = root;
+            simulation_world.vel_x[i] = 0.0f;
+            simulation_world.vel_y[i] = 0.0f;
+            simulation_world.previous_position_x[i] = simulation_world.position_x[i];
+            simulation_world.previous_position_y[i] = simulation_world.position_y[i];
         }
-        // small inward nudge to avoid exact contact with boundaries which can cause
-        // re-penetration or sticky behavior due to floating point rounding.
-        const float NUDGE = 1e-4f;
-        simulation_world.position_x[i] = std::min(std::max(simulation_world.position_x[i], min_x + r + NUDGE), max_x - r - NUDGE);
-        simulation_world.position_y[i] = std::min(std::max(simulation_world.position_y[i], min_y + r + NUDGE), max_y - r - NUDGE);
-        // SoA arrays are canonical.
+        ++asleep;
+    }
+    simulation_world.sleeping_bodies = asleep;
+    sleep_reference_x = simulation_world.position_x;
+    sleep_reference_y = simulation_world.position_y;
+    sleep_layout_version = simulation_world.body_layout_version;
+}
+
+// ====================================================================
+// --- BROAD PHASE PREPARATION ---
+// ====================================================================
+
+void collisionSystem::prepare_broad_phase(world &simulation_world)
+{
+    auto t0 = std::chrono::high_resolution_clock::now();
+
+    // Body indices changed meaning (add/remove/reorder): per-body caches are stale
+    if (simulation_world.body_layout_version != cached_layout_version)
+    {
+        cached_layout_version = simulation_world.body_layout_version;
+        reset_broad_phase_caches();
+    }
+    switch (active_broad_phase(simulation_world))
+    {
+    case BroadPhaseType::SWEEP_AND_PRUNE:
+        update_sweep_and_prune(simulation_world);
+        break;
+    case BroadPhaseType::AABB_TREE:
+        update_aabb_tree(simulation_world);
+        break;
+    case BroadPhaseType::HIERARCHICAL_GRID:
+        update_hierarchical_grid(simulation_world);
+        break;
+    case BroadPhaseType::HASHED_GRID:
+        hash_grid.build(simulation_world.position_x.data(), simulation_world.position_y.data(), simulation_world.position_x.size(), simulation_world.grid_info.cell_size);
+        break;
+    case BroadPhaseType::UNIFORM_GRID:
+    default:
+        populate_spatial_grid(simulation_world);
+        break;
     }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    simulation_world.broad_phase_us = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
 }
 
 // ====================================================================
@@ -345,12 +1759,75 @@ void collisionSystem::solve_boundary_contacts(world &simulation_world)
 
 void collisionSystem::update(world &simulation_world, float delta_time)
 {
-    // 1. Preparation phase (Spatial Hashing)
-    clear_spatial_grid(simulation_world);
-    populate_spatial_grid(simulation_world);
+    // The phases overwrite the broad/narrow timers; keep what earlier substeps recorded
+    unsigned long long broad_before = simulation_world.broad_phase_us;
+    unsigned long long narrow_before = simulation_world.narrow_phase_us;
+    simulation_world.broad_phase_us = 0;
+    simulation_world.narrow_phase_us = 0;
+    step(simulation_world);
+    update_sleep(simulation_world);
+    simulation_world.broad_phase_us += broad_before;
+    simulation_world.narrow_phase_us += narrow_before;
+}
 
-    // 2. Body-Body collisions (Broad and Narrow Phase)
-    narrow_phase_check_and_resolve(simulation_world);
+void collisionSystem::step(world &simulation_world)
+{
+    skip_resting_pairs = simulation_world.sleep_settings.enabled;
+    if (continuous_collision_enabled)
+    {
+        auto t_c0 = std::chrono::high_resolution_clock::now();
+        solve_continuous_collisions(simulation_world);
+        auto t_c1 = std::chrono::high_resolution_clock::now();
+        simulation_world.ccd_us += (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(t_c1 - t_c0).count();
+    }
+    if (warm_starting)
+    {
+        // Cached impulses are keyed by body index
+        if (simulation_world.body_layout_version != contact_cache_layout_version)
+        {
+            contact_cache.clear();
+            contact_cache_layout_version = simulation_world.body_layout_version;
+        }
+        contact_cache.begin_frame();
+    }
+
+    // 1 + 2 + 3. XPBD solves the boundaries together with the contacts
+    if (contact_solver_type == ContactSolverType::XPBD)
+    {
+        xpbd_check_and_resolve(simulation_world);
+        return;
+    }
+
+    // 1 + 2. Body-Body collisions (Broad and Narrow Phase)
+    if (contact_solver_type != ContactSolverType::SINGLE_PASS)
+    {
+        // Collect first, then iterate (warm starting happens inside the solver)
+        iterative_check_and_resolve(simulation_world);
+        solve_boundary_contacts(simulation_world);
+        return;
+    }
+
+    // The buffered paths reset the islands in collect_contacts
+    contact_solver.clear();
+    if (warm_starting)
+        warm_start_contacts(simulation_world);
+    if (neighbour_list_enabled)
+    {
+        // The broad phase only runs when the Verlet list has to be rebuilt
+        neighbour_list_check_and_resolve(simulation_world);
+    }
+    else
+    {
+        // Preparation phase (grid build / SAP sort, counted as broad phase time)
+        prepare_broad_phase(simulation_world);
+
+        if (pair_mode == PairGenerationMode::STREAMING)
+            streaming_check_and_resolve(simulation_world);
+        else
+            narrow_phase_check_and_resolve(simulation_world);
+    }
+    if (warm_starting)
+        settle_warm_started_contacts(simulation_world);
 
     // 3. World boundary collisions
     solve_boundary_contacts(simulation_world);
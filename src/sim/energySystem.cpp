@@ -0,0 +1,26 @@
+#include "sim/energySystem.hpp"
+#include "physics/world.hpp"
+
+// Sums in double: a frame adds up tens of thousands of small terms
+void energySystem::update(world &simulation_world, float dt)
+{
+    double kinetic = 0.0;
+    double potential = 0.0;
+    double px = 0.0;
+    double py = 0.0;
+    size_t n = simulation_world.dynamic_count;
+    for (size_t i = 0; i < n; ++i)
+    {
+        double m = simulation_world.mass[i];
+        double vx = simulation_world.vel_x[i];
+        double vy = simulation_world.vel_y[i];
+        kinetic += 0.5 * m * (vx * vx + vy * vy);
+        potential -= m * (simulation_world.gravity_x * simulation_world.position_x[i] + simulation_world.gravity_y * simulation_world.position_y[i]);
+        px += m * vx;
+        py += m * vy;
+    }
+    kinetic_energy = kinetic;
+    potential_energy = potential;
+    momentum_x = px;
+    momentum_y = py;
+}
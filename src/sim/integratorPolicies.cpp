@@ -0,0 +1,44 @@
+#include "sim/integratorPolicies.hpp"
+
+const char *integrator_name(IntegratorType type)
+{
+    switch (type)
+    {
+    case IntegratorType::EULER_EXPLICIT:
+        return "euler";
+    case IntegratorType::EULER_SEMI_IMPLICIT:
+        return "semi-implicit";
+    case IntegratorType::VELOCITY_VERLET:
+        return "velocity-verlet";
+    default:
+        return "verlet";
+    }
+}
+
+// The four feature mixes of one policy, indexed by damping * 2 + friction
+template <typename Policy>
+static IntegratorKernel select_feature_mix(bool damping, bool friction)
+{
+    static const IntegratorKernel kernels[4] = {
+        integrate_bodies<Policy, false, false>,
+        integrate_bodies<Policy, false, true>,
+        integrate_bodies<Policy, true, false>,
+        integrate_bodies<Policy, true, true>,
+    };
+    return kernels[(damping ? 2 : 0) + (friction ? 1 : 0)];
+}
+
+IntegratorKernel select_integrator_kernel(IntegratorType type, bool damping, bool friction)
+{
+    switch (type)
+    {
+    case IntegratorType::EULER_EXPLICIT:
+        return select_feature_mix<EulerExplicitPolicy>(damping, friction);
+    case IntegratorType::EULER_SEMI_IMPLICIT:
+        return select_feature_mix<EulerSemiImplicitPolicy>(damping, friction);
+    case IntegratorType::VELOCITY_VERLET:
+        return select_feature_mix<VelocityVerletPolicy>(damping, friction);
+    default:
+        return select_feature_mix<VerletPositionPolicy>(damping, friction);
+    }
+}
@@ -0,0 +1,603 @@
+#include "sim/laneEnsemble.hpp"
+#include "sim/integratorPolicies.hpp"
+#include "sim/simdExp.hpp"
+#include "physics/world.hpp"
+#include <algorithm>
+#include <cmath>
+
+// As in collisionSystem.cpp
+const float LANE_VELOCITY_EPSILON = 1e-6f;
+const float LANE_GROUND_Y_LIMIT = 0.0f;
+const float LANE_CONTACT_EPS = 1e-4f;    // outward nudge after a pair contact (BOUNDARY_EPS)
+const float LANE_BOUNDARY_NUDGE = 1e-4f; // inward nudge after the boundary pass (NUDGE)
+const float LANE_MIN_DISTANCE_SQUARED = 1e-6f;
+
+// Where padding bodies wait: far enough that no real body reaches them
+const float LANE_PAD_POSITION = 1e9f;
+
+// Everything one step reads and writes
+struct LaneStepData
+{
+    float *position_x;
+    float *position_y;
+    float *previous_position_x;
+    float *previous_position_y;
+    float *vel_x;
+    float *vel_y;
+    const float *inv_mass;
+    const float *radius;
+    const float *damping;
+    const float *friction;
+    const float *restitution;
+    const LaneSettings *settings;
+    size_t rows;
+    float dt;
+    float correction_percent;
+    float correction_slop;
+};
+
+// ====================================================================
+// --- PORTABLE (one lane at a time) ---
+// The reference the AVX2 kernel is checked against, written with the
+// formulas and evaluation order of the world kernels.
+// ====================================================================
+
+static void lane_integrate_portable(const LaneStepData &s)
+{
+    const float dt = s.dt;
+    const float dt2 = dt * dt;
+    for (size_t b = 0; b < s.rows; ++b)
+    {
+        for (int k = 0; k < WORLD_LANES; ++k)
+        {
+            size_t i = b * WORLD_LANES + k;
+            bool active = s.inv_mass[i] > 0.0f;
+            float d = s.damping[i];
+            float drag = d + s.friction[i];
+            float x = s.position_x[i];
+            float y = s.position_y[i];
+            float prev_x = s.previous_position_x[i];
+            float prev_y = s.previous_position_y[i];
+            float vx = s.vel_x[i];
+            float vy = s.vel_y[i];
+            AxisStep sx = VerletPositionPolicy::step(x, prev_x, vx, s.settings->gravity_x[k], drag, dt, dt2);
+            AxisStep sy = VerletPositionPolicy::step(y, prev_y, vy, s.settings->gravity_y[k], drag, dt, dt2);
+
+            float combined_damping = s.settings->global_damping[k] + d;
+            bool damped = combined_damping > 0.0f;
+            float factor = select_float(damped, exp_approx(-combined_damping * dt), 1.0f);
+            sx.v *= factor;
+            sy.v *= factor;
+            sx.prev = select_float(damped, sx.x - sx.v * dt, sx.prev);
+            sy.prev = select_float(damped, sy.x - sy.v * dt, sy.prev);
+
+            s.position_x[i] = select_float(active, sx.x, x);
+            s.position_y[i] = select_float(active, sy.x, y);
+            s.previous_position_x[i] = select_float(active, sx.prev, prev_x);
+            s.previous_position_y[i] = select_float(active, sy.prev, prev_y);
+            s.vel_x[i] = select_float(active, sx.v, vx);
+            s.vel_y[i] = select_float(active, sy.v, vy);
+        }
+    }
+}
+
+// collisionSystem::resolve_contact_with_impulse without the contact cache
+static void lane_contact_portable(const LaneStepData &s, int k, size_t a, size_t b)
+{
+    float dx = s.position_x[b] - s.position_x[a];
+    float dy = s.position_y[b] - s.position_y[a];
+    float distance_squared = dx * dx + dy * dy;
+    if (distance_squared <= LANE_MIN_DISTANCE_SQUARED)
+        return;
+    float distance = std::sqrt(distance_squared);
+    float penetration_depth = (s.radius[a] + s.radius[b]) - distance;
+    if (penetration_depth <= 0.0f)
+        return;
+    float inverse_distance = 1.0f / distance;
+    float nx = dx * inverse_distance;
+    float ny = dy * inverse_distance;
+
+    float inverse_mass_A = s.inv_mass[a];
+    float inverse_mass_B = s.inv_mass[b];
+    float inverse_mass_sum = inverse_mass_A + inverse_mass_B;
+    if (inverse_mass_sum <= 0.0f)
+        return;
+
+    float correction_magnitude = std::max(penetration_depth - s.correction_slop, 0.0f) / inverse_mass_sum * s.correction_percent;
+    float cx = nx * correction_magnitude;
+    float cy = ny * correction_magnitude;
+    s.position_x[a] -= cx * inverse_mass_A;
+    s.position_y[a] -= cy * inverse_mass_A;
+    s.position_x[b] += cx * inverse_mass_B;
+    s.position_y[b] += cy * inverse_mass_B;
+
+    float velocity_along_normal = (s.vel_x[b] - s.vel_x[a]) * nx + (s.vel_y[b] - s.vel_y[a]) * ny;
+    if (velocity_along_normal > 0.0f)
+        return;
+    float effective_restitution = (s.restitution[a] + s.restitution[b]) * 0.5f;
+    float target_velocity = -effective_restitution * velocity_along_normal;
+    float impulse = std::max((target_velocity - velocity_along_normal) / inverse_mass_sum, 0.0f);
+    float ix = nx * impulse;
+    float iy = ny * impulse;
+
+    s.vel_x[a] -= ix * inverse_mass_A;
+    s.vel_y[a] -= iy * inverse_mass_A;
+    s.vel_x[b] += ix * inverse_mass_B;
+    s.vel_y[b] += iy * inverse_mass_B;
+
+    size_t bodies[2] = {a, b};
+    for (size_t i : bodies)
+    {
+        float vx = s.vel_x[i];
+        float vy = s.vel_y[i];
+        s.previous_position_x[i] = s.position_x[i] - vx * s.dt;
+        s.previous_position_y[i] = s.position_y[i] - vy * s.dt;
+        float r = s.radius[i];
+        s.position_x[i] = std::min(std::max(s.position_x[i], s.settings->min_x[k] + r + LANE_CONTACT_EPS), s.settings->max_x[k] - r - LANE_CONTACT_EPS);
+        s.position_y[i] = std::min(std::max(s.position_y[i], s.settings->min_y[k] + r + LANE_CONTACT_EPS), s.settings->max_y[k] - r - LANE_CONTACT_EPS);
+        if (std::fabs(vx) < LANE_VELOCITY_EPSILON)
+            s.vel_x[i] = 0.0f;
+        if (std::fabs(vy) < LANE_VELOCITY_EPSILON)
+            s.vel_y[i] = 0.0f;
+    }
+}
+
+static void lane_contacts_portable(const LaneStepData &s)
+{
+    for (size_t a = 0; a < s.rows; ++a)
+    {
+        for (size_t b = a + 1; b < s.rows; ++b)
+        {
+            for (int k = 0; k < WORLD_LANES; ++k)
+                lane_contact_portable(s, k, a * WORLD_LANES + k, b * WORLD_LANES + k);
+        }
+    }
+}
+
+// collisionSystem::solve_boundary_contacts
+static void lane_boundaries_portable(const LaneStepData &s)
+{
+    for (size_t b = 0; b < s.rows; ++b)
+    {
+        for (int k = 0; k < WORLD_LANES; ++k)
+        {
+            size_t i = b * WORLD_LANES + k;
+            if (s.inv_mass[i] <= 0.0f)
+                continue;
+            float min_x = s.settings->min_x[k];
+            float max_x = s.settings->max_x[k];
+            float min_y = s.settings->min_y[k];
+            float max_y = s.settings->max_y[k];
+            float px = s.position_x[i];
+            float py = s.position_y[i];
+            float vx = s.vel_x[i];
+            float vy = s.vel_y[i];
+            float r = s.radius[i];
+            float restitution = s.restitution[i];
+
+            if (py - r < LANE_GROUND_Y_LIMIT)
+            {
+                py = LANE_GROUND_Y_LIMIT + r;
+                if (vy < 0.0f)
+                    vy = -vy * restitution;
+            }
+            if (px - r < min_x)
+            {
+                px = min_x + r;
+                if (vx < 0.0f)
+                    vx = -vx * restitution;
+            }
+            if (px + r > max_x)
+            {
+                px = max_x - r;
+                if (vx > 0.0f)
+                    vx = -vx * restitution;
+            }
+            if (py + r > max_y)
+            {
+                py = max_y - r;
+                if (vy > 0.0f)
+                    vy = -vy * restitution;
+            }
+            if (std::fabs(vx) < LANE_VELOCITY_EPSILON)
+                vx = 0.0f;
+            if (std::fabs(vy) < LANE_VELOCITY_EPSILON)
+                vy = 0.0f;
+
+            s.vel_x[i] = vx;
+            s.vel_y[i] = vy;
+            s.previous_position_x[i] = px - vx * s.dt;
+            s.previous_position_y[i] = py - vy * s.dt;
+            s.position_x[i] = std::min(std::max(px, min_x + r + LANE_BOUNDARY_NUDGE), max_x - r - LANE_BOUNDARY_NUDGE);
+            s.position_y[i] = std::min(std::max(py, min_y + r + LANE_BOUNDARY_NUDGE), max_y - r - LANE_BOUNDARY_NUDGE);
+        }
+    }
+}
+
+static void lane_step_portable(const LaneStepData &s)
+{
+    lane_integrate_portable(s);
+    lane_contacts_portable(s);
+    lane_boundaries_portable(s);
+}
+
+#ifdef SIMD_X86_KERNELS
+
+// ====================================================================
+// --- AVX2 (8 worlds per instruction) ---
+// One register holds one body of every lane. Branches of the portable
+// code become masks; lanes without a contact keep their old values.
+// ====================================================================
+
+__attribute__((target("avx2"))) static inline __m256 abs_below_avx2(__m256 v, __m256 limit)
+{
+    __m256 magnitude = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+    return _mm256_cmp_ps(magnitude, limit, _CMP_LT_OQ);
+}
+
+__attribute__((target("avx2"))) static inline __m256 negate_avx2(__m256 v)
+{
+    return _mm256_xor_ps(v, _mm256_set1_ps(-0.0f));
+}
+
+__attribute__((target("avx2"))) static void lane_integrate_avx2(const LaneStepData &s)
+{
+    const __m256 dt = _mm256_set1_ps(s.dt);
+    const __m256 dt2 = _mm256_set1_ps(s.dt * s.dt);
+    const __m256 half_inv_dt = _mm256_set1_ps(0.5f / s.dt);
+    const __m256 gx = _mm256_load_ps(s.settings->gravity_x);
+    const __m256 gy = _mm256_load_ps(s.settings->gravity_y);
+    const __m256 global_damping = _mm256_load_ps(s.settings->global_damping);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 two = _mm256_set1_ps(2.0f);
+
+    for (size_t i = 0; i < s.rows * WORLD_LANES; i += WORLD_LANES)
+    {
+        __m256 active = _mm256_cmp_ps(_mm256_loadu_ps(s.inv_mass + i), zero, _CMP_GT_OQ);
+        if (_mm256_movemask_ps(active) == 0)
+            continue;
+
+        __m256 d = _mm256_loadu_ps(s.damping + i);
+        __m256 drag = _mm256_add_ps(d, _mm256_loadu_ps(s.friction + i));
+        __m256 vx = _mm256_loadu_ps(s.vel_x + i);
+        __m256 vy = _mm256_loadu_ps(s.vel_y + i);
+        __m256 ax = _mm256_sub_ps(gx, _mm256_mul_ps(vx, drag));
+        __m256 ay = _mm256_sub_ps(gy, _mm256_mul_ps(vy, drag));
+
+        __m256 x = _mm256_loadu_ps(s.position_x + i);
+        __m256 y = _mm256_loadu_ps(s.position_y + i);
+        __m256 prev_x = _mm256_loadu_ps(s.previous_position_x + i);
+        __m256 prev_y = _mm256_loadu_ps(s.previous_position_y + i);
+        __m256 next_x = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(x, two), prev_x), _mm256_mul_ps(ax, dt2));
+        __m256 next_y = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(y, two), prev_y), _mm256_mul_ps(ay, dt2));
+
+        __m256 new_vx = _mm256_mul_ps(_mm256_sub_ps(next_x, prev_x), half_inv_dt);
+        __m256 new_vy = _mm256_mul_ps(_mm256_sub_ps(next_y, prev_y), half_inv_dt);
+        __m256 combined_damping = _mm256_add_ps(global_damping, d);
+        __m256 damped = _mm256_cmp_ps(combined_damping, zero, _CMP_GT_OQ);
+        __m256 factor = exp_approx_avx2(_mm256_mul_ps(negate_avx2(combined_damping), dt));
+        new_vx = _mm256_blendv_ps(new_vx, _mm256_mul_ps(new_vx, factor), damped);
+        new_vy = _mm256_blendv_ps(new_vy, _mm256_mul_ps(new_vy, factor), damped);
+        __m256 new_prev_x = _mm256_blendv_ps(x, _mm256_sub_ps(next_x, _mm256_mul_ps(new_vx, dt)), damped);
+        __m256 new_prev_y = _mm256_blendv_ps(y, _mm256_sub_ps(next_y, _mm256_mul_ps(new_vy, dt)), damped);
+
+        _mm256_storeu_ps(s.position_x + i, _mm256_blendv_ps(x, next_x, active));
+        _mm256_storeu_ps(s.position_y + i, _mm256_blendv_ps(y, next_y, active));
+        _mm256_storeu_ps(s.previous_position_x + i, _mm256_blendv_ps(prev_x, new_prev_x, active));
+        _mm256_storeu_ps(s.previous_position_y + i, _mm256_blendv_ps(prev_y, new_prev_y, active));
+        _mm256_storeu_ps(s.vel_x + i, _mm256_blendv_ps(vx, new_vx, active));
+        _mm256_storeu_ps(s.vel_y + i, _mm256_blendv_ps(vy, new_vy, active));
+    }
+}
+
+// Velocity, previous position and clamps of one side of a bouncing contact
+// (`body_a`: the impulse is subtracted)
+__attribute__((target("avx2"))) static inline void lane_contact_side_avx2(const LaneStepData &s, size_t i, __m256 bounce, __m256 x, __m256 y, __m256 im,
+                                                                           __m256 ix, __m256 iy, bool body_a)
+{
+    const __m256 dt = _mm256_set1_ps(s.dt);
+    const __m256 eps = _mm256_set1_ps(LANE_CONTACT_EPS);
+    const __m256 velocity_epsilon = _mm256_set1_ps(LANE_VELOCITY_EPSILON);
+
+    __m256 vx = _mm256_loadu_ps(s.vel_x + i);
+    __m256 vy = _mm256_loadu_ps(s.vel_y + i);
+    __m256 dvx = _mm256_mul_ps(ix, im);
+    __m256 dvy = _mm256_mul_ps(iy, im);
+    __m256 new_vx = body_a ? _mm256_sub_ps(vx, dvx) : _mm256_add_ps(vx, dvx);
+    __m256 new_vy = body_a ? _mm256_sub_ps(vy, dvy) : _mm256_add_ps(vy, dvy);
+    __m256 prev_x = _mm256_sub_ps(x, _mm256_mul_ps(new_vx, dt));
+    __m256 prev_y = _mm256_sub_ps(y, _mm256_mul_ps(new_vy, dt));
+
+    __m256 r = _mm256_loadu_ps(s.radius + i);
+    __m256 lo_x = _mm256_add_ps(_mm256_add_ps(_mm256_load_ps(s.settings->min_x), r), eps);
+    __m256 hi_x = _mm256_sub_ps(_mm256_sub_ps(_mm256_load_ps(s.settings->max_x), r), eps);
+    __m256 lo_y = _mm256_add_ps(_mm256_add_ps(_mm256_load_ps(s.settings->min_y), r), eps);
+    __m256 hi_y = _mm256_sub_ps(_mm256_sub_ps(_mm256_load_ps(s.settings->max_y), r), eps);
+    __m256 clamped_x = _mm256_min_ps(_mm256_max_ps(x, lo_x), hi_x);
+    __m256 clamped_y = _mm256_min_ps(_mm256_max_ps(y, lo_y), hi_y);
+    new_vx = _mm256_andnot_ps(abs_below_avx2(new_vx, velocity_epsilon), new_vx);
+    new_vy = _mm256_andnot_ps(abs_below_avx2(new_vy, velocity_epsilon), new_vy);
+
+    _mm256_storeu_ps(s.vel_x + i, _mm256_blendv_ps(vx, new_vx, bounce));
+    _mm256_storeu_ps(s.vel_y + i, _mm256_blendv_ps(vy, new_vy, bounce));
+    _mm256_storeu_ps(s.previous_position_x + i, _mm256_blendv_ps(_mm256_loadu_ps(s.previous_position_x + i), prev_x, bounce));
+    _mm256_storeu_ps(s.previous_position_y + i, _mm256_blendv_ps(_mm256_loadu_ps(s.previous_position_y + i), prev_y, bounce));
+    _mm256_storeu_ps(s.position_x + i, _mm256_blendv_ps(x, clamped_x, bounce));
+    _mm256_storeu_ps(s.position_y + i, _mm256_blendv_ps(y, clamped_y, bounce));
+}
+
+__attribute__((target("avx2"))) static void lane_contacts_avx2(const LaneStepData &s)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 min_distance_squared = _mm256_set1_ps(LANE_MIN_DISTANCE_SQUARED);
+    const __m256 slop = _mm256_set1_ps(s.correction_slop);
+    const __m256 percent = _mm256_set1_ps(s.correction_percent);
+
+    for (size_t a = 0; a < s.rows; ++a)
+    {
+        size_t ia = a * WORLD_LANES;
+        for (size_t b = a + 1; b < s.rows; ++b)
+        {
+            size_t ib = b * WORLD_LANES;
+            __m256 xa = _mm256_loadu_ps(s.position_x + ia);
+            __m256 ya = _mm256_loadu_ps(s.position_y + ia);
+            __m256 xb = _mm256_loadu_ps(s.position_x + ib);
+            __m256 yb = _mm256_loadu_ps(s.position_y + ib);
+            __m256 dx = _mm256_sub_ps(xb, xa);
+            __m256 dy = _mm256_sub_ps(yb, ya);
+            __m256 distance_squared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 distance = _mm256_sqrt_ps(distance_squared);
+            __m256 penetration = _mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(s.radius + ia), _mm256_loadu_ps(s.radius + ib)), distance);
+            __m256 im_a = _mm256_loadu_ps(s.inv_mass + ia);
+            __m256 im_b = _mm256_loadu_ps(s.inv_mass + ib);
+            __m256 im_sum = _mm256_add_ps(im_a, im_b);
+            __m256 contact = _mm256_and_ps(_mm256_cmp_ps(distance_squared, min_distance_squared, _CMP_GT_OQ),
+                                           _mm256_and_ps(_mm256_cmp_ps(penetration, zero, _CMP_GT_OQ), _mm256_cmp_ps(im_sum, zero, _CMP_GT_OQ)));
+            if (_mm256_movemask_ps(contact) == 0)
+                continue;
+
+            __m256 inverse_distance = _mm256_div_ps(one, distance);
+            __m256 nx = _mm256_mul_ps(dx, inverse_distance);
+            __m256 ny = _mm256_mul_ps(dy, inverse_distance);
+            __m256 correction = _mm256_mul_ps(_mm256_div_ps(_mm256_max_ps(_mm256_sub_ps(penetration, slop), zero), im_sum), percent);
+            __m256 cx = _mm256_mul_ps(nx, correction);
+            __m256 cy = _mm256_mul_ps(ny, correction);
+            xa = _mm256_blendv_ps(xa, _mm256_sub_ps(xa, _mm256_mul_ps(cx, im_a)), contact);
+            ya = _mm256_blendv_ps(ya, _mm256_sub_ps(ya, _mm256_mul_ps(cy, im_a)), contact);
+            xb = _mm256_blendv_ps(xb, _mm256_add_ps(xb, _mm256_mul_ps(cx, im_b)), contact);
+            yb = _mm256_blendv_ps(yb, _mm256_add_ps(yb, _mm256_mul_ps(cy, im_b)), contact);
+
+            __m256 rvx = _mm256_sub_ps(_mm256_loadu_ps(s.vel_x + ib), _mm256_loadu_ps(s.vel_x + ia));
+            __m256 rvy = _mm256_sub_ps(_mm256_loadu_ps(s.vel_y + ib), _mm256_loadu_ps(s.vel_y + ia));
+            __m256 normal_velocity = _mm256_add_ps(_mm256_mul_ps(rvx, nx), _mm256_mul_ps(rvy, ny));
+            __m256 bounce = _mm256_and_ps(contact, _mm256_cmp_ps(normal_velocity, zero, _CMP_LE_OQ));
+            if (_mm256_movemask_ps(bounce) == 0)
+            {
+                _mm256_storeu_ps(s.position_x + ia, xa);
+                _mm256_storeu_ps(s.position_y + ia, ya);
+                _mm256_storeu_ps(s.position_x + ib, xb);
+                _mm256_storeu_ps(s.position_y + ib, yb);
+                continue;
+            }
+
+            __m256 restitution = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(s.restitution + ia), _mm256_loadu_ps(s.restitution + ib)), half);
+            __m256 target = _mm256_mul_ps(negate_avx2(restitution), normal_velocity);
+            __m256 impulse = _mm256_max_ps(_mm256_div_ps(_mm256_sub_ps(target, normal_velocity), im_sum), zero);
+            __m256 ix = _mm256_mul_ps(nx, impulse);
+            __m256 iy = _mm256_mul_ps(ny, impulse);
+            lane_contact_side_avx2(s, ia, bounce, xa, ya, im_a, ix, iy, true);
+            lane_contact_side_avx2(s, ib, bounce, xb, yb, im_b, ix, iy, false);
+        }
+    }
+}
+
+__attribute__((target("avx2"))) static void lane_boundaries_avx2(const LaneStepData &s)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 ground = _mm256_set1_ps(LANE_GROUND_Y_LIMIT);
+    const __m256 dt = _mm256_set1_ps(s.dt);
+    const __m256 nudge = _mm256_set1_ps(LANE_BOUNDARY_NUDGE);
+    const __m256 velocity_epsilon = _mm256_set1_ps(LANE_VELOCITY_EPSILON);
+    const __m256 min_x = _mm256_load_ps(s.settings->min_x);
+    const __m256 max_x = _mm256_load_ps(s.settings->max_x);
+    const __m256 min_y = _mm256_load_ps(s.settings->min_y);
+    const __m256 max_y = _mm256_load_ps(s.settings->max_y);
+
+    for (size_t i = 0; i < s.rows * WORLD_LANES; i += WORLD_LANES)
+    {
+        __m256 active = _mm256_cmp_ps(_mm256_loadu_ps(s.inv_mass + i), zero, _CMP_GT_OQ);
+        if (_mm256_movemask_ps(active) == 0)
+            continue;
+
+        __m256 x = _mm256_loadu_ps(s.position_x + i);
+        __m256 y = _mm256_loadu_ps(s.position_y + i);
+        __m256 vx = _mm256_loadu_ps(s.vel_x + i);
+        __m256 vy = _mm256_loadu_ps(s.vel_y + i);
+        __m256 r = _mm256_loadu_ps(s.radius + i);
+        __m256 restitution = _mm256_loadu_ps(s.restitution + i);
+        __m256 px = x;
+        __m256 py = y;
+
+        // Ground, left, right, ceiling: each test sees the previous ones' result
+        __m256 hit = _mm256_cmp_ps(_mm256_sub_ps(py, r), ground, _CMP_LT_OQ);
+        py = _mm256_blendv_ps(py, _mm256_add_ps(ground, r), hit);
+        vy = _mm256_blendv_ps(vy, _mm256_mul_ps(negate_avx2(vy), restitution), _mm256_and_ps(hit, _mm256_cmp_ps(vy, zero, _CMP_LT_OQ)));
+        hit = _mm256_cmp_ps(_mm256_sub_ps(px, r), min_x, _CMP_LT_OQ);
+        px = _mm256_blendv_ps(px, _mm256_add_ps(min_x, r), hit);
+        vx = _mm256_blendv_ps(vx, _mm256_mul_ps(negate_avx2(vx), restitution), _mm256_and_ps(hit, _mm256_cmp_ps(vx, zero, _CMP_LT_OQ)));
+        hit = _mm256_cmp_ps(_mm256_add_ps(px, r), max_x, _CMP_GT_OQ);
+        px = _mm256_blendv_ps(px, _mm256_sub_ps(max_x, r), hit);
+        vx = _mm256_blendv_ps(vx, _mm256_mul_ps(negate_avx2(vx), restitution), _mm256_and_ps(hit, _mm256_cmp_ps(vx, zero, _CMP_GT_OQ)));
+        hit = _mm256_cmp_ps(_mm256_add_ps(py, r), max_y, _CMP_GT_OQ);
+        py = _mm256_blendv_ps(py, _mm256_sub_ps(max_y, r), hit);
+        vy = _mm256_blendv_ps(vy, _mm256_mul_ps(negate_avx2(vy), restitution), _mm256_and_ps(hit, _mm256_cmp_ps(vy, zero, _CMP_GT_OQ)));
+        vx = _mm256_andnot_ps(abs_below_avx2(vx, velocity_epsilon), vx);
+        vy = _mm256_andnot_ps(abs_below_avx2(vy, velocity_epsilon), vy);
+
+        __m256 prev_x = _mm256_sub_ps(px, _mm256_mul_ps(vx, dt));
+        __m256 prev_y = _mm256_sub_ps(py, _mm256_mul_ps(vy, dt));
+        px = _mm256_min_ps(_mm256_max_ps(px, _mm256_add_ps(_mm256_add_ps(min_x, r), nudge)), _mm256_sub_ps(_mm256_sub_ps(max_x, r), nudge));
+        py = _mm256_min_ps(_mm256_max_ps(py, _mm256_add_ps(_mm256_add_ps(min_y, r), nudge)), _mm256_sub_ps(_mm256_sub_ps(max_y, r), nudge));
+
+        _mm256_storeu_ps(s.vel_x + i, _mm256_blendv_ps(_mm256_loadu_ps(s.vel_x + i), vx, active));
+        _mm256_storeu_ps(s.vel_y + i, _mm256_blendv_ps(_mm256_loadu_ps(s.vel_y + i), vy, active));
+        _mm256_storeu_ps(s.previous_position_x + i, _mm256_blendv_ps(_mm256_loadu_ps(s.previous_position_x + i), prev_x, active));
+        _mm256_storeu_ps(s.previous_position_y + i, _mm256_blendv_ps(_mm256_loadu_ps(s.previous_position_y + i), prev_y, active));
+        _mm256_storeu_ps(s.position_x + i, _mm256_blendv_ps(x, px, active));
+        _mm256_storeu_ps(s.position_y + i, _mm256_blendv_ps(y, py, active));
+    }
+}
+
+__attribute__((target("avx2"))) static void lane_step_avx2(const LaneStepData &s)
+{
+    lane_integrate_avx2(s);
+    lane_contacts_avx2(s);
+    lane_boundaries_avx2(s);
+}
+
+#endif
+
+// ====================================================================
+// --- LANE ENSEMBLE ---
+// ====================================================================
+
+laneEnsemble::laneEnsemble(SimdLevel level) : simd_level(std::min(level, detect_simd_level())) {}
+
+// New rows start as padding in every lane
+void laneEnsemble::add_rows(size_t count)
+{
+    size_t size = (rows + count) * WORLD_LANES;
+    position_x.resize(size, LANE_PAD_POSITION);
+    position_y.resize(size, LANE_PAD_POSITION);
+    previous_position_x.resize(size, LANE_PAD_POSITION);
+    previous_position_y.resize(size, LANE_PAD_POSITION);
+    vel_x.resize(size, 0.0f);
+    vel_y.resize(size, 0.0f);
+    mass.resize(size, 0.0f);
+    inv_mass.resize(size, 0.0f);
+    radius.resize(size, 0.0f);
+    damping.resize(size, 0.0f);
+    friction.resize(size, 0.0f);
+    restitution.resize(size, 0.0f);
+    rows += count;
+}
+
+int laneEnsemble::add_world(const world &source)
+{
+    if (lanes == WORLD_LANES || !source.grid_info.bounded || source.delta_time <= 0.0f || (lanes > 0 && source.delta_time != delta_time))
+        return -1;
+    if (lanes == 0)
+    {
+        delta_time = source.delta_time;
+        position_correction_percent = source.solver_settings.position_correction_percent;
+        position_correction_slop = source.solver_settings.position_correction_slop;
+    }
+
+    int k = lanes++;
+    size_t n = source.size();
+    if (n > rows)
+        add_rows(n - rows);
+    for (size_t b = 0; b < n; ++b)
+    {
+        size_t i = b * WORLD_LANES + k;
+        position_x[i] = source.position_x[b];
+        position_y[i] = source.position_y[b];
+        previous_position_x[i] = source.previous_position_x[b];
+        previous_position_y[i] = source.previous_position_y[b];
+        vel_x[i] = source.vel_x[b];
+        vel_y[i] = source.vel_y[b];
+        mass[i] = source.mass[b];
+        inv_mass[i] = source.inv_mass[b];
+        radius[i] = source.radius[b];
+        damping[i] = source.get_damping(b);
+        friction[i] = source.get_friction(b);
+        restitution[i] = source.get_restitution(b);
+    }
+    lane_bodies[k] = n;
+
+    settings.gravity_x[k] = source.gravity_x;
+    settings.gravity_y[k] = source.gravity_y;
+    settings.global_damping[k] = source.global_damping;
+    settings.min_x[k] = source.grid_info.min_x;
+    settings.max_x[k] = source.grid_info.max_x;
+    settings.min_y[k] = source.grid_info.min_y;
+    settings.max_y[k] = source.grid_info.max_y;
+    return k;
+}
+
+void laneEnsemble::step(int frames)
+{
+    if (lanes == 0)
+        return;
+    LaneStepData s;
+    s.position_x = position_x.data();
+    s.position_y = position_y.data();
+    s.previous_position_x = previous_position_x.data();
+    s.previous_position_y = previous_position_y.data();
+    s.vel_x = vel_x.data();
+    s.vel_y = vel_y.data();
+    s.inv_mass = inv_mass.data();
+    s.radius = radius.data();
+    s.damping = damping.data();
+    s.friction = friction.data();
+    s.restitution = restitution.data();
+    s.settings = &settings;
+    s.rows = rows;
+    s.dt = delta_time;
+    s.correction_percent = position_correction_percent;
+    s.correction_slop = position_correction_slop;
+
+    void (*kernel)(const LaneStepData &) = lane_step_portable;
+#ifdef SIMD_X86_KERNELS
+    if (simd_level >= SimdLevel::AVX2)
+        kernel = lane_step_avx2;
+#endif
+    for (int f = 0; f < frames; ++f)
+        kernel(s);
+}
+
+void laneEnsemble::store_world(int lane, world &target) const
+{
+    size_t n = std::min(lane_bodies[lane], target.size());
+    for (size_t b = 0; b < n; ++b)
+    {
+        size_t i = b * WORLD_LANES + lane;
+        target.position_x[b] = position_x[i];
+        target.position_y[b] = position_y[i];
+        target.previous_position_x[b] = previous_position_x[i];
+        target.previous_position_y[b] = previous_position_y[i];
+        target.vel_x[b] = vel_x[i];
+        target.vel_y[b] = vel_y[i];
+    }
+}
+
+// Sums in double, as energySystem does
+double laneEnsemble::kinetic_energy(int lane) const
+{
+    double kinetic = 0.0;
+    for (size_t b = 0; b < lane_bodies[lane]; ++b)
+    {
+        size_t i = b * WORLD_LANES + lane;
+        if (inv_mass[i] <= 0.0f)
+            continue;
+        double vx = vel_x[i];
+        double vy = vel_y[i];
+        kinetic += 0.5 * (double)mass[i] * (vx * vx + vy * vy);
+    }
+    return kinetic;
+}
+
+double laneEnsemble::total_energy(int lane) const
+{
+    double potential = 0.0;
+    for (size_t b = 0; b < lane_bodies[lane]; ++b)
+    {
+        size_t i = b * WORLD_LANES + lane;
+        if (inv_mass[i] <= 0.0f)
+            continue;
+        potential -= (double)mass[i] * (settings.gravity_x[lane] * position_x[i] + settings.gravity_y[lane] * position_y[i]);
+    }
+    return kinetic_energy(lane) + potential;
+}
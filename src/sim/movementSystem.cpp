@@ -1,112 +1,86 @@
 #include "sim/movementSystem.hpp"
+#include "sim/verletKernels.hpp"
 #include "physics/body.hpp"
 #include "physics/world.hpp"
-movementSystem::movementSystem() {}
-movementSystem::~movementSystem() {}
-void movementSystem::verlet_integration(world &simulation_world)
+#include "utils/threadPool.hpp"
+#include <algorithm>
+
+// Bodies per parallel_for range: large enough that a range costs far more
+// than queueing it, small enough to balance across a handful of threads
+const int INTEGRATION_GRAIN = 4096;
+
+movementSystem::movementSystem(IntegratorType integrator) : integrator(integrator)
 {
-    // Pre-calculate time terms for efficiency and clarity
-    const float delta_time = simulation_world.delta_time;
-    const float delta_time_squared = delta_time * delta_time;
-    const float inverse_delta_time = 1.0f / delta_time;
+    set_simd_level(detect_simd_level());
+}
+movementSystem::~movementSystem() {}
 
-    // Iterate over all bodies using SoA arrays in world
-    size_t n = simulation_world.position_x.size();
-    for (size_t i = 0; i < n; ++i)
-    {
-        float inv_mass = simulation_world.inv_mass[i];
-        if (inv_mass <= 0.0f)
-            continue; // static
+void movementSystem::set_integrator(IntegratorType type) { integrator = type; }
+IntegratorType movementSystem::get_integrator() const { return integrator; }
 
-        // Start with global gravity
-        vec2 total_acceleration(simulation_world.gravity_x, simulation_world.gravity_y);
+void movementSystem::set_simd_level(SimdLevel level)
+{
+    simd_level = std::min(level, detect_simd_level());
+    verlet_simd_kernel = select_verlet_kernel(simd_level);
+}
 
-        // Damping and friction currently not stored per-body in SoA; if legacy bodies exist, read them
-        // Prefer SoA damping/friction if populated; this system reads SoA arrays.
-        if (i < simulation_world.damping.size() && i < simulation_world.friction.size())
-        {
-            float d = simulation_world.damping[i];
-            float f = simulation_world.friction[i];
-            if (d != 0.0f)
-            {
-                vec2 vel(simulation_world.vel_x[i], simulation_world.vel_y[i]);
-                total_acceleration = total_acceleration - (vel * d);
-            }
-            if (f != 0.0f)
-            {
-                vec2 vel(simulation_world.vel_x[i], simulation_world.vel_y[i]);
-                float speed = std::sqrt(vel.x * vel.x + vel.y * vel.y);
-                if (speed > 1e-6f)
-                {
-                    vec2 vel_dir = vel * (1.0f / speed);
-                    total_acceleration = total_acceleration - (vel_dir * (f * speed));
-                }
-            }
-        }
-        else
-        {
-            // Fallback: read via getters which check secondary storage if needed
-            float d = simulation_world.get_damping(i);
-            float f = simulation_world.get_friction(i);
-            if (d != 0.0f)
-            {
-                vec2 vel(simulation_world.vel_x[i], simulation_world.vel_y[i]);
-                total_acceleration = total_acceleration - (vel * d);
-            }
-            if (f != 0.0f)
-            {
-                vec2 vel(simulation_world.vel_x[i], simulation_world.vel_y[i]);
-                float speed = std::sqrt(vel.x * vel.x + vel.y * vel.y);
-                if (speed > 1e-6f)
-                {
-                    vec2 vel_dir = vel * (1.0f / speed);
-                    total_acceleration = total_acceleration - (vel_dir * (f * speed));
-                }
-            }
-        }
+SimdLevel movementSystem::get_simd_level() const { return simd_level; }
 
-        // SoA access
-        vec2 current_position(simulation_world.position_x[i], simulation_world.position_y[i]);
-        vec2 previous_position(simulation_world.previous_position_x[i], simulation_world.previous_position_y[i]);
+// True when any of the first `count` entries of a per-body column is non-zero
+static bool any_non_zero(const std::vector<float> &column, size_t count)
+{
+    bool found = false;
+    for (size_t i = 0; i < count; ++i)
+        found |= (column[i] != 0.0f);
+    return found;
+}
 
-        vec2 acceleration_term = total_acceleration * delta_time_squared;
-        vec2 next_position = (current_position * 2.0f) - previous_position + acceleration_term;
+void movementSystem::integrate(world &simulation_world)
+{
+    size_t n = simulation_world.position_x.size();
+    IntegratorColumns columns;
+    columns.position_x = simulation_world.position_x.data();
+    columns.position_y = simulation_world.position_y.data();
+    columns.previous_position_x = simulation_world.previous_position_x.data();
+    columns.previous_position_y = simulation_world.previous_position_y.data();
+    columns.vel_x = simulation_world.vel_x.data();
+    columns.vel_y = simulation_world.vel_y.data();
+    columns.inv_mass = simulation_world.inv_mass.data();
+    // Columns left empty by the legacy constructors read as zero
+    columns.damping = (simulation_world.damping.size() == n) ? simulation_world.damping.data() : nullptr;
+    columns.friction = (simulation_world.friction.size() == n) ? simulation_world.friction.data() : nullptr;
+    columns.sleeping = (simulation_world.sleeping.size() == n) ? simulation_world.sleeping.data() : nullptr;
 
-        // Update SoA arrays: shift current -> previous, write next
-        simulation_world.previous_position_x[i] = simulation_world.position_x[i];
-        simulation_world.previous_position_y[i] = simulation_world.position_y[i];
-        simulation_world.position_x[i] = next_position.x;
-        simulation_world.position_y[i] = next_position.y;
+    IntegratorStepParams params;
+    params.gravity_x = simulation_world.gravity_x;
+    params.gravity_y = simulation_world.gravity_y;
+    params.delta_time = simulation_world.delta_time;
+    params.global_damping = simulation_world.global_damping;
 
-        // Update vel SoA using centered difference: (next - prev) / (2*dt)
-        float half_inv_dt = 0.5f * inverse_delta_time;
-        simulation_world.vel_x[i] = (simulation_world.position_x[i] - previous_position.x) * half_inv_dt;
-        simulation_world.vel_y[i] = (simulation_world.position_y[i] - previous_position.y) * half_inv_dt;
+    // Static bodies sit after the dynamic range and are never visited
+    size_t dynamic_count = simulation_world.dynamic_count;
 
-        // Apply damping as exponential decay per second:
-        // combined_damping (1/s) = world.global_damping + per-body damping
-        float per_body_damping = 0.0f;
-        if (i < simulation_world.damping.size())
-            per_body_damping = simulation_world.damping[i];
-        float combined_damping = simulation_world.global_damping + per_body_damping;
-        if (combined_damping > 0.0f)
-        {
-            float damping_factor = std::exp(-combined_damping * delta_time);
-            simulation_world.vel_x[i] *= damping_factor;
-            simulation_world.vel_y[i] *= damping_factor;
-            // Recompute previous_position to remain consistent with damped velocity
-            if (simulation_world.delta_time > 0.0f)
-            {
-                simulation_world.previous_position_x[i] = simulation_world.position_x[i] - simulation_world.vel_x[i] * delta_time;
-                simulation_world.previous_position_y[i] = simulation_world.position_y[i] - simulation_world.vel_y[i] * delta_time;
-            }
-        }
+    // The feature mix is re-read every step (a streaming pass over two
+    // columns) so edits made directly to the columns are never missed
+    bool damping = simulation_world.global_damping != 0.0f || (columns.damping && any_non_zero(simulation_world.damping, dynamic_count));
+    bool friction = columns.friction && any_non_zero(simulation_world.friction, dynamic_count);
 
-        // SoA arrays are the canonical storage.
+    // The SIMD variants load every column unconditionally
+    bool complete = columns.damping && columns.friction && columns.sleeping;
+    IntegratorKernel kernel = select_integrator_kernel(integrator, damping, friction);
+    if (integrator == IntegratorType::VERLET_POSITION && simd_level != SimdLevel::SCALAR && complete)
+        kernel = verlet_simd_kernel;
+    if (!thread_pool)
+    {
+        kernel(columns, params, 0, dynamic_count);
+        return;
     }
+    // Every body is integrated independently, so any split gives the same result
+    thread_pool->parallel_for((int)dynamic_count, [&](int begin, int end)
+                              { kernel(columns, params, (size_t)begin, (size_t)end); }, INTEGRATION_GRAIN);
 }
 
 void movementSystem::update(world &simulation_world, float delta_time)
 {
-    verlet_integration(simulation_world);
-}
\ No newline at end of file
+    integrate(simulation_world);
+}
@@ -0,0 +1,98 @@
+#include "sim/reorderSystem.hpp"
+#include "physics/world.hpp"
+#include <algorithm>
+#include <cmath>
+
+reorderSystem::reorderSystem(int interval_frames_in, float disorder_threshold_in)
+    : interval_frames(interval_frames_in), disorder_threshold(disorder_threshold_in)
+{
+}
+
+// Spreads the low 16 bits of v so there is a zero bit between each of them
+static uint32_t part_1_by_1(uint32_t v)
+{
+    v &= 0x0000ffff;
+    v = (v | (v << 8)) & 0x00ff00ff;
+    v = (v | (v << 4)) & 0x0f0f0f0f;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+uint32_t reorderSystem::morton_code(uint32_t cx, uint32_t cy)
+{
+    return part_1_by_1(cx) | (part_1_by_1(cy) << 1);
+}
+
+void reorderSystem::compute_codes(const world &simulation_world)
+{
+    size_t n = simulation_world.position_x.size();
+    const GridInfo &grid = simulation_world.grid_info;
+    float inv_cell_size = 1.0f / grid.cell_size;
+
+    codes.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        // Cells relative to the grid origin, clamped to the 16-bit Morton range
+        float fx = std::floor((simulation_world.position_x[i] - grid.min_x) * inv_cell_size);
+        float fy = std::floor((simulation_world.position_y[i] - grid.min_y) * inv_cell_size);
+        uint32_t cx = (uint32_t)std::min(std::max(fx, 0.0f), 65535.0f);
+        uint32_t cy = (uint32_t)std::min(std::max(fy, 0.0f), 65535.0f);
+        codes[i] = morton_code(cx, cy);
+    }
+}
+
+void reorderSystem::update(world &simulation_world, float dt)
+{
+    reordered = false;
+    size_t n = simulation_world.position_x.size();
+    ++frames_since_reorder;
+    if (n < 2)
+        return;
+
+    compute_codes(simulation_world);
+
+    // Locality metric: how many neighbours in memory are out of Z-order.
+    // permute_bodies keeps static bodies after the dynamic range, so each
+    // range is measured (and sorted) on its own; the step between the two
+    // ranges is not disorder.
+    size_t dynamic_count = std::min(simulation_world.dynamic_count, n);
+    size_t descents = 0;
+    size_t neighbours = 0;
+    for (size_t i = 1; i < n; ++i)
+    {
+        if (i == dynamic_count)
+            continue;
+        ++neighbours;
+        if (codes[i - 1] > codes[i])
+            ++descents;
+    }
+    disorder = neighbours > 0 ? float(descents) / float(neighbours) : 0.0f;
+
+    bool periodic_due = interval_frames > 0 && frames_since_reorder >= interval_frames;
+    bool metric_due = disorder > disorder_threshold;
+    if (!periodic_due && !metric_due)
+        return;
+    frames_since_reorder = 0;
+    if (descents == 0)
+        return; // already in order, keep indices stable
+
+    order.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        order[i] = (int)i;
+    // Stable on ties so bodies sharing a cell keep their relative order
+    auto by_code = [&](int a, int b)
+    { return codes[a] < codes[b]; };
+    std::stable_sort(order.begin(), order.begin() + dynamic_count, by_code);
+    std::stable_sort(order.begin() + dynamic_count, order.end(), by_code);
+
+    // Every permutation bumps body_layout_version and drops the caches keyed by index
+    bool identity = true;
+    for (size_t i = 0; i < n && identity; ++i)
+        identity = order[i] == (int)i;
+    if (identity)
+        return;
+
+    remap = simulation_world.permute_bodies(order);
+    reordered = true;
+}
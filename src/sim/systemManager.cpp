@@ -1,22 +1,159 @@
 // src/sim/systemManager.cpp (CORREGIDO)
 
 #include "sim/systemManager.hpp"
+#include "physics/world.hpp"
+#include "utils/threadPool.hpp"
 #include <utility>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Weight of the newest frame in the substep cost average
+const float SUBSTEP_COST_SMOOTHING = 0.2f;
 
 void systemManager::addSystem(std::unique_ptr<ISystem> sys)
 {
-
+    sys->set_thread_pool(thread_pool.get());
     systems.push_back(std::move(sys));
 }
 
-void systemManager::update(world &world, float dt)
+void systemManager::set_worker_threads(int threads)
 {
+    for (const auto &system_ptr : systems)
+        system_ptr->set_thread_pool(nullptr);
+    thread_pool = std::make_unique<threadPool>(threads);
+    for (const auto &system_ptr : systems)
+        system_ptr->set_thread_pool(thread_pool.get());
+}
+int systemManager::get_worker_threads() const { return thread_pool->thread_count(); }
 
+void systemManager::set_substepping(const SubstepSettings &settings)
+{
+    substep_settings = settings;
+    substep_settings.min_substeps = std::max(1, substep_settings.min_substeps);
+    substep_settings.max_substeps = std::max(substep_settings.min_substeps, substep_settings.max_substeps);
+}
+
+// K from the fastest body against the smallest radius, then capped by the budget.
+int systemManager::choose_substeps(const world &world, float dt) const
+{
+    float max_speed_squared = 0.0f;
+    float min_radius = 0.0f;
+    size_t n = world.dynamic_count;
+    for (size_t i = 0; i < n; ++i)
+    {
+        max_speed_squared = std::max(max_speed_squared, world.vel_x[i] * world.vel_x[i] + world.vel_y[i] * world.vel_y[i]);
+        if (min_radius == 0.0f || world.radius[i] < min_radius)
+            min_radius = world.radius[i];
+    }
+
+    int substeps = substep_settings.min_substeps;
+    float allowed_travel = substep_settings.max_travel_fraction * min_radius;
+    if (allowed_travel > 0.0f)
+    {
+        float travel = std::sqrt(max_speed_squared) * dt;
+        substeps = std::max(substeps, (int)std::ceil(travel / allowed_travel));
+    }
+    substeps = std::min(substeps, substep_settings.max_substeps);
+
+    if (substep_settings.frame_budget_us > 0.0f && substep_cost_us > 0.0f)
+    {
+        int affordable = (int)(substep_settings.frame_budget_us / substep_cost_us);
+        substeps = std::min(substeps, std::max(affordable, 1));
+    }
+    return substeps;
+}
+
+// Writing the layout moves every column
+static ColumnSet effective_writes(const ISystem &system)
+{
+    ColumnSet writes = system.writes();
+    return (writes & COLUMN_LAYOUT) ? COLUMNS_ALL : writes;
+}
+
+static bool systems_conflict(const ISystem &a, const ISystem &b)
+{
+    ColumnSet writes_a = effective_writes(a);
+    ColumnSet writes_b = effective_writes(b);
+    return (writes_a & (b.reads() | writes_b)) != 0 || (writes_b & a.reads()) != 0;
+}
+
+void systemManager::build_schedule(float substep_dt, float frame_dt, bool last_substep)
+{
+    schedule.clear();
+    schedule_levels = 0;
     for (const auto &system_ptr : systems)
     {
+        float dt = substep_dt;
+        if (system_ptr->schedule() == SystemSchedule::ONCE_PER_FRAME)
+        {
+            if (!last_substep)
+                continue;
+            dt = frame_dt;
+        }
+        int level = 0;
+        for (const ScheduledSystem &earlier : schedule)
+        {
+            if (earlier.level >= level && systems_conflict(*earlier.system, *system_ptr))
+                level = earlier.level + 1;
+        }
+        schedule.push_back({system_ptr.get(), dt, level});
+        schedule_levels = std::max(schedule_levels, level + 1);
+    }
+}
+
+void systemManager::run_systems(world &world, float substep_dt, float frame_dt, bool last_substep)
+{
+    build_schedule(substep_dt, frame_dt, last_substep);
+    for (int level = 0; level < schedule_levels; ++level)
+    {
+        level_systems.clear();
+        for (const ScheduledSystem &entry : schedule)
+        {
+            if (entry.level == level)
+                level_systems.push_back(entry);
+        }
+        if (level_systems.size() == 1)
+        {
+            level_systems[0].system->update(world, level_systems[0].dt);
+            continue;
+        }
+        // One task per system; each one can still spread its own loops over the pool
+        thread_pool->parallel_for((int)level_systems.size(), [&](int begin, int end)
+                                  {
+            for (int k = begin; k < end; ++k)
+                level_systems[k].system->update(world, level_systems[k].dt); }, 1);
+    }
+}
 
-        system_ptr->update(world, dt);
+void systemManager::update(world &world, float dt)
+{
+    if (!substep_settings.enabled)
+    {
+        last_substeps = 1;
+        ++world.substeps;
+        run_systems(world, dt, dt, true);
+        return;
     }
+
+    int substeps = choose_substeps(world, dt);
+    float frame_delta_time = world.delta_time;
+    float substep_dt = dt / (float)substeps;
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    world.set_time_step(substep_dt);
+    for (int s = 0; s < substeps; ++s)
+        run_systems(world, substep_dt, dt, s == substeps - 1);
+    world.set_time_step(frame_delta_time);
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    float frame_us = (float)std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+    float cost = frame_us / (float)substeps;
+    substep_cost_us = (substep_cost_us == 0.0f) ? cost : substep_cost_us + SUBSTEP_COST_SMOOTHING * (cost - substep_cost_us);
+
+    last_substeps = substeps;
+    world.substeps += (unsigned long long)substeps;
 }
 
-systemManager::systemManager() {}
+systemManager::systemManager(int worker_threads) : thread_pool(std::make_unique<threadPool>(worker_threads)) {}
+systemManager::~systemManager() = default;
@@ -0,0 +1,215 @@
+#include "sim/verletKernels.hpp"
+#include "sim/integratorPolicies.hpp"
+#include "sim/simdExp.hpp"
+#include <cstring>
+
+// Tails and the non-x86 fallback: the same formulas, one body at a time
+static const IntegratorKernel verlet_kernel_tail = integrate_bodies<VerletPositionPolicy, true, true>;
+
+#ifdef SIMD_X86_KERNELS
+
+// ====================================================================
+// --- SSE2 (4 bodies per iteration) ---
+// ====================================================================
+
+static inline __m128 select_ps_sse2(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static void verlet_kernel_sse2(const IntegratorColumns &c, const IntegratorStepParams &p, size_t begin, size_t end)
+{
+    const float dt_s = p.delta_time;
+    const __m128 dt = _mm_set1_ps(dt_s);
+    const __m128 dt2 = _mm_set1_ps(dt_s * dt_s);
+    const __m128 half_inv_dt = _mm_set1_ps(0.5f / dt_s);
+    const __m128 gx = _mm_set1_ps(p.gravity_x);
+    const __m128 gy = _mm_set1_ps(p.gravity_y);
+    const __m128 global_damping = _mm_set1_ps(p.global_damping);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        // Awake lanes: 4 sleeping bytes widened to 32 bits and compared with 0
+        int32_t sleep_bytes;
+        std::memcpy(&sleep_bytes, c.sleeping + i, sizeof(sleep_bytes));
+        __m128i sleep_words = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(sleep_bytes), _mm_setzero_si128()), _mm_setzero_si128());
+        __m128 awake = _mm_castsi128_ps(_mm_cmpeq_epi32(sleep_words, _mm_setzero_si128()));
+        __m128 active = _mm_and_ps(_mm_cmpgt_ps(_mm_loadu_ps(c.inv_mass + i), zero), awake);
+        if (_mm_movemask_ps(active) == 0)
+            continue;
+
+        __m128 d = _mm_loadu_ps(c.damping + i);
+        __m128 drag = _mm_add_ps(d, _mm_loadu_ps(c.friction + i));
+        __m128 vx = _mm_loadu_ps(c.vel_x + i);
+        __m128 vy = _mm_loadu_ps(c.vel_y + i);
+        __m128 ax = _mm_sub_ps(gx, _mm_mul_ps(vx, drag));
+        __m128 ay = _mm_sub_ps(gy, _mm_mul_ps(vy, drag));
+
+        __m128 x = _mm_loadu_ps(c.position_x + i);
+        __m128 y = _mm_loadu_ps(c.position_y + i);
+        __m128 prev_x = _mm_loadu_ps(c.previous_position_x + i);
+        __m128 prev_y = _mm_loadu_ps(c.previous_position_y + i);
+        __m128 next_x = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, two), prev_x), _mm_mul_ps(ax, dt2));
+        __m128 next_y = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(y, two), prev_y), _mm_mul_ps(ay, dt2));
+
+        __m128 new_vx = _mm_mul_ps(_mm_sub_ps(next_x, prev_x), half_inv_dt);
+        __m128 new_vy = _mm_mul_ps(_mm_sub_ps(next_y, prev_y), half_inv_dt);
+        __m128 combined_damping = _mm_add_ps(global_damping, d);
+        __m128 damped = _mm_cmpgt_ps(combined_damping, zero);
+        __m128 factor = exp_approx_sse2(_mm_mul_ps(_mm_sub_ps(zero, combined_damping), dt));
+        new_vx = select_ps_sse2(damped, _mm_mul_ps(new_vx, factor), new_vx);
+        new_vy = select_ps_sse2(damped, _mm_mul_ps(new_vy, factor), new_vy);
+        __m128 new_prev_x = select_ps_sse2(damped, _mm_sub_ps(next_x, _mm_mul_ps(new_vx, dt)), x);
+        __m128 new_prev_y = select_ps_sse2(damped, _mm_sub_ps(next_y, _mm_mul_ps(new_vy, dt)), y);
+
+        _mm_storeu_ps(c.position_x + i, select_ps_sse2(active, next_x, x));
+        _mm_storeu_ps(c.position_y + i, select_ps_sse2(active, next_y, y));
+        _mm_storeu_ps(c.previous_position_x + i, select_ps_sse2(active, new_prev_x, prev_x));
+        _mm_storeu_ps(c.previous_position_y + i, select_ps_sse2(active, new_prev_y, prev_y));
+        _mm_storeu_ps(c.vel_x + i, select_ps_sse2(active, new_vx, vx));
+        _mm_storeu_ps(c.vel_y + i, select_ps_sse2(active, new_vy, vy));
+    }
+    verlet_kernel_tail(c, p, i, end);
+}
+
+// ====================================================================
+// --- AVX2 (8 bodies per iteration) ---
+// ====================================================================
+
+__attribute__((target("avx2"))) static void verlet_kernel_avx2(const IntegratorColumns &c, const IntegratorStepParams &p, size_t begin, size_t end)
+{
+    const float dt_s = p.delta_time;
+    const __m256 dt = _mm256_set1_ps(dt_s);
+    const __m256 dt2 = _mm256_set1_ps(dt_s * dt_s);
+    const __m256 half_inv_dt = _mm256_set1_ps(0.5f / dt_s);
+    const __m256 gx = _mm256_set1_ps(p.gravity_x);
+    const __m256 gy = _mm256_set1_ps(p.gravity_y);
+    const __m256 global_damping = _mm256_set1_ps(p.global_damping);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 two = _mm256_set1_ps(2.0f);
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256i sleep_words = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(c.sleeping + i)));
+        __m256 awake = _mm256_castsi256_ps(_mm256_cmpeq_epi32(sleep_words, _mm256_setzero_si256()));
+        __m256 active = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(c.inv_mass + i), zero, _CMP_GT_OQ), awake);
+        if (_mm256_movemask_ps(active) == 0)
+            continue;
+
+        __m256 d = _mm256_loadu_ps(c.damping + i);
+        __m256 drag = _mm256_add_ps(d, _mm256_loadu_ps(c.friction + i));
+        __m256 vx = _mm256_loadu_ps(c.vel_x + i);
+        __m256 vy = _mm256_loadu_ps(c.vel_y + i);
+        __m256 ax = _mm256_sub_ps(gx, _mm256_mul_ps(vx, drag));
+        __m256 ay = _mm256_sub_ps(gy, _mm256_mul_ps(vy, drag));
+
+        __m256 x = _mm256_loadu_ps(c.position_x + i);
+        __m256 y = _mm256_loadu_ps(c.position_y + i);
+        __m256 prev_x = _mm256_loadu_ps(c.previous_position_x + i);
+        __m256 prev_y = _mm256_loadu_ps(c.previous_position_y + i);
+        __m256 next_x = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(x, two), prev_x), _mm256_mul_ps(ax, dt2));
+        __m256 next_y = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(y, two), prev_y), _mm256_mul_ps(ay, dt2));
+
+        __m256 new_vx = _mm256_mul_ps(_mm256_sub_ps(next_x, prev_x), half_inv_dt);
+        __m256 new_vy = _mm256_mul_ps(_mm256_sub_ps(next_y, prev_y), half_inv_dt);
+        __m256 combined_damping = _mm256_add_ps(global_damping, d);
+        __m256 damped = _mm256_cmp_ps(combined_damping, zero, _CMP_GT_OQ);
+        __m256 factor = exp_approx_avx2(_mm256_mul_ps(_mm256_sub_ps(zero, combined_damping), dt));
+        new_vx = _mm256_blendv_ps(new_vx, _mm256_mul_ps(new_vx, factor), damped);
+        new_vy = _mm256_blendv_ps(new_vy, _mm256_mul_ps(new_vy, factor), damped);
+        __m256 new_prev_x = _mm256_blendv_ps(x, _mm256_sub_ps(next_x, _mm256_mul_ps(new_vx, dt)), damped);
+        __m256 new_prev_y = _mm256_blendv_ps(y, _mm256_sub_ps(next_y, _mm256_mul_ps(new_vy, dt)), damped);
+
+        _mm256_storeu_ps(c.position_x + i, _mm256_blendv_ps(x, next_x, active));
+        _mm256_storeu_ps(c.position_y + i, _mm256_blendv_ps(y, next_y, active));
+        _mm256_storeu_ps(c.previous_position_x + i, _mm256_blendv_ps(prev_x, new_prev_x, active));
+        _mm256_storeu_ps(c.previous_position_y + i, _mm256_blendv_ps(prev_y, new_prev_y, active));
+        _mm256_storeu_ps(c.vel_x + i, _mm256_blendv_ps(vx, new_vx, active));
+        _mm256_storeu_ps(c.vel_y + i, _mm256_blendv_ps(vy, new_vy, active));
+    }
+    verlet_kernel_tail(c, p, i, end);
+}
+
+// ====================================================================
+// --- AVX-512 (16 bodies per iteration, mask registers) ---
+// ====================================================================
+
+__attribute__((target("avx512f"))) static void verlet_kernel_avx512(const IntegratorColumns &c, const IntegratorStepParams &p, size_t begin, size_t end)
+{
+    const float dt_s = p.delta_time;
+    const __m512 dt = _mm512_set1_ps(dt_s);
+    const __m512 dt2 = _mm512_set1_ps(dt_s * dt_s);
+    const __m512 half_inv_dt = _mm512_set1_ps(0.5f / dt_s);
+    const __m512 gx = _mm512_set1_ps(p.gravity_x);
+    const __m512 gy = _mm512_set1_ps(p.gravity_y);
+    const __m512 global_damping = _mm512_set1_ps(p.global_damping);
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 two = _mm512_set1_ps(2.0f);
+
+    size_t i = begin;
+    for (; i + 16 <= end; i += 16)
+    {
+        __m512i sleep_words = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i *)(c.sleeping + i)));
+        __mmask16 awake = _mm512_cmpeq_epi32_mask(sleep_words, _mm512_setzero_si512());
+        __mmask16 active = _mm512_mask_cmp_ps_mask(awake, _mm512_loadu_ps(c.inv_mass + i), zero, _CMP_GT_OQ);
+        if (active == 0)
+            continue;
+
+        __m512 d = _mm512_loadu_ps(c.damping + i);
+        __m512 drag = _mm512_add_ps(d, _mm512_loadu_ps(c.friction + i));
+        __m512 vx = _mm512_loadu_ps(c.vel_x + i);
+        __m512 vy = _mm512_loadu_ps(c.vel_y + i);
+        __m512 ax = _mm512_sub_ps(gx, _mm512_mul_ps(vx, drag));
+        __m512 ay = _mm512_sub_ps(gy, _mm512_mul_ps(vy, drag));
+
+        __m512 x = _mm512_loadu_ps(c.position_x + i);
+        __m512 y = _mm512_loadu_ps(c.position_y + i);
+        __m512 prev_x = _mm512_loadu_ps(c.previous_position_x + i);
+        __m512 prev_y = _mm512_loadu_ps(c.previous_position_y + i);
+        __m512 next_x = _mm512_add_ps(_mm512_sub_ps(_mm512_mul_ps(x, two), prev_x), _mm512_mul_ps(ax, dt2));
+        __m512 next_y = _mm512_add_ps(_mm512_sub_ps(_mm512_mul_ps(y, two), prev_y), _mm512_mul_ps(ay, dt2));
+
+        __m512 new_vx = _mm512_mul_ps(_mm512_sub_ps(next_x, prev_x), half_inv_dt);
+        __m512 new_vy = _mm512_mul_ps(_mm512_sub_ps(next_y, prev_y), half_inv_dt);
+        __m512 combined_damping = _mm512_add_ps(global_damping, d);
+        __mmask16 damped = _mm512_cmp_ps_mask(combined_damping, zero, _CMP_GT_OQ);
+        __m512 factor = exp_approx_avx512(_mm512_mul_ps(_mm512_sub_ps(zero, combined_damping), dt));
+        new_vx = _mm512_mask_mul_ps(new_vx, damped, new_vx, factor);
+        new_vy = _mm512_mask_mul_ps(new_vy, damped, new_vy, factor);
+        __m512 new_prev_x = _mm512_mask_sub_ps(x, damped, next_x, _mm512_mul_ps(new_vx, dt));
+        __m512 new_prev_y = _mm512_mask_sub_ps(y, damped, next_y, _mm512_mul_ps(new_vy, dt));
+
+        // Masked stores leave static and sleeping bodies untouched
+        _mm512_mask_storeu_ps(c.position_x + i, active, next_x);
+        _mm512_mask_storeu_ps(c.position_y + i, active, next_y);
+        _mm512_mask_storeu_ps(c.previous_position_x + i, active, new_prev_x);
+        _mm512_mask_storeu_ps(c.previous_position_y + i, active, new_prev_y);
+        _mm512_mask_storeu_ps(c.vel_x + i, active, new_vx);
+        _mm512_mask_storeu_ps(c.vel_y + i, active, new_vy);
+    }
+    verlet_kernel_tail(c, p, i, end);
+}
+
+#endif
+
+IntegratorKernel select_verlet_kernel(SimdLevel level)
+{
+#ifdef SIMD_X86_KERNELS
+    switch (level)
+    {
+    case SimdLevel::AVX512:
+        return verlet_kernel_avx512;
+    case SimdLevel::AVX2:
+        return verlet_kernel_avx2;
+    case SimdLevel::SSE2:
+        return verlet_kernel_sse2;
+    default:
+        break;
+    }
+#endif
+    return verlet_kernel_tail;
+}
@@ -0,0 +1,59 @@
+#include "sim/worldEnsemble.hpp"
+#include "sim/energySystem.hpp"
+#include <algorithm>
+#include <chrono>
+
+worldEnsemble::worldEnsemble(int thread_count) : pool(thread_count) {}
+worldEnsemble::~worldEnsemble() = default;
+
+size_t worldEnsemble::add_world(world member_world, const SystemSetup &setup)
+{
+    auto member = std::make_unique<Member>(std::move(member_world));
+    if (setup)
+        setup(member->manager);
+    auto energy = std::make_unique<energySystem>();
+    member->energy = energy.get();
+    member->manager.addSystem(std::move(energy));
+    members.push_back(std::move(member));
+    return members.size() - 1;
+}
+
+void worldEnsemble::step_member(Member &member, int frames)
+{
+    world &w = member.sim_world;
+    EnsembleMetrics &metrics = member.metrics;
+    for (int f = 0; f < frames; ++f)
+    {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        member.manager.update(w, w.delta_time);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        double frame_us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+        ++metrics.frames;
+        metrics.step_us += frame_us;
+        metrics.max_frame_us = std::max(metrics.max_frame_us, frame_us);
+        metrics.contacts += w.solver_contacts;
+        metrics.substeps += w.substeps;
+        // Per-frame accumulators, as the benchmark resets them
+        w.solver_contacts = 0;
+        w.substeps = 0;
+    }
+    metrics.sleeping_bodies = w.sleeping_bodies;
+    metrics.kinetic_energy = member.energy->get_kinetic_energy();
+    metrics.total_energy = member.energy->get_total_energy();
+}
+
+// One member per task: members differ in cost, so ranges stay a single member
+void worldEnsemble::step(int frames)
+{
+    pool.parallel_for((int)members.size(), [&](int begin, int end)
+                      {
+        for (int m = begin; m < end; ++m)
+            step_member(*members[m], frames); }, 1);
+}
+
+void worldEnsemble::reset_metrics()
+{
+    for (auto &member : members)
+        member->metrics = EnsembleMetrics();
+}
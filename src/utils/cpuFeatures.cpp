@@ -0,0 +1,62 @@
+#include "utils/cpuFeatures.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <cstdint>
+
+// XCR0: which register states the OS saves on a context switch
+static uint64_t read_xcr0()
+{
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+}
+
+static SimdLevel query_simd_level()
+{
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return SimdLevel::SSE2;
+    const bool osxsave = (ecx & bit_OSXSAVE) != 0;
+    const bool avx = (ecx & bit_AVX) != 0;
+    if (!osxsave || !avx)
+        return SimdLevel::SSE2;
+
+    uint64_t xcr0 = read_xcr0();
+    const uint64_t ymm_state = 0x6;   // SSE + AVX
+    const uint64_t zmm_state = 0xE6;  // + opmask, ZMM0-15 upper halves, ZMM16-31
+    if ((xcr0 & ymm_state) != ymm_state)
+        return SimdLevel::SSE2;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return SimdLevel::SSE2;
+    if ((ebx & bit_AVX512F) && (xcr0 & zmm_state) == zmm_state)
+        return SimdLevel::AVX512;
+    if (ebx & bit_AVX2)
+        return SimdLevel::AVX2;
+    return SimdLevel::SSE2;
+}
+#else
+static SimdLevel query_simd_level() { return SimdLevel::SCALAR; }
+#endif
+
+SimdLevel detect_simd_level()
+{
+    static const SimdLevel level = query_simd_level();
+    return level;
+}
+
+const char *simd_level_name(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::SSE2:
+        return "sse2";
+    case SimdLevel::AVX2:
+        return "avx2";
+    case SimdLevel::AVX512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
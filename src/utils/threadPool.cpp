@@ -0,0 +1,164 @@
+#include "utils/threadPool.hpp"
+#include <algorithm>
+
+// Pool and deque of the current thread when it is one of the workers
+static thread_local const threadPool *current_pool = nullptr;
+static thread_local int current_worker_queue = 0;
+
+threadPool::threadPool(int thread_count)
+{
+    if (thread_count <= 0)
+        thread_count = std::max(1, (int)std::thread::hardware_concurrency());
+
+    for (int q = 0; q < thread_count; ++q)
+        queues.push_back(std::make_unique<WorkQueue>());
+    // Worker w owns deque w; deque 0 belongs to the callers
+    for (int w = 1; w < thread_count; ++w)
+        workers.emplace_back(&threadPool::worker_loop, this, w);
+}
+
+threadPool::~threadPool()
+{
+    stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        wake.notify_all();
+    }
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+int threadPool::current_queue() const
+{
+    return (current_pool == this) ? current_worker_queue : 0;
+}
+
+void threadPool::notify(bool everyone)
+{
+    if (sleepers.load() == 0)
+        return;
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    if (everyone)
+        wake.notify_all();
+    else
+        wake.notify_one();
+}
+
+// `ready` is checked under sleep_mutex after registering as a sleeper, and
+// notify() reads the sleeper count after publishing its change, so a
+// wake-up is never lost between the check and the wait.
+template <typename Predicate>
+void threadPool::sleep_until(Predicate &&ready)
+{
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    sleepers.fetch_add(1);
+    wake.wait(lock, [&]
+              { return stopping.load() || ready(); });
+    sleepers.fetch_sub(1);
+}
+
+void threadPool::push(int queue, const Range &range)
+{
+    {
+        std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+        queues[queue]->ranges.push_back(range);
+    }
+    queued_ranges.fetch_add(1);
+    notify(false);
+}
+
+bool threadPool::take(int queue, Range &range)
+{
+    {
+        WorkQueue &own = *queues[queue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.ranges.empty())
+        {
+            range = own.ranges.back();
+            own.ranges.pop_back();
+            queued_ranges.fetch_sub(1);
+            return true;
+        }
+    }
+    int queue_count = (int)queues.size();
+    for (int offset = 1; offset < queue_count; ++offset)
+    {
+        WorkQueue &victim = *queues[(queue + offset) % queue_count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.ranges.empty())
+        {
+            range = victim.ranges.front();
+            victim.ranges.pop_front();
+            queued_ranges.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void threadPool::run(int queue, Range range)
+{
+    Job *job = range.job;
+    while (range.end - range.begin > job->grain)
+    {
+        int middle = range.begin + (range.end - range.begin) / 2;
+        push(queue, {job, middle, range.end});
+        range.end = middle;
+    }
+    (*job->task)(range.begin, range.end);
+
+    // The job may be gone as soon as `remaining` reaches zero
+    int items = range.end - range.begin;
+    if (job->remaining.fetch_sub(items) == items)
+        notify(true);
+}
+
+void threadPool::parallel_for(int count, const std::function<void(int, int)> &task, int grain)
+{
+    if (count <= 0)
+        return;
+    grain = std::max(grain, 1);
+    if (workers.empty() || count <= grain)
+    {
+        task(0, count);
+        return;
+    }
+
+    Job job;
+    job.task = &task;
+    job.grain = grain;
+    job.remaining = count;
+
+    int queue = current_queue();
+    run(queue, {&job, 0, count});
+
+    // Help with whatever is queued (ranges of this loop first) until the loop is done
+    while (job.remaining.load() > 0)
+    {
+        Range range;
+        if (take(queue, range))
+        {
+            run(queue, range);
+            continue;
+        }
+        sleep_until([&]
+                    { return job.remaining.load() == 0 || queued_ranges.load() > 0; });
+    }
+}
+
+void threadPool::worker_loop(int queue)
+{
+    current_pool = this;
+    current_worker_queue = queue;
+    while (!stopping.load())
+    {
+        Range range;
+        if (take(queue, range))
+        {
+            run(queue, range);
+            continue;
+        }
+        sleep_until([&]
+                    { return queued_ranges.load() > 0; });
+    }
+}
@@ -4,6 +4,20 @@ void test_world_constructors();
 void test_world_random_initialization();
 void test_collision_elastic();
 void test_collision_static();
+void test_continuous_collision();
+void test_broadphase();
+void test_morton_reorder();
+void test_contacts();
+void test_substepping();
+void test_sleeping();
+void test_simd_integrator();
+void test_integrators();
+void test_static_bodies();
+void test_thread_pool();
+void test_scheduling();
+void test_pipelining();
+void test_world_ensemble();
+void test_lane_ensemble();
 
 int main()
 {
@@ -14,8 +28,21 @@ int main()
 
     test_collision_elastic();
     test_collision_static();
+    test_continuous_collision();
 
-    // Removed specific integrator stability tests as only Verlet is used now.
+    test_broadphase();
+    test_morton_reorder();
+    test_contacts();
+    test_substepping();
+    test_sleeping();
+    test_simd_integrator();
+    test_integrators();
+    test_static_bodies();
+    test_thread_pool();
+    test_scheduling();
+    test_pipelining();
+    test_world_ensemble();
+    test_lane_ensemble();
 
     std::cout << "================= TESTS FINISHED =================\n";
     return 0;
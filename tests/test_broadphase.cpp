@@ -0,0 +1,252 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+
+// tests/test_broadphase.cpp
+
+// Small packed pile: bodies start overlapping so every frame has contacts.
+static world create_pile_world(int num_bodies)
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 0.016f;
+    int cols = 12;
+    for (int i = 0; i < num_bodies; ++i)
+    {
+        float px = (i % cols - cols / 2) * 1.8f;
+        float py = 2.0f + (i / cols) * 1.8f;
+        w.add_body(create_body(px, py, 0.0f, 0.0f, 1.0f, 1.0f, 0.5f));
+    }
+    return w;
+}
+
+static float max_position_difference(const world &a, const world &b)
+{
+    float max_diff = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        max_diff = std::max(max_diff, std::fabs(a.position_x[i] - b.position_x[i]));
+        max_diff = std::max(max_diff, std::fabs(a.position_y[i] - b.position_y[i]));
+    }
+    return max_diff;
+}
+
+static void step_world(world &w, std::unique_ptr<collisionSystem> collision, int frames)
+{
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::move(collision));
+    for (int f = 0; f < frames; ++f)
+        manager.update(w, w.delta_time);
+}
+
+void test_streaming_matches_materialized()
+{
+    std::cout << "\n--- TEST: Streaming vs Materialized Pair Generation ---\n";
+
+    world materialized = create_pile_world(60);
+    world streaming = create_pile_world(60);
+
+    auto cs_materialized = std::make_unique<collisionSystem>();
+    cs_materialized->set_pair_generation_mode(PairGenerationMode::MATERIALIZED);
+    auto cs_streaming = std::make_unique<collisionSystem>();
+    cs_streaming->set_pair_generation_mode(PairGenerationMode::STREAMING);
+
+    step_world(materialized, std::move(cs_materialized), 30);
+    step_world(streaming, std::move(cs_streaming), 30);
+
+    std::cout << "Max position difference after 30 steps: " << max_position_difference(materialized, streaming) << " (Should be 0)\n";
+}
+
+// Isolated head-on pairs spread over the world: every backend must find each
+// contact exactly once, so one collision update gives identical velocities.
+static world create_isolated_pairs_world()
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = 0.0f;
+    w.delta_time = 0.016f;
+    for (int k = 0; k < 20; ++k)
+    {
+        float cx = -80.0f + (k % 5) * 40.0f;
+        float cy = 10.0f + (k / 5) * 20.0f;
+        w.add_body(create_body(cx - 0.95f, cy, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f));
+        w.add_body(create_body(cx + 0.95f, cy, -1.0f, 0.0f, 1.0f, 1.0f, 1.0f));
+    }
+    return w;
+}
+
+static int count_bounced_bodies(const world &w)
+{
+    int bounced = 0;
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        // Left body of each pair started with +1, right body with -1
+        float initial_vx = (i % 2 == 0) ? 1.0f : -1.0f;
+        if (w.vel_x[i] * initial_vx < 0.0f)
+            ++bounced;
+    }
+    return bounced;
+}
+
+void test_broadphase_backends_agree()
+{
+    std::cout << "\n--- TEST: Broad Phase Backends Find The Same Contacts ---\n";
+
+    const BroadPhaseType types[] = {BroadPhaseType::UNIFORM_GRID, BroadPhaseType::SWEEP_AND_PRUNE, BroadPhaseType::AABB_TREE, BroadPhaseType::HIERARCHICAL_GRID, BroadPhaseType::HASHED_GRID};
+    const char *names[] = {"grid", "sap", "bvh", "hgrid", "hash"};
+
+    for (int t = 0; t < 5; ++t)
+    {
+        world w = create_isolated_pairs_world();
+        collisionSystem cs;
+        cs.set_broad_phase(types[t]);
+        cs.update(w, w.delta_time);
+        std::cout << names[t] << ": bounced bodies " << count_bounced_bodies(w) << " / " << w.size() << " (Should be " << w.size() << ")\n";
+    }
+}
+
+// A boulder much larger than GridInfo::cell_size touching a small grain: the
+// uniform grid only looks one cell away, the AABB tree and the hierarchical
+// grid handle any radius.
+void test_large_radius_contacts()
+{
+    std::cout << "\n--- TEST: Broad Phase With Heterogeneous Radii ---\n";
+
+    const BroadPhaseType types[] = {BroadPhaseType::AABB_TREE, BroadPhaseType::HIERARCHICAL_GRID};
+    const char *names[] = {"bvh", "hgrid"};
+
+    for (int t = 0; t < 2; ++t)
+    {
+        world w;
+        w.gravity_x = 0.0f;
+        w.gravity_y = 0.0f;
+        w.delta_time = 0.016f;
+        w.add_body(create_body(0.0f, 40.0f, 0.0f, 0.0f, 100.0f, 12.0f, 1.0f));
+        w.add_body(create_body(12.4f, 40.0f, -1.0f, 0.0f, 1.0f, 0.5f, 1.0f));
+
+        collisionSystem cs;
+        cs.set_broad_phase(types[t]);
+        cs.update(w, w.delta_time);
+
+        std::cout << names[t] << ": grain velocity X after touching the boulder: " << w.vel_x[1] << " (Should be > 0)\n";
+    }
+}
+
+// Extremes for the hierarchical grid, in an unbounded world: a boulder over
+// 2^15 times wider than the finest cell (set by a 0.01 grain), and a pair so far
+// out that its fine-level cell coordinates exceed the key range.
+static float hgrid_grain_bounce(float boulder_x, float boulder_radius, float grain_x, float grain_radius)
+{
+    world w = create_test_world(vec2(0.0f, 0.0f), 0.016f);
+    w.grid_info.bounded = false;
+    w.add_body(create_body(boulder_x, 0.0f, 0.0f, 0.0f, 100.0f, boulder_radius, 1.0f));
+    w.add_body(create_body(grain_x, 0.0f, -1.0f, 0.0f, 1.0f, grain_radius, 1.0f));
+    w.add_body(create_body(0.0f, -20000.0f, 0.0f, 0.0f, 1.0f, 0.01f, 1.0f));
+    collisionSystem cs;
+    cs.set_broad_phase(BroadPhaseType::HIERARCHICAL_GRID);
+    cs.update(w, w.delta_time);
+    return w.vel_x[1];
+}
+
+void test_hgrid_extremes()
+{
+    std::cout << "\n--- TEST: Hierarchical Grid Level And Coordinate Limits ---\n";
+
+    std::cout << "Grain velocity X after touching a boulder of radius 5000: " << hgrid_grain_bounce(0.0f, 5000.0f, 5000.005f, 0.01f) << " (Should be > 0)\n";
+    std::cout << "Grain velocity X after touching a boulder at x = 1e9: " << hgrid_grain_bounce(1e9f, 100.0f, 1e9f + 64.0f, 0.5f) << " (Should be > 0)\n";
+}
+
+// Two bodies touching vertically outside the GridInfo bounds. In a bounded
+// world the flat grid skips them (get_grid_index returns -1) while the hashed
+// grid still pairs them. In an unbounded world (GridInfo::bounded = false)
+// nothing pulls them back and every broad phase pairs them.
+static world create_outside_pair_world(bool bounded)
+{
+    world w = create_test_world(vec2(0.0f, 0.0f), 0.016f);
+    w.grid_info.bounded = bounded;
+    w.add_body(create_moving_body(w, 150.0f, 49.05f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f));
+    w.add_body(create_moving_body(w, 150.0f, 50.95f, 0.0f, -1.0f, 1.0f, 1.0f, 1.0f));
+    return w;
+}
+
+void test_hashed_grid_outside_bounds()
+{
+    std::cout << "\n--- TEST: Hashed Grid Outside GridInfo Bounds ---\n";
+
+    const BroadPhaseType types[] = {BroadPhaseType::UNIFORM_GRID, BroadPhaseType::HASHED_GRID};
+    const char *names[] = {"grid", "hash"};
+
+    for (int t = 0; t < 2; ++t)
+    {
+        world w = create_outside_pair_world(true);
+        collisionSystem cs;
+        cs.set_broad_phase(types[t]);
+        cs.update(w, w.delta_time);
+        std::cout << names[t] << ", bounded world: lower body velocity Y: " << w.vel_y[0] << (t == 0 ? " (missed, stays 1)\n" : " (Should be -1)\n");
+    }
+
+    for (int t = 0; t < 2; ++t)
+    {
+        world w = create_outside_pair_world(false);
+        systemManager manager;
+        add_movement_and_collision(manager, [&](collisionSystem &collision)
+                                   { collision.set_broad_phase(types[t]); });
+        for (int f = 0; f < 10; ++f)
+            manager.update(w, w.delta_time);
+        std::cout << names[t] << ", unbounded world: lower body velocity Y: " << w.vel_y[0] << ", position X: " << w.position_x[0] << ", " << w.position_x[1]
+                  << " (Should be about -1, 150, 150)\n";
+    }
+}
+
+// A settling pile barely moves: the Verlet list must be reused for most frames.
+// Built on top of any backend, the list still finds every isolated contact.
+void test_neighbour_list_rebuilds()
+{
+    std::cout << "\n--- TEST: Verlet Neighbour List Rebuilds ---\n";
+
+    world pile = create_pile_world(60);
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    auto cs_listed = std::make_unique<collisionSystem>();
+    cs_listed->set_neighbour_list(true, 0.5f);
+    manager.addSystem(std::move(cs_listed));
+
+    const int frames = 60;
+    unsigned long long rebuilds = 0;
+    for (int f = 0; f < frames; ++f)
+    {
+        manager.update(pile, pile.delta_time);
+        rebuilds += pile.neighbour_list_rebuilds;
+        pile.neighbour_list_rebuilds = 0;
+    }
+    std::cout << "Neighbour list rebuilds over " << frames << " frames: " << rebuilds << " (Should be well below " << frames << ")\n";
+
+    const BroadPhaseType types[] = {BroadPhaseType::UNIFORM_GRID, BroadPhaseType::SWEEP_AND_PRUNE, BroadPhaseType::AABB_TREE, BroadPhaseType::HIERARCHICAL_GRID, BroadPhaseType::HASHED_GRID};
+    const char *names[] = {"grid", "sap", "bvh", "hgrid", "hash"};
+    for (int t = 0; t < 5; ++t)
+    {
+        world w = create_isolated_pairs_world();
+        collisionSystem cs;
+        cs.set_broad_phase(types[t]);
+        cs.set_neighbour_list(true, 0.5f);
+        cs.update(w, w.delta_time);
+        std::cout << names[t] << " + neighbour list: bounced bodies " << count_bounced_bodies(w) << " / " << w.size() << " (Should be " << w.size() << ")\n";
+    }
+}
+
+void test_broadphase()
+{
+    test_streaming_matches_materialized();
+    test_broadphase_backends_agree();
+    test_large_radius_contacts();
+    test_hgrid_extremes();
+    test_hashed_grid_outside_bounds();
+    test_neighbour_list_rebuilds();
+}
@@ -1,6 +1,9 @@
 #include "utilities/test_helpers.hpp"
 #include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
 #include <iostream>
+#include <memory>
 
 // tests/test_collisions.cpp
 
@@ -53,4 +56,59 @@ void test_collision_static()
     cs.update(w, 0.016f);
 
     std::cout << "Velocity A X: " << w.vel_x[0] << ", Velocity B X: " << w.vel_x[1] << "\n";
-}
\ No newline at end of file
+}
+// A small disc moving 3 units per step at 30 Hz toward a static disc: the
+// pair never overlaps at the end of a step, so only the swept test sees it.
+// offset_x moves the whole scene (outside GridInfo when beyond +-100).
+static float run_fast_disc(bool continuous, float offset_x = 0.0f, bool bounded = true)
+{
+    world w = create_test_world(vec2(0.0f, 0.0f), 1.0f / 30.0f);
+    w.grid_info.bounded = bounded;
+    w.add_body(create_body(offset_x - 10.5f, 10.0f, 0.0f, 0.0f, 1.0f, 0.5f, 1.0f));
+    w.add_body(create_body(offset_x, 10.0f, 0.0f, 0.0f, 0.0f, 0.5f, 1.0f));
+    w.previous_position_x[0] = offset_x - 13.5f; // Verlet velocity of 90 units/s
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    auto collision = std::make_unique<collisionSystem>();
+    collision->set_continuous_collision(continuous);
+    manager.addSystem(std::move(collision));
+    for (int f = 0; f < 8; ++f)
+        manager.update(w, w.delta_time);
+    return w.position_x[0] - offset_x;
+}
+
+// Same disc moving diagonally (3 units per axis per step) in an unbounded
+// world, next to a field of static pegs and one body 1e30 units away: the
+// sweep walks the hash cells along its path and clamps far cell coordinates.
+static float run_diagonal_fast_disc()
+{
+    world w = create_test_world(vec2(0.0f, 0.0f), 1.0f / 30.0f);
+    w.grid_info.bounded = false;
+    w.add_body(create_body(292.5f, 292.5f, 0.0f, 0.0f, 1.0f, 0.5f, 1.0f));
+    w.add_body(create_body(300.0f, 300.0f, 0.0f, 0.0f, 0.0f, 0.5f, 1.0f));
+    w.add_body(create_body(1e30f, -1e30f, 0.0f, 0.0f, 0.0f, 0.5f, 1.0f));
+    add_body_lattice(w, 400, 20, 200.0f, -200.0f, 5.0f, 5.0f, 0.0f, 0.5f);
+    w.previous_position_x[0] = 289.5f;
+    w.previous_position_y[0] = 289.5f;
+
+    systemManager manager;
+    add_movement_and_collision(manager, [](collisionSystem &collision)
+                               { collision.set_continuous_collision(true); });
+    for (int f = 0; f < 8; ++f)
+        manager.update(w, w.delta_time);
+    return w.position_x[0] - 300.0f;
+}
+
+void test_continuous_collision()
+{
+    std::cout << "\n--- TEST: Continuous Collision (Swept Circles) ---\n";
+
+    std::cout << "Fast disc X without CCD: " << run_fast_disc(false) << " (Should be > 0, it tunnels through)\n";
+    std::cout << "Fast disc X with CCD: " << run_fast_disc(true) << " (Should be < 0, it bounces back)\n";
+    // Unbounded world: the sweep must also find static bodies outside GridInfo
+    std::cout << "Fast disc X with CCD, unbounded world, 300 units outside GridInfo: " << run_fast_disc(true, 300.0f, false)
+              << " (Should be < 0, it bounces back)\n";
+    std::cout << "Diagonal fast disc X with CCD, unbounded world with a body at 1e30: " << run_diagonal_fast_disc()
+              << " (Should be < 0, it bounces back)\n";
+}
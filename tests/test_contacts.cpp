@@ -0,0 +1,332 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include "physics/contactCache.hpp"
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+
+// tests/test_contacts.cpp
+
+// Column of equal discs resting on the world floor.
+static world create_stack_world(int height)
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 1.0f / 60.0f;
+    float floor_y = 0.0f; // solve_boundary_contacts keeps bodies above y = 0
+    for (int i = 0; i < height; ++i)
+        w.add_body(create_body(0.0f, floor_y + 1.0f + 2.0f * i, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f));
+    return w;
+}
+
+static float max_overlap(const world &w)
+{
+    float overlap = 0.0f;
+    for (size_t i = 0; i + 1 < w.size(); ++i)
+    {
+        float dy = w.position_y[i + 1] - w.position_y[i];
+        overlap = std::max(overlap, w.radius[i] + w.radius[i + 1] - dy);
+    }
+    return overlap;
+}
+
+static float max_speed(const world &w)
+{
+    float speed = 0.0f;
+    for (size_t i = 0; i < w.size(); ++i)
+        speed = std::max(speed, std::sqrt(w.vel_x[i] * w.vel_x[i] + w.vel_y[i] * w.vel_y[i]));
+    return speed;
+}
+
+void test_contact_cache_eviction()
+{
+    std::cout << "\n--- TEST: Contact Cache Generations ---\n";
+
+    contactCache cache;
+    cache.begin_frame();
+    contactCache::Contact contact;
+    contact.normal_impulse = 1.5f;
+    cache.store(3, 7, contact);
+    std::cout << "Impulse read back in the same frame (pair reversed): " << cache.find(7, 3)->normal_impulse << " (Should be 1.5)\n";
+
+    cache.begin_frame();
+    float previous = 0.0f;
+    cache.for_each_previous([&](int idxA, int idxB, const contactCache::Contact &cached)
+                            { if (idxA == 3 && idxB == 7) previous = cached.normal_impulse; });
+    std::cout << "Previous-frame entry seen by the warm start: " << previous << " (Should be 1.5)\n";
+    std::cout << "Found before being carried into the new frame: " << (cache.find(3, 7) != nullptr) << " (Should be 0)\n";
+
+    cache.begin_frame();
+    std::cout << "Live entries after an untouched frame: " << cache.live_count() << " (Should be 0)\n";
+}
+
+void test_warm_started_stack()
+{
+    std::cout << "\n--- TEST: Warm-Started Resting Stack ---\n";
+
+    for (int warm = 0; warm < 2; ++warm)
+    {
+        world w = create_stack_world(10);
+        systemManager manager;
+        manager.addSystem(std::make_unique<movementSystem>());
+        auto collision = std::make_unique<collisionSystem>();
+        collision->set_warm_starting(warm == 1);
+        manager.addSystem(std::move(collision));
+        for (int f = 0; f < 240; ++f)
+            manager.update(w, w.delta_time);
+
+        std::cout << (warm ? "warm start" : "cold start") << ": max overlap " << max_overlap(w) << ", max speed " << max_speed(w) << "\n";
+    }
+    std::cout << "(Should be: warm start overlap and speed lower than cold start)\n";
+}
+
+// A ball resting on a static peg is kicked down at 6 units/s: its cached
+// contact is warm-started, but it is hit hard enough to bounce like a new one.
+void test_warm_started_bounce()
+{
+    std::cout << "\n--- TEST: Warm-Started Contact Hit Hard ---\n";
+
+    const ContactSolverType solvers[] = {ContactSolverType::SINGLE_PASS, ContactSolverType::SEQUENTIAL_IMPULSE};
+    const char *names[] = {"single pass", "sequential impulse"};
+    for (int s = 0; s < 2; ++s)
+    {
+        for (int warm = 0; warm < 2; ++warm)
+        {
+            world w = create_test_world();
+            w.add_body(create_body(0.0f, 3.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.5f));
+            w.add_body(create_body(0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.5f));
+            systemManager manager;
+            add_movement_and_collision(manager, [&](collisionSystem &collision)
+                                       {
+                                           collision.set_contact_solver(solvers[s]);
+                                           collision.set_warm_starting(warm == 1); });
+            for (int f = 0; f < 60; ++f)
+                manager.update(w, w.delta_time);
+            float resting_speed = std::fabs(w.vel_y[0]);
+
+            w.vel_y[0] = -6.0f;
+            w.previous_position_y[0] = w.position_y[0] + 6.0f * w.delta_time;
+            manager.update(w, w.delta_time);
+            std::cout << names[s] << (warm ? ", warm start" : ", cold start") << ": resting speed " << resting_speed << ", velocity Y after the kick "
+                      << w.vel_y[0] << "\n";
+        }
+    }
+    std::cout << "(Should be: resting speed near 0, and every kicked ball bounces back up at about 3)\n";
+}
+
+void test_sequential_impulse_stack()
+{
+    std::cout << "\n--- TEST: Sequential Impulse Stack ---\n";
+
+    const ContactSolverType solvers[] = {ContactSolverType::SINGLE_PASS, ContactSolverType::SEQUENTIAL_IMPULSE};
+    for (ContactSolverType solver : solvers)
+    {
+        world w = create_stack_world(10);
+        systemManager manager;
+        manager.addSystem(std::make_unique<movementSystem>());
+        auto collision = std::make_unique<collisionSystem>();
+        collision->set_contact_solver(solver);
+        manager.addSystem(std::move(collision));
+        for (int f = 0; f < 240; ++f)
+            manager.update(w, w.delta_time);
+
+        std::cout << (solver == ContactSolverType::SINGLE_PASS ? "single pass" : "sequential impulse")
+                  << ": max overlap " << max_overlap(w) << ", top body at y = " << w.position_y[w.size() - 1] << "\n";
+    }
+    std::cout << "(Should be: sequential impulse overlap lower and top body higher)\n";
+}
+
+// Runs a parallel solver on a fresh 400-body pile and returns the final world.
+static world run_parallel_pile(ContactSolverType solver, int threads, collisionSystem **out_collision, systemManager &manager)
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 1.0f / 60.0f;
+    int cols = 20;
+    for (int i = 0; i < 400; ++i)
+        w.add_body(create_body((i % cols - cols / 2) * 1.9f, 1.0f + (i / cols) * 1.9f, 0.0f, 0.0f, 1.0f, 1.0f, 0.3f));
+
+    manager.addSystem(std::make_unique<movementSystem>());
+    auto collision = std::make_unique<collisionSystem>();
+    collision->set_contact_solver(solver);
+    collision->set_solver_threads(threads);
+    *out_collision = collision.get();
+    manager.addSystem(std::move(collision));
+    for (int f = 0; f < 120; ++f)
+        manager.update(w, w.delta_time);
+    return w;
+}
+
+void test_graph_colored_solver()
+{
+    std::cout << "\n--- TEST: Graph-Colored Contact Solver ---\n";
+
+    systemManager serial_manager;
+    collisionSystem *serial_collision = nullptr;
+    world serial = run_parallel_pile(ContactSolverType::GRAPH_COLORED, 1, &serial_collision, serial_manager);
+
+    systemManager parallel_manager;
+    collisionSystem *parallel_collision = nullptr;
+    world parallel = run_parallel_pile(ContactSolverType::GRAPH_COLORED, 4, &parallel_collision, parallel_manager);
+
+    bool identical = true;
+    for (size_t i = 0; i < serial.size(); ++i)
+        identical = identical && serial.position_x[i] == parallel.position_x[i] && serial.position_y[i] == parallel.position_y[i];
+    std::cout << "1 thread vs 4 threads bit-identical: " << identical << " (Should be 1)\n";
+
+    // No dynamic body may appear twice inside one color
+    const contactSolver &solver = parallel_collision->get_contact_solver_state();
+    const ContactBuffer &contacts = solver.contacts();
+    const std::vector<int> &offsets = solver.get_color_offsets();
+    int shared = 0;
+    int batches = solver.has_overflow_color() ? solver.color_count() - 1 : solver.color_count();
+    std::vector<int> last_color(parallel.size(), -1);
+    for (int c = 0; c < batches; ++c)
+    {
+        for (int k = offsets[c]; k < offsets[c + 1]; ++k)
+        {
+            for (int idx : {contacts.body_a[k], contacts.body_b[k]})
+            {
+                if (last_color[idx] == c)
+                    ++shared;
+                last_color[idx] = c;
+            }
+        }
+    }
+    std::cout << "Contacts: " << contacts.size() << ", colors: " << solver.color_count() << ", largest batch: " << (solver.color_count() ? solver.color_batch_size(0) : 0) << "\n";
+    std::cout << "Bodies shared inside a color: " << shared << " (Should be 0)\n";
+    std::cout << "Colors within the per-body limit: " << (solver.color_count() <= contactSolver::MAX_COLORS) << " (Should be 1)\n";
+}
+
+static world run_jacobi_stack()
+{
+    world w = create_stack_world(10);
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    auto collision = std::make_unique<collisionSystem>();
+    collision->set_contact_solver(ContactSolverType::JACOBI);
+    collision->set_solver_threads(1);
+    manager.addSystem(std::move(collision));
+    for (int f = 0; f < 240; ++f)
+        manager.update(w, w.delta_time);
+    return w;
+}
+
+void test_jacobi_solver()
+{
+    std::cout << "\n--- TEST: Jacobi Contact Solver ---\n";
+
+    systemManager serial_manager;
+    collisionSystem *serial_collision = nullptr;
+    world serial = run_parallel_pile(ContactSolverType::JACOBI, 1, &serial_collision, serial_manager);
+
+    systemManager parallel_manager;
+    collisionSystem *parallel_collision = nullptr;
+    world parallel = run_parallel_pile(ContactSolverType::JACOBI, 4, &parallel_collision, parallel_manager);
+
+    bool identical = true;
+    for (size_t i = 0; i < serial.size(); ++i)
+        identical = identical && serial.position_x[i] == parallel.position_x[i] && serial.position_y[i] == parallel.position_y[i];
+    std::cout << "1 thread vs 4 threads bit-identical: " << identical << " (Should be 1)\n";
+
+    world stack = run_jacobi_stack();
+    std::cout << "Stack max overlap " << max_overlap(stack) << ", max speed " << max_speed(stack) << " (Should be: overlap below one radius, stack not exploding)\n";
+}
+
+void test_island_solver()
+{
+    std::cout << "\n--- TEST: Contact Islands ---\n";
+
+    // Three separate columns of 5 on the floor: the floor is a boundary,
+    // not a body, so each column is its own island
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 1.0f / 60.0f;
+    for (int column = 0; column < 3; ++column)
+    {
+        for (int i = 0; i < 5; ++i)
+            w.add_body(create_body(-20.0f + 20.0f * column, 1.0f + 2.0f * i, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f));
+    }
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    auto collision = std::make_unique<collisionSystem>();
+    collision->set_contact_solver(ContactSolverType::ISLANDS);
+    collision->set_solver_threads(2);
+    collisionSystem *columns_collision = collision.get();
+    manager.addSystem(std::move(collision));
+    for (int f = 0; f < 60; ++f)
+        manager.update(w, w.delta_time);
+
+    const contactSolver &solver = columns_collision->get_contact_solver_state();
+    const std::vector<int> &body_counts = solver.get_island_body_counts();
+    std::cout << "Islands: " << solver.island_count() << " (Should be 3)\n";
+    std::cout << "Bodies per island: ";
+    for (int bodies : body_counts)
+        std::cout << bodies << " ";
+    std::cout << "(Should be 5 5 5)\n";
+
+    unsigned long long histogram_total = 0;
+    for (unsigned long long islands : w.island_size_histogram)
+        histogram_total += islands;
+    std::cout << "Histogram total " << histogram_total << " == accumulated islands " << w.island_count
+              << ", 4..7 bucket: " << (w.island_size_histogram.size() > 2 ? w.island_size_histogram[2] : 0) << " (Should be equal, bucket 180)\n";
+
+    systemManager serial_manager;
+    collisionSystem *serial_collision = nullptr;
+    world serial = run_parallel_pile(ContactSolverType::ISLANDS, 1, &serial_collision, serial_manager);
+
+    systemManager parallel_manager;
+    collisionSystem *parallel_collision = nullptr;
+    world parallel = run_parallel_pile(ContactSolverType::ISLANDS, 4, &parallel_collision, parallel_manager);
+
+    bool identical = true;
+    for (size_t i = 0; i < serial.size(); ++i)
+        identical = identical && serial.position_x[i] == parallel.position_x[i] && serial.position_y[i] == parallel.position_y[i];
+    std::cout << "1 thread vs 4 threads bit-identical: " << identical << " (Should be 1)\n";
+}
+
+// Stack stepped with the given solver and time step; returns the final world.
+static world run_stack(ContactSolverType solver, float delta_time, int frames)
+{
+    world w = create_stack_world(10);
+    w.delta_time = delta_time;
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    auto collision = std::make_unique<collisionSystem>();
+    collision->set_contact_solver(solver);
+    manager.addSystem(std::move(collision));
+    for (int f = 0; f < frames; ++f)
+        manager.update(w, w.delta_time);
+    return w;
+}
+
+void test_xpbd_stack()
+{
+    std::cout << "\n--- TEST: XPBD Stack ---\n";
+
+    world xpbd = run_stack(ContactSolverType::XPBD, 1.0f / 60.0f, 240);
+    std::cout << "XPBD at 60 Hz: max overlap " << max_overlap(xpbd) << ", top body at y = " << xpbd.position_y[xpbd.size() - 1]
+              << ", max speed " << max_speed(xpbd) << " (Should be: overlap near 0, top near 19, speed near 0)\n";
+
+    world large_step = run_stack(ContactSolverType::XPBD, 1.0f / 15.0f, 60);
+    std::cout << "XPBD at 15 Hz: max overlap " << max_overlap(large_step) << ", max speed " << max_speed(large_step)
+              << " (Should be: still standing, overlap below 0.2, speed below 1)\n";
+}
+
+void test_contacts()
+{
+    test_contact_cache_eviction();
+    test_warm_started_stack();
+    test_warm_started_bounce();
+    test_sequential_impulse_stack();
+    test_graph_colored_solver();
+    test_jacobi_solver();
+    test_island_solver();
+    test_xpbd_stack();
+}
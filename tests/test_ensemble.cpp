@@ -0,0 +1,68 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include "sim/worldEnsemble.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+// tests/test_ensemble.cpp
+
+// Member k: a small pile whose restitution and size depend on k, so
+// members finish their frames at different times
+static world create_member_world(int k)
+{
+    world w = create_test_world();
+    w.global_damping = 0.002f * (k % 3);
+    add_body_lattice(w, 20 + 40 * k, 20, -20.0f, 2.0f, 2.1f, 2.1f, 1.0f, 1.0f, 0.1f + 0.15f * (k % 6));
+    return w;
+}
+
+static void add_member_systems(systemManager &manager)
+{
+    add_movement_and_collision(manager, [](collisionSystem &collision)
+                               { collision.set_contact_solver(ContactSolverType::ISLANDS); });
+}
+
+void test_world_ensemble()
+{
+    std::cout << "\n--- TEST: Ensemble Of Independent Worlds ---\n";
+
+    const int member_count = 12;
+    const int frames = 40;
+    worldEnsemble ensemble(4);
+    for (int k = 0; k < member_count; ++k)
+        ensemble.add_world(create_member_world(k), add_member_systems);
+    ensemble.step(frames);
+
+    // Each member must match the same world stepped alone
+    float max_difference = 0.0f;
+    bool every_member_stepped = true;
+    bool energy_reported = true;
+    for (int k = 0; k < member_count; ++k)
+    {
+        world alone = create_member_world(k);
+        systemManager manager(1);
+        add_member_systems(manager);
+        for (int f = 0; f < frames; ++f)
+            manager.update(alone, alone.delta_time);
+
+        const world &member = ensemble.get_world(k);
+        for (size_t i = 0; i < alone.size(); ++i)
+        {
+            max_difference = std::max(max_difference, std::fabs(member.position_x[i] - alone.position_x[i]));
+            max_difference = std::max(max_difference, std::fabs(member.position_y[i] - alone.position_y[i]));
+        }
+        const EnsembleMetrics &metrics = ensemble.get_metrics(k);
+        every_member_stepped = every_member_stepped && metrics.frames == frames && metrics.substeps == (unsigned long long)frames;
+        energy_reported = energy_reported && metrics.kinetic_energy > 0.0 && metrics.step_us > 0.0;
+    }
+    std::cout << "Members: " << ensemble.size() << ", threads: " << ensemble.thread_count() << " (Should be 12, 4)\n";
+    std::cout << "Max position difference against stepping each world alone: " << max_difference << " (Should be 0)\n";
+    std::cout << "Every member ran " << frames << " frames with metrics: " << (every_member_stepped && energy_reported) << " (Should be 1)\n";
+
+    ensemble.reset_metrics();
+    std::cout << "Frames after reset_metrics: " << ensemble.get_metrics(0).frames << " (Should be 0)\n";
+}
@@ -0,0 +1,149 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/laneEnsemble.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+// tests/test_lane_ensemble.cpp
+
+// Two bodies thrown at each other inside small walls
+static world create_pair_world()
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 1.0f / 60.0f;
+    w.grid_info.min_x = -10.0f;
+    w.grid_info.max_x = 10.0f;
+    w.grid_info.max_y = 20.0f;
+    w.update_grid_dimensions();
+    body left = create_body(-4.0f, 5.0f, 6.0f, 2.0f, 1.0f, 1.0f, 0.8f);
+    body right = create_body(4.0f, 5.5f, -5.0f, 1.0f, 2.0f, 1.2f, 0.6f);
+    left.previous_position = left.position - left.velocity * w.delta_time;
+    right.previous_position = right.position - right.velocity * w.delta_time;
+    w.add_body(left);
+    w.add_body(right);
+    return w;
+}
+
+// Lane k: 3 + 4k bodies in a row with lane-dependent gravity, damping and bounds
+static world create_lane_world(int k)
+{
+    world w;
+    w.gravity_x = 0.5f * (k % 3) - 0.5f;
+    w.gravity_y = -9.8f + k;
+    w.delta_time = 1.0f / 60.0f;
+    w.global_damping = 0.01f * (k % 2);
+    w.grid_info.min_x = -12.0f - k;
+    w.grid_info.max_x = 12.0f + k;
+    w.grid_info.max_y = 30.0f;
+    w.update_grid_dimensions();
+    int bodies = 3 + 4 * k;
+    for (int i = 0; i < bodies; ++i)
+    {
+        float px = -10.0f + (i % 8) * 2.6f;
+        float py = 2.0f + (i / 8) * 2.6f;
+        body b = create_body(px, py, 3.0f - (i % 5), 0.5f * (i % 3), 1.0f + 0.25f * (i % 4), 1.0f, 0.2f + 0.1f * (k % 7));
+        b.previous_position = b.position - b.velocity * w.delta_time;
+        w.add_body(b);
+    }
+    return w;
+}
+
+static float max_state_difference(const world &a, const world &b)
+{
+    float difference = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        difference = std::max(difference, std::fabs(a.position_x[i] - b.position_x[i]));
+        difference = std::max(difference, std::fabs(a.position_y[i] - b.position_y[i]));
+        difference = std::max(difference, std::fabs(a.vel_x[i] - b.vel_x[i]));
+        difference = std::max(difference, std::fabs(a.vel_y[i] - b.vel_y[i]));
+    }
+    return difference;
+}
+
+void test_lane_matches_world()
+{
+    std::cout << "\n--- TEST: Lane Kernel Matches The World Systems ---\n";
+
+    const int frames = 120;
+    world reference = create_pair_world();
+    systemManager manager(1);
+    manager.addSystem(std::make_unique<movementSystem>());
+    auto collision = std::make_unique<collisionSystem>();
+    collision->set_contact_solver(ContactSolverType::SINGLE_PASS);
+    collision->set_warm_starting(false);
+    manager.addSystem(std::move(collision));
+    for (int f = 0; f < frames; ++f)
+        manager.update(reference, reference.delta_time);
+
+    const SimdLevel levels[] = {SimdLevel::SCALAR, detect_simd_level()};
+    for (SimdLevel level : levels)
+    {
+        laneEnsemble lanes(level);
+        world lane_world = create_pair_world();
+        int lane = lanes.add_world(lane_world);
+        lanes.step(frames);
+        lanes.store_world(lane, lane_world);
+        std::cout << simd_level_name(lanes.get_simd_level()) << ": lane " << lane << ", max difference from the world after " << frames
+                  << " frames: " << max_state_difference(reference, lane_world) << " (Should be 0)\n";
+    }
+}
+
+void test_lane_independence()
+{
+    std::cout << "\n--- TEST: Lanes Step Independently ---\n";
+
+    const int frames = 90;
+    laneEnsemble scalar(SimdLevel::SCALAR);
+    laneEnsemble vector;
+    for (int k = 0; k < WORLD_LANES; ++k)
+    {
+        scalar.add_world(create_lane_world(k));
+        vector.add_world(create_lane_world(k));
+    }
+    world odd_step = create_lane_world(0);
+    odd_step.delta_time = 1.0f / 30.0f;
+    std::cout << "Lanes: " << vector.lane_count() << ", rows: " << vector.body_rows() << ", ninth world accepted: " << (vector.add_world(create_lane_world(0)) >= 0)
+              << " (Should be 8, 31, 0)\n";
+    laneEnsemble mixed;
+    mixed.add_world(create_lane_world(0));
+    std::cout << "World with another time step accepted: " << (mixed.add_world(odd_step) >= 0) << " (Should be 0)\n";
+
+    scalar.step(frames);
+    vector.step(frames);
+
+    // Each lane must match its world stepped alone in lane 0, and the
+    // vector kernel the scalar one
+    float alone_difference = 0.0f;
+    float kernel_difference = 0.0f;
+    bool energy_matches = true;
+    for (int k = 0; k < WORLD_LANES; ++k)
+    {
+        laneEnsemble alone(SimdLevel::SCALAR);
+        alone.add_world(create_lane_world(k));
+        alone.step(frames);
+        world expected = create_lane_world(k);
+        world from_scalar = create_lane_world(k);
+        world from_vector = create_lane_world(k);
+        alone.store_world(0, expected);
+        scalar.store_world(k, from_scalar);
+        vector.store_world(k, from_vector);
+        alone_difference = std::max(alone_difference, max_state_difference(expected, from_scalar));
+        kernel_difference = std::max(kernel_difference, max_state_difference(from_scalar, from_vector));
+        energy_matches = energy_matches && alone.total_energy(0) == scalar.total_energy(k);
+    }
+    std::cout << "Max difference from the world stepped alone: " << alone_difference << ", same energy: " << energy_matches << " (Should be 0, 1)\n";
+    std::cout << simd_level_name(vector.get_simd_level()) << " vs scalar lanes, max difference: " << kernel_difference << " (Should be 0)\n";
+}
+
+void test_lane_ensemble()
+{
+    test_lane_matches_world();
+    test_lane_independence();
+}
@@ -0,0 +1,91 @@
+#include "utils/spscQueue.hpp"
+#include "utils/tripleBuffer.hpp"
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// tests/test_pipelining.cpp
+
+void test_triple_buffer()
+{
+    std::cout << "\n--- TEST: Triple-Buffered Frames ---\n";
+
+    // The writer fills every frame with its own number; a torn or reused
+    // buffer would show mixed values on the reader side
+    tripleBuffer<std::vector<int>> frames;
+    const int frame_count = 20000;
+    std::thread writer([&]
+                       {
+        for (int f = 1; f <= frame_count; ++f)
+        {
+            std::vector<int> &out = frames.write_buffer();
+            out.assign(1000, f);
+            frames.publish();
+        } });
+
+    bool consistent = true;
+    bool in_order = true;
+    int last_seen = 0;
+    int frames_read = 0;
+    while (last_seen < frame_count)
+    {
+        if (!frames.acquire())
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        const std::vector<int> &in = frames.read_buffer();
+        for (int v : in)
+            consistent = consistent && v == in.front();
+        in_order = in_order && in.front() > last_seen;
+        last_seen = in.front();
+        ++frames_read;
+    }
+    writer.join();
+    std::cout << "Frames read: " << frames_read << " of " << frame_count << ", every frame complete: " << consistent
+              << ", newer each time: " << in_order << ", last frame: " << last_seen << " (Should be at most " << frame_count << ", 1, 1, " << frame_count << ")\n";
+    std::cout << "Acquire with nothing new: " << frames.acquire() << " (Should be 0)\n";
+}
+
+void test_spsc_queue()
+{
+    std::cout << "\n--- TEST: Lock-Free Command Queue ---\n";
+
+    spscQueue<int> queue(100);
+    int filled = 0;
+    while (queue.push(filled))
+        ++filled;
+    int drained = 0;
+    int value = 0;
+    while (queue.pop(value))
+        ++drained;
+    std::cout << "Capacity: " << queue.capacity() << ", pushed until full: " << filled << ", popped: " << drained << " (Should be 128, 128, 128)\n";
+
+    const int count = 200000;
+    std::thread producer([&]
+                         {
+        for (int i = 0; i < count; ++i)
+            while (!queue.push(i))
+                std::this_thread::yield(); });
+    bool in_order = true;
+    int expected = 0;
+    while (expected < count)
+    {
+        if (!queue.pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        in_order = in_order && value == expected;
+        ++expected;
+    }
+    producer.join();
+    std::cout << "Items across threads: " << expected << ", FIFO order kept: " << in_order << " (Should be " << count << ", 1)\n";
+}
+
+void test_pipelining()
+{
+    test_triple_buffer();
+    test_spsc_queue();
+}
@@ -0,0 +1,114 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/energySystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/reorderSystem.hpp"
+#include "sim/systemManager.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+// tests/test_scheduling.cpp
+
+// Read-only system that waits (up to a second) for `partners` other probes to
+// start, which only happens when the manager runs them concurrently.
+class probeSystem : public ISystem
+{
+private:
+    std::atomic<int> &started;
+    int partners;
+
+public:
+    bool met_partners = false;
+
+    probeSystem(std::atomic<int> &started_in, int partners_in) : started(started_in), partners(partners_in) {}
+    void update(world &, float) override
+    {
+        ++started;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (started.load() <= partners && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+        met_partners = started.load() > partners;
+    }
+    ColumnSet reads() const override { return COLUMN_POSITION | COLUMN_VELOCITY; }
+    ColumnSet writes() const override { return COLUMNS_NONE; }
+};
+
+void test_schedule_levels()
+{
+    std::cout << "\n--- TEST: System Dependency Levels ---\n";
+
+    world w = create_random_world(1, vec2(0.0f, -9.8f), 1.0f / 60.0f);
+    std::atomic<int> started{0};
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+    manager.addSystem(std::make_unique<energySystem>());
+    manager.addSystem(std::make_unique<probeSystem>(started, 0));
+    manager.update(w, w.delta_time);
+    // movement -> collision -> {energy, probe}
+    std::cout << "movement, collision, energy, probe: " << manager.get_last_schedule_levels() << " levels (Should be 3)\n";
+
+    manager.addSystem(std::make_unique<reorderSystem>());
+    manager.addSystem(std::make_unique<energySystem>());
+    manager.update(w, w.delta_time);
+    // ... -> reorder (writes the layout) -> energy
+    std::cout << "with reorder and a second energy pass: " << manager.get_last_schedule_levels() << " levels (Should be 5)\n";
+}
+
+void test_concurrent_systems()
+{
+    std::cout << "\n--- TEST: Non-Conflicting Systems Run Concurrently ---\n";
+
+    world w = create_random_world(1, vec2(0.0f, -9.8f), 1.0f / 60.0f);
+    std::atomic<int> started{0};
+    auto first = std::make_unique<probeSystem>(started, 1);
+    auto second = std::make_unique<probeSystem>(started, 1);
+    probeSystem *first_probe = first.get();
+    probeSystem *second_probe = second.get();
+
+    systemManager manager;
+    manager.set_worker_threads(2);
+    manager.addSystem(std::move(first));
+    manager.addSystem(std::move(second));
+    manager.update(w, w.delta_time);
+    std::cout << "Both probes saw each other running: " << (first_probe->met_partners && second_probe->met_partners) << " (Should be 1)\n";
+}
+
+void test_energy_system()
+{
+    std::cout << "\n--- TEST: Energy Analytics ---\n";
+
+    // One body in free fall, no damping: kinetic + potential stays put
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 1.0f / 60.0f;
+    w.global_damping = 0.0f;
+    body b = create_body(0.0f, 50.0f, 3.0f, 0.0f, 2.0f, 0.5f);
+    b.previous_position = b.position - b.velocity * w.delta_time;
+    w.add_body(b);
+
+    auto energy = std::make_unique<energySystem>();
+    energySystem *analytics = energy.get();
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::move(energy));
+    manager.update(w, w.delta_time);
+    double initial = analytics->get_total_energy();
+    for (int f = 0; f < 60; ++f)
+        manager.update(w, w.delta_time);
+    double drift = std::fabs(analytics->get_total_energy() - initial) / initial;
+    std::cout << "Relative energy drift over 1 s: " << drift << ", momentum x: " << analytics->get_momentum_x() << " (Should be below 0.01, 6)\n";
+}
+
+void test_scheduling()
+{
+    test_schedule_levels();
+    test_concurrent_systems();
+    test_energy_system();
+}
@@ -0,0 +1,98 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include <iostream>
+#include <memory>
+
+// tests/test_sleeping.cpp
+
+// Three columns of 5 resting discs (no bounce), far enough apart to be
+// separate islands, with sleeping enabled.
+static world create_columns_world()
+{
+    world w = create_test_world();
+    w.sleep_settings.enabled = true;
+    for (int column = 0; column < 3; ++column)
+        add_body_lattice(w, 5, 1, -20.0f + 20.0f * column, 1.0f, 0.0f, 2.0f, 1.0f, 1.0f, 0.0f);
+    return w;
+}
+
+static void add_sleep_systems(systemManager &manager, ContactSolverType solver)
+{
+    add_movement_and_collision(manager, [&](collisionSystem &collision)
+                               { collision.set_contact_solver(solver); });
+}
+
+static int count_sleeping(const world &w, size_t begin, size_t end)
+{
+    int asleep = 0;
+    for (size_t i = begin; i < end; ++i)
+        asleep += w.is_sleeping(i) ? 1 : 0;
+    return asleep;
+}
+
+void test_columns_fall_asleep()
+{
+    std::cout << "\n--- TEST: Resting Islands Fall Asleep ---\n";
+
+    const ContactSolverType solvers[] = {ContactSolverType::SINGLE_PASS, ContactSolverType::SEQUENTIAL_IMPULSE, ContactSolverType::XPBD};
+    const char *names[] = {"single pass", "sequential impulse", "xpbd"};
+    for (int s = 0; s < 3; ++s)
+    {
+        world w = create_columns_world();
+        systemManager manager;
+        add_sleep_systems(manager, solvers[s]);
+        // Single-pass stacks keep sinking slowly for about 2.5 s
+        for (int f = 0; f < 300; ++f)
+            manager.update(w, w.delta_time);
+        unsigned long long asleep_after_5s = w.sleeping_bodies;
+
+        // Nothing may move while asleep
+        std::vector<float> rest_y = w.position_y;
+        for (int f = 0; f < 60; ++f)
+            manager.update(w, w.delta_time);
+        bool frozen = w.position_y == rest_y;
+        std::cout << names[s] << ": " << asleep_after_5s << " bodies asleep after 5 s, frozen afterwards: " << frozen << "\n";
+    }
+    std::cout << "(Should be: 15 asleep and frozen 1 for every solver)\n";
+
+    world awake = create_columns_world();
+    awake.sleep_settings.enabled = false;
+    systemManager manager;
+    add_sleep_systems(manager, ContactSolverType::SINGLE_PASS);
+    for (int f = 0; f < 180; ++f)
+        manager.update(awake, awake.delta_time);
+    std::cout << "Sleeping disabled: " << awake.sleeping_bodies << " bodies asleep (Should be 0)\n";
+}
+
+void test_wake_on_contact()
+{
+    std::cout << "\n--- TEST: Wake on Contact ---\n";
+
+    world w = create_columns_world();
+    systemManager manager;
+    add_sleep_systems(manager, ContactSolverType::SEQUENTIAL_IMPULSE);
+    for (int f = 0; f < 180; ++f)
+        manager.update(w, w.delta_time);
+
+    // Drop a disc on the middle column (bodies 5..9); it lands after ~30 frames
+    w.add_body(create_body(0.0f, 12.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f));
+    for (int f = 0; f < 45; ++f)
+        manager.update(w, w.delta_time);
+    std::cout << "Asleep per column after the hit: " << count_sleeping(w, 0, 5) << " " << count_sleeping(w, 5, 10) << " "
+              << count_sleeping(w, 10, 15) << " (Should be 5 0 5)\n";
+
+    for (int f = 0; f < 180; ++f)
+        manager.update(w, w.delta_time);
+    std::cout << "Middle column after settling again: " << count_sleeping(w, 5, 11) << " of 6 asleep (Should be 6)\n";
+
+    w.set_position(0, vec2(-20.0f, 1.5f));
+    std::cout << "Moved through the API: asleep bodies left in its column " << count_sleeping(w, 0, 5) << " (Should be 0)\n";
+}
+
+void test_sleeping()
+{
+    test_columns_fall_asleep();
+    test_wake_on_contact();
+}
@@ -0,0 +1,143 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/reorderSystem.hpp"
+#include "sim/systemManager.hpp"
+#include <iostream>
+#include <memory>
+#include <numeric>
+
+// tests/test_static_bodies.cpp
+
+// Dynamic bodies in [0, dynamic_count), static ones after it
+static bool is_partitioned(const world &w)
+{
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        if ((w.inv_mass[i] > 0.0f) != (i < w.dynamic_count))
+            return false;
+    }
+    return true;
+}
+
+void test_static_partition()
+{
+    std::cout << "\n--- TEST: Dynamic / Static Body Ranges ---\n";
+
+    // Static and dynamic bodies added interleaved; radius tags each body
+    world w;
+    for (int i = 0; i < 20; ++i)
+        w.add_body(create_body((float)i, 5.0f, 0.0f, 0.0f, (i % 3 == 0) ? 0.0f : 1.0f, 0.1f + 0.01f * i));
+    bool partitioned = is_partitioned(w);
+    std::cout << "After add_body: dynamic " << w.dynamic_count << " / " << w.size() << ", partitioned: " << partitioned << " (Should be 13 / 20, 1)\n";
+
+    w.remove_body(0);              // dynamic
+    w.remove_body(w.size() - 1);   // static
+    size_t moved = w.set_mass(2, 0.0f);
+    partitioned = is_partitioned(w);
+    std::cout << "After remove_body and set_mass: dynamic " << w.dynamic_count << " / " << w.size() << ", partitioned: " << partitioned
+              << ", made-static body now static: " << w.is_static(moved) << " (Should be 11 / 18, 1, 1)\n";
+
+    // A reversed order interleaves both kinds; the permutation keeps the ranges
+    std::vector<int> order(w.size());
+    std::iota(order.rbegin(), order.rend(), 0);
+    float last_radius = w.radius[w.size() - 1];
+    std::vector<int> remap = w.permute_bodies(order);
+    partitioned = is_partitioned(w);
+    bool remap_consistent = w.radius[remap[order[0]]] == last_radius;
+    std::cout << "After permute_bodies: partitioned: " << partitioned << ", remap consistent: " << remap_consistent << " (Should be 1, 1)\n";
+
+    // Direct inv_mass writes are repaired by partition_bodies
+    w.inv_mass[0] = 0.0f;
+    w.inv_mass[w.size() - 1] = 1.0f;
+    w.partition_bodies();
+    partitioned = is_partitioned(w);
+    std::cout << "After partition_bodies: dynamic " << w.dynamic_count << ", partitioned: " << partitioned << " (Should be 11, 1)\n";
+}
+
+// A floor of static pegs (level geometry) under a pile of dynamic discs
+static world create_peg_floor_world()
+{
+    world w = create_test_world(vec2(0.0f, -9.8f), 0.016f);
+    add_body_lattice(w, 60, 12, -9.0f, 14.0f, 1.5f, 1.5f, 1.0f, 0.6f, 0.2f);
+    add_body_lattice(w, 400, 400, -40.0f, 10.0f, 0.2f, 0.0f, 0.0f, 0.3f);
+    return w;
+}
+
+static int count_below_floor(const world &w)
+{
+    int below = 0;
+    for (size_t i = 0; i < w.dynamic_count; ++i)
+    {
+        if (w.position_y[i] < 10.0f)
+            ++below;
+    }
+    return below;
+}
+
+void test_static_grid()
+{
+    std::cout << "\n--- TEST: Cached Static Grid ---\n";
+
+    const BroadPhaseType types[] = {BroadPhaseType::UNIFORM_GRID, BroadPhaseType::AABB_TREE};
+    const char *names[] = {"grid", "bvh"};
+    for (int t = 0; t < 2; ++t)
+    {
+        world w = create_peg_floor_world();
+        systemManager manager;
+        collisionSystem *cs = nullptr;
+        add_movement_and_collision(manager, [&](collisionSystem &collision)
+                                   {
+                                       collision.set_broad_phase(types[t]);
+                                       cs = &collision; });
+        for (int f = 0; f < 120; ++f)
+            manager.update(w, w.delta_time);
+        std::cout << names[t] << ": dynamic bodies below the peg floor: " << count_below_floor(w) << " (Should be 0)\n";
+
+        if (types[t] != BroadPhaseType::UNIFORM_GRID)
+            continue;
+        std::cout << "Static grid builds over 120 frames: " << cs->get_static_grid_builds() << " (Should be 1)\n";
+        w.set_position(w.dynamic_count, vec2(-39.0f, 10.0f));
+        manager.update(w, w.delta_time);
+        std::cout << "Static grid builds after moving a peg: " << cs->get_static_grid_builds() << " (Should be 2)\n";
+    }
+}
+
+// Both ranges already in Z-order, static codes below the dynamic ones: the
+// drop between the ranges must not count as disorder or trigger a permutation.
+void test_static_reorder()
+{
+    std::cout << "\n--- TEST: Reordering A World With Static Bodies ---\n";
+
+    world w = create_test_world(vec2(0.0f, 0.0f), 0.016f);
+    add_body_lattice(w, 50, 50, -90.0f, 5.0f, 3.0f, 0.0f, 1.0f, 0.5f);
+    add_body_lattice(w, 50, 50, -90.0f, -50.0f, 3.0f, 0.0f, 0.0f, 0.5f);
+    unsigned int layout_before = w.body_layout_version;
+
+    systemManager manager;
+    auto reorder = std::make_unique<reorderSystem>(10);
+    reorderSystem *reorder_system = reorder.get();
+    manager.addSystem(std::move(reorder));
+    int reorders = 0;
+    for (int f = 0; f < 40; ++f)
+    {
+        manager.update(w, w.delta_time);
+        reorders += reorder_system->reordered_last_update() ? 1 : 0;
+    }
+    std::cout << "Disorder: " << reorder_system->last_disorder() << ", reorders in 40 frames: " << reorders
+              << ", layout version change: " << (w.body_layout_version - layout_before) << " (Should be 0, 0, 0)\n";
+
+    // A shuffled dynamic range is still sorted, and the statics stay last
+    w.set_position(0, vec2(80.0f, 5.0f));
+    for (int f = 0; f < 10; ++f)
+        manager.update(w, w.delta_time);
+    std::cout << "After moving one body: partitioned " << is_partitioned(w) << ", layout version change: " << (w.body_layout_version - layout_before)
+              << " (Should be 1, 1)\n";
+}
+
+void test_static_bodies()
+{
+    test_static_partition();
+    test_static_grid();
+    test_static_reorder();
+}
@@ -0,0 +1,104 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include <iostream>
+#include <memory>
+#include <cmath>
+
+// tests/test_substepping.cpp
+
+// Counts its calls; schedule chosen at construction.
+class countingSystem : public ISystem
+{
+public:
+    SystemSchedule when;
+    int *calls;
+    countingSystem(SystemSchedule when_in, int *calls_in) : when(when_in), calls(calls_in) {}
+    void update(world &, float) override { ++*calls; }
+    SystemSchedule schedule() const override { return when; }
+};
+
+// One body of radius 0.5 moving at the given speed, Verlet history included.
+static world create_moving_body_world(float speed)
+{
+    world w = create_test_world(vec2(0.0f, 0.0f));
+    w.global_damping = 0.0f;
+    w.add_body(create_moving_body(w, 0.0f, 50.0f, speed, 0.0f, 1.0f, 0.5f));
+    return w;
+}
+
+void test_adaptive_substep_count()
+{
+    std::cout << "\n--- TEST: Adaptive Substep Count ---\n";
+
+    SubstepSettings settings;
+    settings.enabled = true;
+    settings.max_substeps = 8;
+
+    const float speeds[] = {1.0f, 40.0f, 1000.0f};
+    bool restored = true;
+    for (float speed : speeds)
+    {
+        world w = create_moving_body_world(speed);
+        systemManager manager;
+        manager.set_substepping(settings);
+        manager.addSystem(std::make_unique<movementSystem>());
+        manager.update(w, w.delta_time);
+        restored = restored && w.delta_time == 1.0f / 60.0f;
+        std::cout << "speed " << speed << ": " << manager.get_last_substeps() << " substeps";
+        std::cout << ", travelled " << w.position_x[0] << " (expected " << speed / 60.0f << ")\n";
+    }
+    std::cout << "(Should be: 1, 3 and 8 substeps (clamped); each body travels speed * dt)\n";
+    std::cout << "Frame time step restored after each update: " << restored << " (Should be 1)\n";
+}
+
+void test_substep_schedules()
+{
+    std::cout << "\n--- TEST: Per-System Substep Schedules ---\n";
+
+    SubstepSettings settings;
+    settings.enabled = true;
+    settings.min_substeps = 4;
+    settings.max_substeps = 4;
+
+    world w = create_moving_body_world(1.0f);
+    int every_substep = 0;
+    int once_per_frame = 0;
+    systemManager manager;
+    manager.set_substepping(settings);
+    manager.addSystem(std::make_unique<countingSystem>(SystemSchedule::EVERY_SUBSTEP, &every_substep));
+    manager.addSystem(std::make_unique<countingSystem>(SystemSchedule::ONCE_PER_FRAME, &once_per_frame));
+    for (int f = 0; f < 10; ++f)
+        manager.update(w, w.delta_time);
+
+    std::cout << "Every-substep calls: " << every_substep << " (Should be 40)\n";
+    std::cout << "Once-per-frame calls: " << once_per_frame << " (Should be 10)\n";
+    std::cout << "Substeps counted in world: " << w.substeps << " (Should be 40)\n";
+}
+
+void test_substep_budget()
+{
+    std::cout << "\n--- TEST: Substep Time Budget ---\n";
+
+    SubstepSettings settings;
+    settings.enabled = true;
+    settings.max_substeps = 8;
+    settings.frame_budget_us = 1e-3f; // far below the cost of one substep
+
+    world w = create_moving_body_world(1000.0f);
+    systemManager manager;
+    manager.set_substepping(settings);
+    add_movement_and_collision(manager);
+    manager.update(w, w.delta_time); // first frame measures the cost
+    int first = manager.get_last_substeps();
+    manager.update(w, w.delta_time);
+    std::cout << "Substeps before / after the cost is known: " << first << " / " << manager.get_last_substeps() << " (Should be 8 / 1)\n";
+}
+
+void test_substepping()
+{
+    test_adaptive_substep_count();
+    test_substep_schedules();
+    test_substep_budget();
+}
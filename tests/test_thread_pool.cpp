@@ -0,0 +1,104 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include "utils/threadPool.hpp"
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+
+// tests/test_thread_pool.cpp
+
+void test_parallel_for_coverage()
+{
+    std::cout << "\n--- TEST: Work-Stealing parallel_for ---\n";
+
+    threadPool pool(4);
+    const int count = 100000;
+    std::vector<int> visits(count, 0);
+    std::atomic<int> largest_range{0};
+    pool.parallel_for(count, [&](int begin, int end)
+                      {
+        for (int i = begin; i < end; ++i)
+            ++visits[i];
+        int size = end - begin;
+        int seen = largest_range.load();
+        while (size > seen && !largest_range.compare_exchange_weak(seen, size))
+        {
+        } }, 1000);
+    bool exactly_once = std::all_of(visits.begin(), visits.end(), [](int v)
+                                    { return v == 1; });
+    std::cout << "Threads: " << pool.thread_count() << ", every index visited once: " << exactly_once
+              << ", largest range: " << largest_range.load() << " (Should be 4, 1, at most 1000)\n";
+
+    // Uneven nested loops: each outer item runs an inner loop of its own size
+    std::atomic<long long> nested_sum{0};
+    pool.parallel_for(64, [&](int begin, int end)
+                      {
+        for (int outer = begin; outer < end; ++outer)
+        {
+            int inner_count = (outer % 8) * 500;
+            pool.parallel_for(inner_count, [&](int inner_begin, int inner_end)
+                              { nested_sum += inner_end - inner_begin; }, 100);
+        } }, 1);
+    long long expected = 0;
+    for (int outer = 0; outer < 64; ++outer)
+        expected += (outer % 8) * 500;
+    std::cout << "Nested parallel_for items: " << nested_sum.load() << " (Should be " << expected << ")\n";
+}
+
+// Large enough for the grid build to split into several blocks; the small
+// x offsets keep the columns from lining up exactly
+static world create_lattice_world()
+{
+    world w = create_test_world();
+    w.grid_info.max_y = 150.0f;
+    w.update_grid_dimensions();
+    add_body_lattice(w, 20000, 180, -94.5f, 1.0f, 1.05f, 1.05f, 1.0f, 0.5f, 0.3f);
+    for (size_t i = 0; i < w.size(); ++i)
+        w.set_position(i, vec2(w.position_x[i] + 0.01f * (i % 7), w.position_y[i]));
+    return w;
+}
+
+void test_worker_count_determinism()
+{
+    std::cout << "\n--- TEST: Results Do Not Depend On The Worker Count ---\n";
+
+    const ContactSolverType solvers[] = {ContactSolverType::SINGLE_PASS, ContactSolverType::ISLANDS};
+    const char *names[] = {"single", "islands"};
+    for (int s = 0; s < 2; ++s)
+    {
+        world results[2] = {create_lattice_world(), create_lattice_world()};
+        const int workers[2] = {1, 4};
+        for (int run = 0; run < 2; ++run)
+        {
+            systemManager manager;
+            manager.set_worker_threads(workers[run]);
+            add_movement_and_collision(manager, [&](collisionSystem &collision)
+                                       { collision.set_contact_solver(solvers[s]); });
+            for (int f = 0; f < 5; ++f)
+                manager.update(results[run], results[run].delta_time);
+        }
+        float max_difference = 0.0f;
+        for (size_t i = 0; i < results[0].size(); ++i)
+        {
+            max_difference = std::max(max_difference, std::fabs(results[0].position_x[i] - results[1].position_x[i]));
+            max_difference = std::max(max_difference, std::fabs(results[0].position_y[i] - results[1].position_y[i]));
+        }
+        std::cout << names[s] << ": max position difference between 1 and 4 workers: " << max_difference << " (Should be 0)\n";
+    }
+
+    // Outside a systemManager nothing asked for threads: no pool of its own
+    world lattice = create_lattice_world();
+    collisionSystem standalone;
+    standalone.update(lattice, lattice.delta_time);
+    std::cout << "Standalone collisionSystem threads: " << standalone.get_solver_threads() << " (Should be 1)\n";
+}
+
+void test_thread_pool()
+{
+    test_parallel_for_coverage();
+    test_worker_count_determinism();
+}
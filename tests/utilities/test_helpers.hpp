@@ -8,6 +8,9 @@
 #include "math/vec2.hpp"
 #include "physics/body.hpp"
 #include "physics/world.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
 
 // --- Funciones Auxiliares ---
 
@@ -34,4 +37,47 @@ inline world create_random_world(int num_bodies, const vec2 &gravedad, float dt)
     for (auto &b : cuerpos)
         w.add_body(b);
     return w;
-}
\ No newline at end of file
+}
+
+// Empty world with the given gravity and time step; bounds at their defaults
+inline world create_test_world(const vec2 &gravedad = vec2(0.0f, -9.8f), float dt = 1.0f / 60.0f)
+{
+    world w;
+    w.gravity_x = gravedad.x;
+    w.gravity_y = gravedad.y;
+    w.delta_time = dt;
+    return w;
+}
+
+// Body whose previous position matches its velocity, so the Verlet
+// integrator keeps it moving instead of starting from rest
+inline body create_moving_body(const world &w, float pos_x, float pos_y, float vel_x, float vel_y, float masa, float radio, float restitucion = 1.0f)
+{
+    body b = create_body(pos_x, pos_y, vel_x, vel_y, masa, radio, restitucion);
+    b.previous_position = b.position - b.velocity * w.delta_time;
+    return b;
+}
+
+// `count` equal bodies at rest, row by row: body i at
+// (origin_x + (i % columns) * spacing_x, origin_y + (i / columns) * spacing_y)
+inline void add_body_lattice(world &w, int count, int columns, float origin_x, float origin_y, float spacing_x, float spacing_y, float masa, float radio,
+                             float restitucion = 1.0f)
+{
+    for (int i = 0; i < count; ++i)
+        w.add_body(create_body(origin_x + (i % columns) * spacing_x, origin_y + (i / columns) * spacing_y, 0.0f, 0.0f, masa, radio, restitucion));
+}
+
+// movementSystem + collisionSystem; `configure` tunes the collisionSystem before it is added
+template <typename Configure>
+inline void add_movement_and_collision(systemManager &manager, Configure &&configure)
+{
+    manager.addSystem(std::make_unique<movementSystem>());
+    auto collision = std::make_unique<collisionSystem>();
+    configure(*collision);
+    manager.addSystem(std::move(collision));
+}
+
+inline void add_movement_and_collision(systemManager &manager)
+{
+    add_movement_and_collision(manager, [](collisionSystem &) {});
+}
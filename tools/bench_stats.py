@@ -4,12 +4,62 @@ import csv
 import json
 import statistics
 
+def analyze_ensemble(path):
+    # One row per ensemble member (benchmark --ensemble)
+    with open(path, newline='') as csvf:
+        rows = list(csv.DictReader(csvf))
+
+    def column(name):
+        return [float(row.get(name) or 0) for row in rows]
+
+    def stats(a):
+        if not a: return {'mean':0,'std':0,'min':0,'max':0}
+        return {'mean': statistics.mean(a), 'std': statistics.pstdev(a), 'min': min(a), 'max': max(a)}
+
+    total = column('total_us')
+    frames = column('frames')
+    slowest = max(range(len(rows)), key=lambda k: total[k]) if rows else -1
+    out = {
+        'file': path,
+        'members': len(rows),
+        'frames': int(frames[0]) if frames else 0,
+        'member_total_us': stats(total),
+        'frame_us': stats([t / f for t, f in zip(total, frames) if f]),
+        'max_frame_us': stats(column('max_frame_us')),
+        'contacts': stats(column('contacts')),
+        'sleeping': stats(column('sleeping')),
+        'kinetic_energy': stats(column('kinetic_energy')),
+        'total_energy': stats(column('total_energy')),
+        'slowest_member': {
+            'member': int(float(rows[slowest]['member'])),
+            'restitution': float(rows[slowest]['restitution']),
+            'global_damping': float(rows[slowest]['global_damping']),
+            'total_us': total[slowest]
+        } if rows else None
+    }
+    print(json.dumps(out, indent=2))
+
 def analyze(path):
+    with open(path, newline='') as csvf:
+        if 'member' in (csv.DictReader(csvf).fieldnames or []):
+            return analyze_ensemble(path)
     frames = []
     total = []
     broad = []
     narrow = []
     resolve = []
+    rebuilds = []
+    contacts = []
+    colors = []
+    max_batch = []
+    islands = []
+    island_us = []
+    max_island_us = []
+    substeps = []
+    sleeping = []
+    ccd_bodies = []
+    ccd_impacts = []
+    ccd_us = []
     with open(path, newline='') as csvf:
         r = csv.DictReader(csvf)
         for row in r:
@@ -17,6 +67,18 @@ def analyze(path):
             broad.append(float(row.get('broad_us', 0)))
             narrow.append(float(row.get('narrow_us', 0)))
             resolve.append(float(row.get('resolve_us', 0)))
+            rebuilds.append(int(row.get('rebuilds') or 0))
+            contacts.append(int(row.get('contacts') or 0))
+            colors.append(int(row.get('colors') or 0))
+            max_batch.append(int(row.get('max_batch') or 0))
+            islands.append(int(row.get('islands') or 0))
+            island_us.append(int(row.get('island_us') or 0))
+            max_island_us.append(int(row.get('max_island_us') or 0))
+            substeps.append(int(row.get('substeps') or 1))
+            sleeping.append(int(row.get('sleeping') or 0))
+            ccd_bodies.append(int(row.get('ccd_bodies') or 0))
+            ccd_impacts.append(int(row.get('ccd_impacts') or 0))
+            ccd_us.append(int(row.get('ccd_us') or 0))
             frames.append(int(row.get('frame', 0)))
 
     def stats(a):
@@ -29,7 +91,21 @@ def analyze(path):
         'total': stats(total),
         'broad': stats(broad),
         'narrow': stats(narrow),
-        'resolve': stats(resolve)
+        'resolve': stats(resolve),
+        'rebuilds': sum(rebuilds),
+        'rebuild_rate': (sum(rebuilds) / len(frames)) if frames else 0,
+        'contacts': stats(contacts),
+        'colors': stats(colors),
+        'max_batch': stats(max_batch),
+        'mean_batch': (sum(contacts) / sum(colors)) if sum(colors) else 0,
+        'islands': stats(islands),
+        'island_us': stats(island_us),
+        'max_island_us': stats(max_island_us),
+        'substeps': stats(substeps),
+        'sleeping': stats(sleeping),
+        'ccd_bodies': stats(ccd_bodies),
+        'ccd_impacts': stats(ccd_impacts),
+        'ccd_us': stats(ccd_us)
     }
     print(json.dumps(out, indent=2))
 
@@ -1,11 +1,17 @@
 // Headless benchmark runner for the physics simulation.
 // Produces CSV files with per-frame timings: frame,total_us,broad_us,narrow_us,resolve_us
+// With --ensemble, steps many independent worlds at once and writes one row per world instead.
+// With --ensemble and --lanes, packs those worlds WORLD_LANES at a time into SIMD lanes.
 
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <ctime>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <memory>
 #include <sys/stat.h>
 
 #include "physics/world.hpp"
@@ -13,6 +19,10 @@
 #include "sim/systemManager.hpp"
 #include "sim/movementSystem.hpp"
 #include "sim/collisionSystem.hpp"
+#include "sim/reorderSystem.hpp"
+#include "sim/worldEnsemble.hpp"
+#include "sim/laneEnsemble.hpp"
+#include "utils/threadPool.hpp"
 
 // Minimal mkdir -p for portability
 static void ensure_dir(const std::string &path)
@@ -37,6 +47,27 @@ int main(int argc, char **argv)
     int N = 1000;
     int frames = 1000;
     int warmup = 100;
+    std::string pairs = "materialized";
+    std::string broadphase = "grid";
+    int reorder_interval = 0;
+    float neighbour_skin = 0.0f;
+    bool warm_start = true;
+    std::string solver = "single";
+    int velocity_iterations = -1;
+    int position_iterations = -1;
+    int threads = 0;
+    int xpbd_iterations = -1;
+    int max_substeps = 0;
+    float substep_budget_us = 0.0f;
+    float compliance = -1.0f;
+    bool sleep = false;
+    float ccd_fraction = 0.0f;
+    float hz = 60.0f;
+    std::string simd = "auto";
+    std::string integrator = "verlet";
+    int static_bodies = 0;
+    int ensemble = 0;
+    bool lanes = false;
     for (int i = 1; i < argc; ++i)
     {
         std::string a = argv[i];
@@ -46,47 +77,341 @@ int main(int argc, char **argv)
             frames = std::stoi(argv[++i]);
         if (a == "--warmup" && i + 1 < argc)
             warmup = std::stoi(argv[++i]);
+        if (a == "--pairs" && i + 1 < argc)
+            pairs = argv[++i];
+        if (a == "--broadphase" && i + 1 < argc)
+            broadphase = argv[++i];
+        if (a == "--reorder" && i + 1 < argc)
+            reorder_interval = std::stoi(argv[++i]);
+        if (a == "--neighbour-skin" && i + 1 < argc)
+            neighbour_skin = std::stof(argv[++i]);
+        if (a == "--warm-start" && i + 1 < argc)
+            warm_start = std::stoi(argv[++i]) != 0;
+        if (a == "--solver" && i + 1 < argc)
+            solver = argv[++i];
+        if (a == "--velocity-iterations" && i + 1 < argc)
+            velocity_iterations = std::stoi(argv[++i]);
+        if (a == "--position-iterations" && i + 1 < argc)
+            position_iterations = std::stoi(argv[++i]);
+        if (a == "--threads" && i + 1 < argc)
+            threads = std::stoi(argv[++i]);
+        if (a == "--xpbd-iterations" && i + 1 < argc)
+            xpbd_iterations = std::stoi(argv[++i]);
+        if (a == "--compliance" && i + 1 < argc)
+            compliance = std::stof(argv[++i]);
+        if (a == "--max-substeps" && i + 1 < argc)
+            max_substeps = std::stoi(argv[++i]);
+        if (a == "--substep-budget" && i + 1 < argc)
+            substep_budget_us = std::stof(argv[++i]);
+        if (a == "--sleep" && i + 1 < argc)
+            sleep = std::stoi(argv[++i]) != 0;
+        if (a == "--ccd" && i + 1 < argc)
+            ccd_fraction = std::stof(argv[++i]);
+        if (a == "--hz" && i + 1 < argc)
+            hz = std::stof(argv[++i]);
+        if (a == "--simd" && i + 1 < argc)
+            simd = argv[++i];
+        if (a == "--integrator" && i + 1 < argc)
+            integrator = argv[++i];
+        if (a == "--static" && i + 1 < argc)
+            static_bodies = std::stoi(argv[++i]);
+        if (a == "--ensemble" && i + 1 < argc)
+            ensemble = std::stoi(argv[++i]);
+        if (a == "--lanes" && i + 1 < argc)
+            lanes = std::stoi(argv[++i]) != 0;
+    }
+
+    PairGenerationMode pair_mode = PairGenerationMode::MATERIALIZED;
+    if (pairs == "streaming")
+        pair_mode = PairGenerationMode::STREAMING;
+    else if (pairs != "materialized")
+    {
+        std::cerr << "Unknown --pairs mode: " << pairs << " (expected materialized|streaming)\n";
+        return 1;
+    }
+
+    BroadPhaseType broad_phase_type = BroadPhaseType::UNIFORM_GRID;
+    if (broadphase == "sap")
+        broad_phase_type = BroadPhaseType::SWEEP_AND_PRUNE;
+    else if (broadphase == "bvh")
+        broad_phase_type = BroadPhaseType::AABB_TREE;
+    else if (broadphase == "hgrid")
+        broad_phase_type = BroadPhaseType::HIERARCHICAL_GRID;
+    else if (broadphase == "hash")
+        broad_phase_type = BroadPhaseType::HASHED_GRID;
+    else if (broadphase != "grid")
+    {
+        std::cerr << "Unknown --broadphase: " << broadphase << " (expected grid|sap|bvh|hgrid|hash)\n";
+        return 1;
+    }
+
+    ContactSolverType contact_solver_type = ContactSolverType::SINGLE_PASS;
+    if (solver == "sequential")
+        contact_solver_type = ContactSolverType::SEQUENTIAL_IMPULSE;
+    else if (solver == "colored")
+        contact_solver_type = ContactSolverType::GRAPH_COLORED;
+    else if (solver == "jacobi")
+        contact_solver_type = ContactSolverType::JACOBI;
+    else if (solver == "islands")
+        contact_solver_type = ContactSolverType::ISLANDS;
+    else if (solver == "xpbd")
+        contact_solver_type = ContactSolverType::XPBD;
+    else if (solver != "single")
+    {
+        std::cerr << "Unknown --solver: " << solver << " (expected single|sequential|colored|jacobi|islands|xpbd)\n";
+        return 1;
+    }
+
+    IntegratorType integrator_type = IntegratorType::VERLET_POSITION;
+    if (integrator == "euler")
+        integrator_type = IntegratorType::EULER_EXPLICIT;
+    else if (integrator == "semi-implicit")
+        integrator_type = IntegratorType::EULER_SEMI_IMPLICIT;
+    else if (integrator == "velocity-verlet")
+        integrator_type = IntegratorType::VELOCITY_VERLET;
+    else if (integrator != "verlet")
+    {
+        std::cerr << "Unknown --integrator: " << integrator << " (expected verlet|velocity-verlet|semi-implicit|euler)\n";
+        return 1;
+    }
+
+    SimdLevel simd_level = detect_simd_level();
+    if (simd == "scalar")
+        simd_level = SimdLevel::SCALAR;
+    else if (simd == "sse2")
+        simd_level = SimdLevel::SSE2;
+    else if (simd == "avx2")
+        simd_level = SimdLevel::AVX2;
+    else if (simd == "avx512")
+        simd_level = SimdLevel::AVX512;
+    else if (simd != "auto")
+    {
+        std::cerr << "Unknown --simd: " << simd << " (expected auto|scalar|sse2|avx2|avx512)\n";
+        return 1;
+    }
+    if (simd_level > detect_simd_level())
+    {
+        std::cerr << "--simd " << simd << " is not supported by this CPU (best: " << simd_level_name(detect_simd_level()) << ")\n";
+        return 1;
     }
 
     ensure_dir("benchmarks");
     std::string ts = now_timestamp();
-    std::string out_csv = "benchmarks/results-" + ts + "-N" + std::to_string(N) + ".csv";
+    std::string out_csv = std::string(ensemble > 0 ? "benchmarks/ensemble-" : "benchmarks/results-") + ts + "-N" + std::to_string(N) + "-" + broadphase + "-" + pairs + (neighbour_skin > 0.0f ? "-nl" : "") + (warm_start ? "" : "-cold") + (contact_solver_type == ContactSolverType::SEQUENTIAL_IMPULSE ? "-si" : "") +
+                          (contact_solver_type == ContactSolverType::GRAPH_COLORED ? "-gc" + std::to_string(threads) : "") +
+                          (contact_solver_type == ContactSolverType::JACOBI ? "-jac" + std::to_string(threads) : "") +
+                          (contact_solver_type == ContactSolverType::ISLANDS ? "-isl" + std::to_string(threads) : "") +
+                          (contact_solver_type == ContactSolverType::XPBD ? "-xpbd" : "") +
+                          (max_substeps > 0 ? "-ss" + std::to_string(max_substeps) : "") + (sleep ? "-sleep" : "") +
+                          (ccd_fraction > 0.0f ? "-ccd" : "") + (hz != 60.0f ? "-" + std::to_string((int)hz) + "hz" : "") +
+                          (simd != "auto" ? "-" + simd : "") + (integrator != "verlet" ? "-" + integrator : "") +
+                          (static_bodies > 0 ? "-s" + std::to_string(static_bodies) : "") +
+                          (ensemble > 0 ? "-E" + std::to_string(ensemble) : "") + (ensemble > 0 && lanes ? "-lanes" : "") + ".csv";
 
     // Create world with N bodies in a grid
-    std::vector<body> bodies;
-    bodies.reserve(N);
-    float spacing = 3.0f;
-    int cols = std::max(1, (int)std::sqrt(N));
-    for (int i = 0; i < N; ++i)
+    auto make_world = [&]()
     {
-        int x = i % cols;
-        int y = i / cols;
-        float px = (x - cols / 2) * spacing;
-        float py = (y + 1) * spacing + 10.0f;
-        bodies.push_back(body(vec2(px, py), vec2(0, 0), vec2(0, 0), 1.0f, 1.0f, 1.0f));
-    }
+        std::vector<body> bodies;
+        bodies.reserve(N);
+        float spacing = 3.0f;
+        int cols = std::max(1, (int)std::sqrt(N));
+        for (int i = 0; i < N; ++i)
+        {
+            int x = i % cols;
+            int y = i / cols;
+            float px = (x - cols / 2) * spacing;
+            float py = (y + 1) * spacing + 10.0f;
+            bodies.push_back(body(vec2(px, py), vec2(0, 0), vec2(0, 0), 1.0f, 1.0f, 1.0f));
+        }
 
-    world sim_world;
-    sim_world.gravity_x = 0.0f;
-    sim_world.gravity_y = -9.8f;
-    sim_world.delta_time = 1.0f / 60.0f;
-    for (auto &b : bodies)
-        sim_world.add_body(b);
+        world sim_world;
+        sim_world.gravity_x = 0.0f;
+        sim_world.gravity_y = -9.8f;
+        sim_world.delta_time = 1.0f / hz;
+        for (auto &b : bodies)
+            sim_world.add_body(b);
+
+        // Level geometry: a lattice of static pegs over the whole grid
+        if (static_bodies > 0)
+        {
+            const GridInfo &grid = sim_world.grid_info;
+            int peg_cols = std::max(1, (int)std::ceil(std::sqrt((float)static_bodies)));
+            float peg_spacing_x = (grid.max_x - grid.min_x) / peg_cols;
+            float peg_spacing_y = (grid.max_y - grid.min_y) / peg_cols;
+            for (int i = 0; i < static_bodies; ++i)
+            {
+                float px = grid.min_x + (i % peg_cols + 0.5f) * peg_spacing_x;
+                float py = grid.min_y + (i / peg_cols + 0.5f) * peg_spacing_y;
+                sim_world.add_body(body(vec2(px, py), vec2(0, 0), vec2(0, 0), 0.0f, 0.0f, 0.5f));
+            }
+        }
+        if (velocity_iterations >= 0)
+            sim_world.solver_settings.velocity_iterations = velocity_iterations;
+        if (position_iterations >= 0)
+            sim_world.solver_settings.position_iterations = position_iterations;
+        if (xpbd_iterations >= 0)
+            sim_world.solver_settings.xpbd_iterations = xpbd_iterations;
+        if (compliance >= 0.0f)
+            sim_world.solver_settings.contact_compliance = compliance;
+        sim_world.sleep_settings.enabled = sleep;
+        return sim_world;
+    };
 
     // Prepare systems
-    systemManager manager;
-    manager.addSystem(std::make_unique<movementSystem>());
-    manager.addSystem(std::make_unique<collisionSystem>());
+    auto add_systems = [&](systemManager &manager)
+    {
+        if (max_substeps > 0)
+        {
+            SubstepSettings substeps;
+            substeps.enabled = true;
+            substeps.max_substeps = max_substeps;
+            substeps.frame_budget_us = substep_budget_us;
+            manager.set_substepping(substeps);
+        }
+        if (reorder_interval > 0)
+            manager.addSystem(std::make_unique<reorderSystem>(reorder_interval));
+        auto movement = std::make_unique<movementSystem>(integrator_type);
+        movement->set_simd_level(simd_level);
+        manager.addSystem(std::move(movement));
+        auto collision = std::make_unique<collisionSystem>();
+        collision->set_pair_generation_mode(pair_mode);
+        collision->set_broad_phase(broad_phase_type);
+        if (neighbour_skin > 0.0f)
+            collision->set_neighbour_list(true, neighbour_skin);
+        collision->set_warm_starting(warm_start);
+        collision->set_contact_solver(contact_solver_type);
+        if (ccd_fraction > 0.0f)
+            collision->set_continuous_collision(true, ccd_fraction);
+        manager.addSystem(std::move(collision));
+    };
+
+    if (ensemble > 0 && lanes)
+    {
+        // Same sweep as below, WORLD_LANES members per laneEnsemble and one
+        // laneEnsemble per pool task. Members of a batch share its timings.
+        int sweep_steps = std::max(1, (int)std::ceil(std::sqrt((float)ensemble)));
+        int batch_count = (ensemble + WORLD_LANES - 1) / WORLD_LANES;
+        std::vector<laneEnsemble> batches(batch_count, laneEnsemble(simd_level));
+        std::vector<float> member_restitution(ensemble);
+        std::vector<float> member_damping(ensemble);
+        for (int k = 0; k < ensemble; ++k)
+        {
+            member_restitution[k] = (float)(k % sweep_steps + 1) / (float)sweep_steps;
+            member_damping[k] = 0.01f * (float)(k / sweep_steps);
+            world member_world = make_world();
+            std::fill(member_world.restitution.begin(), member_world.restitution.end(), member_restitution[k]);
+            member_world.global_damping = member_damping[k];
+            batches[k / WORLD_LANES].add_world(member_world);
+        }
+
+        threadPool pool(threads);
+        std::vector<double> batch_us(batch_count, 0.0);
+        std::vector<double> batch_max_frame_us(batch_count, 0.0);
+        pool.parallel_for(batch_count, [&](int begin, int end)
+                          {
+            for (int b = begin; b < end; ++b)
+                batches[b].step(warmup); }, 1);
+        auto t0 = std::chrono::high_resolution_clock::now();
+        pool.parallel_for(batch_count, [&](int begin, int end)
+                          {
+            for (int b = begin; b < end; ++b)
+            {
+                for (int f = 0; f < frames; ++f)
+                {
+                    auto f0 = std::chrono::high_resolution_clock::now();
+                    batches[b].step();
+                    auto f1 = std::chrono::high_resolution_clock::now();
+                    double us = (double)std::chrono::duration_cast<std::chrono::microseconds>(f1 - f0).count();
+                    batch_us[b] += us;
+                    batch_max_frame_us[b] = std::max(batch_max_frame_us[b], us);
+                }
+            } }, 1);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        auto wall_us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+
+        // Contacts, substeps and sleeping are not tracked by the lane kernel
+        std::ofstream out(out_csv);
+        out << "member,restitution,global_damping,frames,total_us,max_frame_us,contacts,substeps,sleeping,kinetic_energy,total_energy\n";
+        for (int k = 0; k < ensemble; ++k)
+        {
+            const laneEnsemble &batch = batches[k / WORLD_LANES];
+            int lane = k % WORLD_LANES;
+            out << k << "," << member_restitution[k] << "," << member_damping[k] << "," << frames << "," << (long long)batch_us[k / WORLD_LANES] << ","
+                << (long long)batch_max_frame_us[k / WORLD_LANES] << ",0,0,0," << batch.kinetic_energy(lane) << "," << batch.total_energy(lane) << "\n";
+        }
+        out.close();
+        std::cout << "Stepped " << ensemble << " worlds x " << frames << " frames in " << batch_count << " lane batches (" << simd_level_name(batches[0].get_simd_level())
+                  << ") on " << pool.thread_count() << " threads in " << wall_us << " us\n";
+        std::cout << "Wrote " << out_csv << "\n";
+        return 0;
+    }
+
+    if (ensemble > 0)
+    {
+        // Parameter sweep: member k gets restitution and global damping from a
+        // grid of sweep_steps x sweep_steps values, one world per pool task
+        worldEnsemble members(threads);
+        int sweep_steps = std::max(1, (int)std::ceil(std::sqrt((float)ensemble)));
+        std::vector<float> member_restitution(ensemble);
+        std::vector<float> member_damping(ensemble);
+        for (int k = 0; k < ensemble; ++k)
+        {
+            member_restitution[k] = (float)(k % sweep_steps + 1) / (float)sweep_steps;
+            member_damping[k] = 0.01f * (float)(k / sweep_steps);
+            world member_world = make_world();
+            std::fill(member_world.restitution.begin(), member_world.restitution.end(), member_restitution[k]);
+            member_world.global_damping = member_damping[k];
+            members.add_world(std::move(member_world), add_systems);
+        }
+
+        members.step(warmup);
+        members.reset_metrics();
+        auto t0 = std::chrono::high_resolution_clock::now();
+        members.step(frames);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        auto wall_us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+
+        // One row per member
+        std::ofstream out(out_csv);
+        out << "member,restitution,global_damping,frames,total_us,max_frame_us,contacts,substeps,sleeping,kinetic_energy,total_energy\n";
+        for (int k = 0; k < ensemble; ++k)
+        {
+            const EnsembleMetrics &m = members.get_metrics(k);
+            out << k << "," << member_restitution[k] << "," << member_damping[k] << "," << m.frames << "," << (long long)m.step_us << ","
+                << (long long)m.max_frame_us << "," << m.contacts << "," << m.substeps << "," << m.sleeping_bodies << ","
+                << m.kinetic_energy << "," << m.total_energy << "\n";
+        }
+        out.close();
+        std::cout << "Stepped " << ensemble << " worlds x " << frames << " frames on " << members.thread_count() << " threads in " << wall_us << " us\n";
+        std::cout << "Wrote " << out_csv << "\n";
+        return 0;
+    }
+
+    world sim_world = make_world();
+    systemManager manager(threads);
+    add_systems(manager);
 
     // Warmup
     for (int i = 0; i < warmup; ++i)
     {
         manager.update(sim_world, sim_world.delta_time);
     }
+    // Counters accumulated during warmup must not land in frame 0
+    sim_world.neighbour_list_rebuilds = 0;
+    sim_world.solver_contacts = 0;
+    sim_world.contact_colors = 0;
+    sim_world.largest_color_batch = 0;
+    sim_world.island_count = 0;
+    sim_world.island_solve_us = 0;
+    sim_world.largest_island_us = 0;
+    sim_world.substeps = 0;
+    sim_world.ccd_bodies = 0;
+    sim_world.ccd_impacts = 0;
+    sim_world.ccd_us = 0;
 
     // Measurement
     std::ofstream out(out_csv);
-    out << "frame,total_us,broad_us,narrow_us,resolve_us\n";
+    out << "frame,total_us,broad_us,narrow_us,resolve_us,rebuilds,contacts,colors,max_batch,islands,island_us,max_island_us,substeps,sleeping,ccd_bodies,ccd_impacts,ccd_us\n";
 
     for (int f = 0; f < frames; ++f)
     {
@@ -99,12 +424,27 @@ int main(int argc, char **argv)
         unsigned long long broad = sim_world.broad_phase_us;
         unsigned long long narrow = sim_world.narrow_phase_us;
         unsigned long long resolve = sim_world.resolve_phase_us;
-        out << f << "," << total_us << "," << broad << "," << narrow << "," << resolve << "\n";
+        unsigned long long rebuilds = sim_world.neighbour_list_rebuilds;
+        out << f << "," << total_us << "," << broad << "," << narrow << "," << resolve << "," << rebuilds << ","
+            << sim_world.solver_contacts << "," << sim_world.contact_colors << "," << sim_world.largest_color_batch << ","
+            << sim_world.island_count << "," << sim_world.island_solve_us << "," << sim_world.largest_island_us << "," << sim_world.substeps << ","
+            << sim_world.sleeping_bodies << "," << sim_world.ccd_bodies << "," << sim_world.ccd_impacts << "," << sim_world.ccd_us << "\n";
 
         // reset per-frame accumulators
         sim_world.broad_phase_us = 0;
         sim_world.narrow_phase_us = 0;
         sim_world.resolve_phase_us = 0;
+        sim_world.neighbour_list_rebuilds = 0;
+        sim_world.solver_contacts = 0;
+        sim_world.contact_colors = 0;
+        sim_world.largest_color_batch = 0;
+        sim_world.island_count = 0;
+        sim_world.island_solve_us = 0;
+        sim_world.largest_island_us = 0;
+        sim_world.substeps = 0;
+        sim_world.ccd_bodies = 0;
+        sim_world.ccd_impacts = 0;
+        sim_world.ccd_us = 0;
     }
 
     out.close();